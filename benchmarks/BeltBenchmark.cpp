@@ -0,0 +1,400 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <Polymorphic/Drum.h>
+#include <Polymorphic/OwningDrum.h>
+#include <Polymorphic/Queue.h>
+
+namespace
+{
+	struct Round
+	{
+		int caliber = 9;
+	};
+
+	using Drum = ::Vessel::Drum<Round>;
+	using Queue = ::Vessel::Queue<Round>;
+	using Exchanger = ::Vessel::Exchanger<Round>;
+
+	const Round kRound{};
+
+	template<typename Belt>
+	Belt MakeBelt(size_t capacity)
+	{
+		if constexpr (Belt::kIsDynamic)
+		{
+			return Belt{ capacity };
+		}
+		else
+		{
+			return Belt{};
+		}
+	}
+
+	// Drum with a single round loaded right behind the feeder.
+	void LoadSparseDrum(Drum& drum)
+	{
+		drum.NextBeltSlot(drum.GetSlotCount() - 1u);
+		drum.ExchangeFeederSlot(kRound);
+		drum.NextBeltSlot();
+	}
+
+	// Turn the drum slot by slot until the round shows up.
+	void PullSparseWalk(benchmark::State& state)
+	{
+		Drum drum{ static_cast<size_t>(state.range(0)) };
+
+		for (auto _ : state)
+		{
+			LoadSparseDrum(drum);
+
+			while (drum.IsEmptySlot())
+			{
+				drum.NextBeltSlot();
+			}
+			benchmark::DoNotOptimize(drum.ExchangeFeederSlot());
+		}
+	}
+
+	// Jump straight to the round through the occupancy bitmap.
+	void PullSparseJump(benchmark::State& state)
+	{
+		Drum drum{ static_cast<size_t>(state.range(0)) };
+
+		for (auto _ : state)
+		{
+			LoadSparseDrum(drum);
+
+			benchmark::DoNotOptimize(Exchanger::PullItem(drum));
+		}
+	}
+
+	// Move rounds back and forth between half loaded belts, cost per item shouldn't depend on capacity.
+	template<typename DrumType = Drum, typename QueueType = Queue>
+	void ExchangeHalfLoaded(benchmark::State& state)
+	{
+		const size_t capacity = static_cast<size_t>(state.range(0));
+		DrumType drum = MakeBelt<DrumType>(capacity);
+		QueueType magazine = MakeBelt<QueueType>(capacity);
+
+		for (size_t index = 0u; index < capacity / 2u; ++index)
+		{
+			Exchanger::PushItem(drum, kRound);
+			Exchanger::PushItem(magazine, kRound);
+		}
+
+		for (auto _ : state)
+		{
+			drum << magazine;
+			magazine << drum;
+		}
+
+		state.SetItemsProcessed(state.iterations() * 2);
+	}
+
+	// Unload the full drum into the magazine and load it back, one exchange per round.
+	void UnloadDrumSingle(benchmark::State& state)
+	{
+		const size_t capacity = static_cast<size_t>(state.range(0));
+		Drum drum{ capacity };
+		Queue magazine{ capacity };
+		drum.SetSlotItems(std::vector<Drum::OptionalRefWrapper>(capacity, kRound));
+
+		for (auto _ : state)
+		{
+			for (size_t index = 0u; index < capacity; ++index)
+			{
+				magazine << drum;
+			}
+			for (size_t index = 0u; index < capacity; ++index)
+			{
+				drum << magazine;
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+	}
+
+	// Unload the full drum into the magazine and load it back, one bulk exchange per direction.
+	void UnloadDrumBulk(benchmark::State& state)
+	{
+		const size_t capacity = static_cast<size_t>(state.range(0));
+		Drum drum{ capacity };
+		Queue magazine{ capacity };
+		drum.SetSlotItems(std::vector<Drum::OptionalRefWrapper>(capacity, kRound));
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(Exchanger::ExchangeN(magazine, drum, capacity));
+			benchmark::DoNotOptimize(Exchanger::ExchangeN(drum, magazine, capacity));
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+	}
+
+	// Drum turned halfway with every third slot loaded, like a belt shown by the UI.
+	Drum MakeDisplayedDrum(size_t capacity)
+	{
+		std::vector<Drum::OptionalRefWrapper> slotItems(capacity);
+		for (size_t index = 0u; index < capacity; index += 3u)
+		{
+			slotItems[index] = kRound;
+		}
+
+		Drum drum{ capacity };
+		drum.SetSlotItems(slotItems);
+		drum.NextBeltSlot(capacity / 2u);
+		return drum;
+	}
+
+	// Count loaded slots through a fresh copy of slot items.
+	void ReadSlotItems(benchmark::State& state)
+	{
+		const Drum drum = MakeDisplayedDrum(static_cast<size_t>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			const std::vector<Drum::OptionalRefWrapper> items = drum.GetSlotItems();
+			benchmark::DoNotOptimize(std::count_if(items.cbegin(), items.cend(), [](const Drum::OptionalRefWrapper& item) { return item.has_value(); }));
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Count loaded slots in place, run by run.
+	void VisitSlots(benchmark::State& state)
+	{
+		const Drum drum = MakeDisplayedDrum(static_cast<size_t>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			size_t count = 0u;
+			drum.VisitSlots([&count](std::span<const Drum::SlotPointer> slots) {
+				count += std::count_if(slots.begin(), slots.end(), [](Drum::SlotPointer slot) { return slot != nullptr; });
+				});
+			benchmark::DoNotOptimize(count);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Polymorphic rounds, whose type is known only through a virtual call.
+	class Shell
+	{
+	public:
+		virtual ~Shell() = default;
+		virtual bool IsIncendiary() const = 0;
+	};
+
+	class IncendiaryShell final : public Shell
+	{
+	public:
+		bool IsIncendiary() const override { return true; }
+	};
+
+	class ExpansiveShell final : public Shell
+	{
+	public:
+		bool IsIncendiary() const override { return false; }
+	};
+
+	struct ShellTagger
+	{
+		static constexpr size_t kTypeCount = 2u;
+
+		::Vessel::TypeTag operator()(const Shell& shell) const { return shell.IsIncendiary() ? 0u : 1u; }
+	};
+
+	const IncendiaryShell kIncendiaryShell{};
+	const ExpansiveShell kExpansiveShell{};
+
+	// Drum full of expansive shells with a few incendiary ones at the end.
+	template<typename DrumType>
+	DrumType MakeShellDrum(size_t capacity)
+	{
+		std::vector<typename DrumType::OptionalRefWrapper> slotItems(capacity, kExpansiveShell);
+		for (size_t index = capacity - capacity / 64u; index < capacity; ++index)
+		{
+			slotItems[index] = kIncendiaryShell;
+		}
+
+		DrumType drum{ capacity };
+		drum.SetSlotItems(slotItems);
+		return drum;
+	}
+
+	// Count incendiary shells and find the nearest one, asking every shell its type.
+	void FindTypeWalk(benchmark::State& state)
+	{
+		using ShellDrum = ::Vessel::Drum<Shell>;
+		const ShellDrum drum = MakeShellDrum<ShellDrum>(static_cast<size_t>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			size_t count = 0u;
+			std::optional<size_t> foundOffset;
+			size_t offset = 0u;
+			drum.VisitSlots([&](std::span<const ShellDrum::SlotPointer> slots) {
+				for (ShellDrum::SlotPointer slot : slots)
+				{
+					if (slot != nullptr && slot->IsIncendiary())
+					{
+						++count;
+						foundOffset = foundOffset.has_value() ? foundOffset : offset;
+					}
+					++offset;
+				}
+				});
+			benchmark::DoNotOptimize(count);
+			benchmark::DoNotOptimize(foundOffset);
+		}
+	}
+
+	// Count incendiary shells and find the nearest one through type tags.
+	void FindTypeTagged(benchmark::State& state)
+	{
+		using ShellDrum = ::Vessel::TypedDrum<Shell, ShellTagger>;
+		const ShellDrum drum = MakeShellDrum<ShellDrum>(static_cast<size_t>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(drum.GetTypeCount(0u));
+			benchmark::DoNotOptimize(drum.FindTypeSlot(0u));
+		}
+	}
+
+	// Count incendiary shells which live in separate heap objects, allocated one by one and shuffled.
+	void ScanReferencedShells(benchmark::State& state)
+	{
+		using ShellDrum = ::Vessel::Drum<Shell>;
+		const size_t capacity = static_cast<size_t>(state.range(0));
+
+		std::vector<std::unique_ptr<Shell>> shells;
+		for (size_t index = 0u; index < capacity; ++index)
+		{
+			shells.push_back(index % 4u == 0u ? std::unique_ptr<Shell>{ std::make_unique<IncendiaryShell>() } : std::make_unique<ExpansiveShell>());
+		}
+		std::shuffle(shells.begin(), shells.end(), std::mt19937{ 7u });
+
+		std::vector<ShellDrum::OptionalRefWrapper> slotItems;
+		for (const std::unique_ptr<Shell>& shell : shells)
+		{
+			slotItems.emplace_back(*shell);
+		}
+
+		ShellDrum drum{ capacity };
+		drum.SetSlotItems(slotItems);
+
+		for (auto _ : state)
+		{
+			size_t count = 0u;
+			drum.VisitSlots([&count](std::span<const ShellDrum::SlotPointer> slots) {
+				for (ShellDrum::SlotPointer slot : slots)
+				{
+					count += slot != nullptr && slot->IsIncendiary();
+				}
+				});
+			benchmark::DoNotOptimize(count);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Count incendiary shells stored right in the slots.
+	void ScanOwnedShells(benchmark::State& state)
+	{
+		using ShellDrum = ::Vessel::OwningDrum<Shell>;
+		const size_t capacity = static_cast<size_t>(state.range(0));
+
+		ShellDrum drum{ capacity };
+		for (size_t index = 0u; index < capacity; ++index)
+		{
+			index % 4u == 0u ? drum.PushItem(IncendiaryShell{}) : drum.PushItem(ExpansiveShell{});
+		}
+
+		for (auto _ : state)
+		{
+			size_t count = 0u;
+			drum.VisitItems([&count](const Shell& shell) { count += shell.IsIncendiary(); });
+			benchmark::DoNotOptimize(count);
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Scan slots stored the way belts stored them before, as optional references.
+	void ScanOptionalSlots(benchmark::State& state)
+	{
+		using Slot = Drum::OptionalRefWrapper;
+		std::vector<Slot> slots(static_cast<size_t>(state.range(0)));
+		for (size_t index = 0u; index < slots.size(); index += 3u)
+		{
+			slots[index] = kRound;
+		}
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(std::count_if(slots.cbegin(), slots.cend(), [](const Slot& slot) { return slot.has_value(); }));
+		}
+
+		state.counters["SlotBytes"] = sizeof(Slot);
+		state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Slot));
+	}
+
+	// Scan compact slots, null pointer marks a free slot.
+	void ScanCompactSlots(benchmark::State& state)
+	{
+		using Slot = Drum::SlotPointer;
+		std::vector<Slot> slots(static_cast<size_t>(state.range(0)), nullptr);
+		for (size_t index = 0u; index < slots.size(); index += 3u)
+		{
+			slots[index] = &kRound;
+		}
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(std::count_if(slots.cbegin(), slots.cend(), [](Slot slot) { return slot != nullptr; }));
+		}
+
+		state.counters["SlotBytes"] = sizeof(Slot);
+		state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(Slot));
+	}
+
+	// Turn the drum and peek slots, which is index wrapping mostly.
+	template<typename DrumType>
+	void TurnDrum(benchmark::State& state)
+	{
+		DrumType drum = MakeBelt<DrumType>(static_cast<size_t>(state.range(0)));
+		drum.ExchangeFeederSlot(kRound);
+
+		for (auto _ : state)
+		{
+			drum.NextBeltSlot(7u);
+			benchmark::DoNotOptimize(drum.IsEmptySlot(3u));
+		}
+	}
+} // namespace
+
+BENCHMARK(PullSparseWalk)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(PullSparseJump)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(ExchangeHalfLoaded)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(ExchangeHalfLoaded<::Vessel::Drum<Round, 64>, ::Vessel::Queue<Round, 64>>)->Arg(64);
+BENCHMARK(UnloadDrumSingle)->Arg(64)->Arg(1024);
+BENCHMARK(UnloadDrumBulk)->Arg(64)->Arg(1024);
+BENCHMARK(ReadSlotItems)->Arg(64)->Arg(1024);
+BENCHMARK(VisitSlots)->Arg(64)->Arg(1024);
+BENCHMARK(FindTypeWalk)->Arg(1024)->Arg(16384);
+BENCHMARK(FindTypeTagged)->Arg(1024)->Arg(16384);
+BENCHMARK(ScanReferencedShells)->Arg(1024)->Arg(1 << 18);
+BENCHMARK(ScanOwnedShells)->Arg(1024)->Arg(1 << 18);
+BENCHMARK(TurnDrum<Drum>)->Arg(48)->Arg(64);
+BENCHMARK(TurnDrum<::Vessel::Drum<Round, 48>>)->Arg(48);
+BENCHMARK(TurnDrum<::Vessel::Drum<Round, 64>>)->Arg(64);
+BENCHMARK(ScanOptionalSlots)->Arg(1 << 20);
+BENCHMARK(ScanCompactSlots)->Arg(1 << 20);
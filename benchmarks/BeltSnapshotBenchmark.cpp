@@ -0,0 +1,118 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <Polymorphic/BeltSnapshot.h>
+#include <Polymorphic/Drum.h>
+
+namespace
+{
+	struct Crate
+	{
+		int weight = 1;
+	};
+
+	using Drum = ::Vessel::Drum<Crate>;
+	using BeltSnapshot = ::Vessel::BeltSnapshot<Crate>;
+
+	constexpr size_t kBeltCapacity = 32u;
+	constexpr size_t kItemCount = 1024u;
+
+	// Saved world of drums, every drum is loaded by a third and turned.
+	struct SavedWorld
+	{
+		explicit SavedWorld(size_t beltCount)
+			: crates(kItemCount)
+		{
+			for (const Crate& crate : crates)
+			{
+				itemTable.push_back(&crate);
+			}
+
+			BeltSnapshot snapshot;
+			for (size_t beltIndex = 0u; beltIndex < beltCount; ++beltIndex)
+			{
+				std::vector<Drum::OptionalRefWrapper> slotItems(kBeltCapacity);
+				for (size_t index = beltIndex % 3u; index < kBeltCapacity; index += 3u)
+				{
+					slotItems[index] = crates[(beltIndex + index) % kItemCount];
+				}
+
+				Drum drum{ kBeltCapacity };
+				drum.SetSlotItems(slotItems);
+				drum.NextBeltSlot(beltIndex);
+
+				// Item indices as the save code mapped them by hand before.
+				std::vector<size_t>& indices = slotIndices.emplace_back();
+				for (const Drum::OptionalRefWrapper& item : drum.GetSlotItems())
+				{
+					indices.push_back(item.has_value() ? static_cast<size_t>(&item.value().get() - crates.data()) : kItemCount);
+				}
+
+				snapshot.Save(drum, [this](const Crate& crate) { return static_cast<size_t>(&crate - crates.data()); });
+				snapshot.Write(bytes);
+			}
+
+			for (size_t beltIndex = 0u; beltIndex < beltCount; ++beltIndex)
+			{
+				belts.push_back(std::make_unique<Drum>(kBeltCapacity));
+			}
+		}
+
+		std::vector<Crate> crates;
+		std::vector<Drum::SlotPointer> itemTable;
+		std::vector<std::vector<size_t>> slotIndices;
+		std::vector<std::byte> bytes;
+		std::vector<std::unique_ptr<Drum>> belts;
+	};
+
+	// Rebuild slot items of every belt and load them one by one.
+	void LoadSlotItems(benchmark::State& state)
+	{
+		SavedWorld world{ static_cast<size_t>(state.range(0)) };
+
+		for (auto _ : state)
+		{
+			for (size_t beltIndex = 0u; beltIndex < world.belts.size(); ++beltIndex)
+			{
+				std::vector<Drum::OptionalRefWrapper> slotItems;
+				slotItems.reserve(kBeltCapacity);
+				for (size_t index : world.slotIndices[beltIndex])
+				{
+					slotItems.push_back(index < kItemCount ? Drum::OptionalRefWrapper{ world.crates[index] } : Drum::OptionalRefWrapper{});
+				}
+
+				world.belts[beltIndex]->SetSlotItems(std::move(slotItems));
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Read compact snapshots and restore slot buffers directly.
+	void LoadSnapshots(benchmark::State& state)
+	{
+		SavedWorld world{ static_cast<size_t>(state.range(0)) };
+		BeltSnapshot snapshot;
+
+		for (auto _ : state)
+		{
+			std::span<const std::byte> rest = world.bytes;
+			for (const std::unique_ptr<Drum>& belt : world.belts)
+			{
+				rest = rest.subspan(snapshot.Read(rest));
+				snapshot.Restore(*belt, world.itemTable);
+			}
+		}
+
+		state.counters["BytesPerBelt"] = static_cast<double>(world.bytes.size()) / static_cast<double>(state.range(0));
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+} // namespace
+
+BENCHMARK(LoadSlotItems)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(LoadSnapshots)->Arg(100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,131 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <thread>
+
+#include <Polymorphic/ConcurrentQueue.h>
+#include <Polymorphic/Queue.h>
+#include <Polymorphic/SharedQueue.h>
+
+namespace
+{
+	struct Round
+	{
+		int caliber = 9;
+	};
+
+	using ConcurrentQueue = ::Vessel::ConcurrentQueue<Round>;
+	using Queue = ::Vessel::Queue<Round>;
+	using SharedQueue = ::Vessel::SharedQueue<Round>;
+
+	constexpr size_t kBeltCapacity = 1024u;
+	constexpr int64_t kRoundCount = 1 << 18;
+
+	const Round kRound{};
+
+	// Queue guarded by a mutex per operation, as belts were shared between threads before.
+	class LockedQueue final
+	{
+	public:
+		bool Push()
+		{
+			std::lock_guard lock{ mMutex };
+			return !mQueue.ExchangeReceiverSlot(kRound).has_value();
+		}
+
+		bool Pull()
+		{
+			std::lock_guard lock{ mMutex };
+			return mQueue.GetItemCount() > 0u && mQueue.ExchangeFeederSlot().has_value();
+		}
+
+	private:
+		std::mutex mMutex;
+		Queue mQueue{ kBeltCapacity };
+	};
+
+	// Production thread fills the belt while the combat thread drains it.
+	template<typename PushCallable, typename PullCallable>
+	void RunProducerConsumer(PushCallable&& push, PullCallable&& pull)
+	{
+		std::thread producer([&]() {
+			for (int64_t index = 0; index < kRoundCount; ++index)
+			{
+				while (!push())
+				{
+					std::this_thread::yield();
+				}
+			}
+			});
+
+		for (int64_t index = 0; index < kRoundCount; )
+		{
+			if (pull())
+			{
+				++index;
+				continue;
+			}
+
+			std::this_thread::yield();
+		}
+
+		producer.join();
+	}
+
+	void ThroughputLocked(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			LockedQueue belt;
+			RunProducerConsumer([&]() { return belt.Push(); }, [&]() { return belt.Pull(); });
+		}
+
+		state.SetItemsProcessed(state.iterations() * kRoundCount);
+	}
+
+	void ThroughputLockFree(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			ConcurrentQueue belt{ kBeltCapacity };
+			RunProducerConsumer([&]() { return !belt.ExchangeReceiverSlot(kRound).has_value(); }, [&]() { return belt.ExchangeFeederSlot().has_value(); });
+		}
+
+		state.SetItemsProcessed(state.iterations() * kRoundCount);
+	}
+
+	// Depot shared by many threads, even threads produce and odd threads consume the same count of items.
+	template<typename PushCallable, typename PullCallable>
+	void RunDepot(benchmark::State& state, PushCallable&& push, PullCallable&& pull)
+	{
+		const bool isProducer = state.thread_index() % 2 == 0;
+
+		for (auto _ : state)
+		{
+			while (!(isProducer ? push() : pull()))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void DepotLocked(benchmark::State& state)
+	{
+		static LockedQueue belt;
+		RunDepot(state, []() { return belt.Push(); }, []() { return belt.Pull(); });
+	}
+
+	void DepotLockFree(benchmark::State& state)
+	{
+		static SharedQueue belt{ kBeltCapacity };
+		RunDepot(state, []() { return !belt.ExchangeReceiverSlot(kRound).has_value(); }, []() { return belt.ExchangeFeederSlot().has_value(); });
+	}
+} // namespace
+
+BENCHMARK(ThroughputLocked)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(ThroughputLockFree)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(DepotLocked)->ThreadRange(2, 32)->UseRealTime();
+BENCHMARK(DepotLockFree)->ThreadRange(2, 32)->UseRealTime();
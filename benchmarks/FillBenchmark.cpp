@@ -0,0 +1,84 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <Stackable/Package.h>
+#include <Stackable/Container.h>
+
+namespace
+{
+	struct FillBenchTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Steel,
+			Wood,
+			Stone,
+			Coal,
+			Count,
+		};
+	};
+
+	using FillModel = ::Vessel::ResourceModel<FillBenchTag>;
+	using ResourceId = FillModel::ResourceId;
+	using Package = ::Vessel::Package<FillModel>;
+	using Container = ::Vessel::Container<FillModel>;
+	using Transfer = ::Vessel::Transfer<FillModel>;
+	using ContainerBatch = ::Vessel::ContainerBatch<FillModel>;
+
+	static const Package::ResourceTable kCapacities
+	{
+		{ ResourceId::Steel, 1e9f },
+		{ ResourceId::Wood, 1e9f },
+		{ ResourceId::Stone, 1e9f },
+		{ ResourceId::Coal, 1e9f },
+	};
+
+	ResourceId GetLootId(int64_t index)
+	{
+		return static_cast<ResourceId>(index % FillModel::kResourceCount);
+	}
+
+	// Loot drop filled container by container.
+	void FillSequential(benchmark::State& state)
+	{
+		Package package{ kCapacities };
+
+		for (auto _ : state)
+		{
+			for (int64_t index = 0; index < state.range(0); ++index)
+			{
+				Transfer::Fill(package, Container{ GetLootId(index), 1.f });
+			}
+
+			package.ResetState();
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Loot drop filled as one batch.
+	void FillBatch(benchmark::State& state)
+	{
+		Package package{ kCapacities };
+
+		ContainerBatch batch;
+		batch.Reserve(static_cast<size_t>(state.range(0)));
+		for (int64_t index = 0; index < state.range(0); ++index)
+		{
+			batch.Add(GetLootId(index), 1.f);
+		}
+
+		for (auto _ : state)
+		{
+			Transfer::Fill(package, batch);
+			package.ResetState();
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+} // namespace
+
+BENCHMARK(FillSequential)->Arg(8)->Arg(256);
+BENCHMARK(FillBatch)->Arg(8)->Arg(256);
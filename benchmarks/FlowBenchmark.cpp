@@ -0,0 +1,232 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <Stackable/Container.h>
+#include <Stackable/Filter.h>
+#include <Stackable/Limiter.h>
+#include <Stackable/Pipeline.h>
+#include <Stackable/Flow.h>
+#include <Stackable/AnyEndpoint.h>
+
+namespace
+{
+	struct FlowBenchTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Water,
+			Count,
+		};
+	};
+
+	using FlowModel = ::Vessel::ResourceModel<FlowBenchTag>;
+	using ResourceId = FlowModel::ResourceId;
+	using Units = FlowModel::Units;
+	using Container = ::Vessel::Container<FlowModel>;
+	using Filter = ::Vessel::Filter<FlowModel>;
+	using Limiter = ::Vessel::Limiter<FlowModel>;
+	using Flow = ::Vessel::Vessel<FlowModel>;
+
+	constexpr Units kCapacityLiters = 100.f;
+	constexpr Units kBufferLiters = 10.f;
+	constexpr size_t kEdgeCount = 1024u;
+
+	// Classic virtual endpoint, the way flows were dispatched before static polymorphism.
+	class VirtualEndpoint
+	{
+	public:
+		virtual ~VirtualEndpoint() = default;
+
+	public:
+		virtual ResourceId GetResourceId() const = 0;
+		virtual Units GetAvailableUnits() const = 0;
+		virtual Units GetRequestUnits() const = 0;
+		virtual void IncreaseUnits(Units units) = 0;
+		virtual void DecreaseUnits(Units units) = 0;
+	};
+
+	class VirtualFilter final : public VirtualEndpoint
+	{
+	public:
+		VirtualFilter(Container& container) : mFilter{ container, kBufferLiters } {}
+
+	public:
+		ResourceId GetResourceId() const override { return mFilter.GetResourceId(); }
+		Units GetAvailableUnits() const override { return mFilter.GetAvailableUnits(); }
+		Units GetRequestUnits() const override { return mFilter.GetRequestUnits(); }
+		void IncreaseUnits(Units units) override { mFilter.IncreaseUnits(units); }
+		void DecreaseUnits(Units units) override { mFilter.DecreaseUnits(units); }
+
+	private:
+		Filter mFilter;
+	};
+
+	void VirtualTransfer(VirtualEndpoint& provider, VirtualEndpoint& consumer)
+	{
+		if (provider.GetResourceId() != consumer.GetResourceId())
+		{
+			return;
+		}
+
+		const Units compromise = std::clamp(consumer.GetRequestUnits(), 0.f, provider.GetAvailableUnits());
+		if (compromise <= 0.f)
+		{
+			return;
+		}
+
+		consumer.IncreaseUnits(compromise);
+		provider.DecreaseUnits(compromise);
+	}
+
+	// Containers of a ring of edges, every edge moves filtered units to the next container.
+	std::vector<Container> MakeContainers()
+	{
+		std::vector<Container> containers;
+		containers.reserve(kEdgeCount);
+		for (size_t index = 0u; index < kEdgeCount; ++index)
+		{
+			containers.emplace_back(ResourceId::Water, (index % 2u == 0u) ? kCapacityLiters : 0.f, kCapacityLiters);
+		}
+
+		return containers;
+	}
+
+	void DispatchStatic(benchmark::State& state)
+	{
+		std::vector<Container> containers = MakeContainers();
+		std::vector<Filter> filters;
+		filters.reserve(kEdgeCount);
+		for (Container& container : containers)
+		{
+			filters.emplace_back(container, kBufferLiters);
+		}
+
+		for (auto _ : state)
+		{
+			for (size_t index = 0u; index < kEdgeCount; ++index)
+			{
+				Flow::Transfer(filters[index], filters[(index + 1u) % kEdgeCount]);
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kEdgeCount));
+	}
+
+	void DispatchVirtual(benchmark::State& state)
+	{
+		std::vector<Container> containers = MakeContainers();
+		std::vector<std::unique_ptr<VirtualEndpoint>> filters;
+		filters.reserve(kEdgeCount);
+		for (Container& container : containers)
+		{
+			filters.emplace_back(std::make_unique<VirtualFilter>(container));
+		}
+
+		for (auto _ : state)
+		{
+			for (size_t index = 0u; index < kEdgeCount; ++index)
+			{
+				VirtualTransfer(*filters[index], *filters[(index + 1u) % kEdgeCount]);
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kEdgeCount));
+	}
+
+	// Filter in front of provider and limiter in front of consumer, each re-querying its container.
+	void StagesSeparate(benchmark::State& state)
+	{
+		std::vector<Container> containers = MakeContainers();
+		std::vector<Filter> filters;
+		std::vector<Limiter> limiters;
+		filters.reserve(kEdgeCount);
+		limiters.reserve(kEdgeCount);
+		for (Container& container : containers)
+		{
+			filters.emplace_back(container, kBufferLiters);
+			limiters.emplace_back(container, kBufferLiters, 0.5f);
+		}
+
+		for (auto _ : state)
+		{
+			for (size_t index = 0u; index < kEdgeCount; ++index)
+			{
+				Flow::Transfer(filters[index], limiters[(index + 1u) % kEdgeCount]);
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kEdgeCount));
+	}
+
+	// Same stages fused into one pipeline per container.
+	void StagesFused(benchmark::State& state)
+	{
+		using Pipeline = ::Vessel::Pipeline<FlowModel, Container>;
+
+		constexpr auto kStages = ::Vessel::LimitStage<FlowModel>{ kBufferLiters } | ::Vessel::LimitStage<FlowModel>{ kBufferLiters, 0.5f };
+
+		std::vector<Container> containers = MakeContainers();
+		std::vector<Pipeline> pipelines;
+		pipelines.reserve(kEdgeCount);
+		for (Container& container : containers)
+		{
+			pipelines.push_back(kStages | container);
+		}
+
+		for (auto _ : state)
+		{
+			for (size_t index = 0u; index < kEdgeCount; ++index)
+			{
+				Flow::Transfer(pipelines[index], pipelines[(index + 1u) % kEdgeCount]);
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kEdgeCount));
+	}
+
+	void DispatchTypeErased(benchmark::State& state)
+	{
+		std::vector<Container> containers = MakeContainers();
+		std::vector<Filter> filters;
+		std::vector<::Vessel::AnyProvider<FlowModel>> providers;
+		std::vector<::Vessel::AnyConsumer<FlowModel>> consumers;
+		filters.reserve(kEdgeCount);
+		for (Container& container : containers)
+		{
+			filters.emplace_back(container, kBufferLiters);
+			providers.emplace_back(filters.back());
+			consumers.emplace_back(filters.back());
+		}
+
+		for (auto _ : state)
+		{
+			for (size_t index = 0u; index < kEdgeCount; ++index)
+			{
+				Flow::Transfer(providers[index], consumers[(index + 1u) % kEdgeCount]);
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kEdgeCount));
+	}
+} // namespace
+
+BENCHMARK(DispatchStatic);
+BENCHMARK(DispatchVirtual);
+BENCHMARK(DispatchTypeErased);
+BENCHMARK(StagesSeparate);
+BENCHMARK(StagesFused);
@@ -0,0 +1,102 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <Polymorphic/Junction.h>
+#include <Polymorphic/Queue.h>
+
+namespace
+{
+	struct Crate
+	{
+		int weight = 1;
+	};
+
+	using Exchanger = ::Vessel::Exchanger<Crate>;
+	using Queue = ::Vessel::Queue<Crate>;
+
+	constexpr size_t kInputCapacity = 1024u;
+	constexpr size_t kOutputCapacity = 256u;
+	constexpr size_t kOutputCount = 4u;
+	constexpr size_t kItemsPerTick = 64u;
+
+	// Input belt loaded full and empty outputs.
+	struct SplitBelts
+	{
+		SplitBelts()
+			: crates(kInputCapacity)
+		{
+			for (const Crate& crate : crates)
+			{
+				input.ExchangeReceiverSlot(crate);
+			}
+
+			for (size_t index = 0u; index < kOutputCount; ++index)
+			{
+				outputs.push_back(std::make_unique<Queue>(kOutputCapacity));
+			}
+		}
+
+		// Send split items back to the input once it runs short, the same way for every benchmark.
+		void Recycle()
+		{
+			if (input.GetItemCount() >= kItemsPerTick)
+			{
+				return;
+			}
+
+			for (const std::unique_ptr<Queue>& output : outputs)
+			{
+				Exchanger::ExchangeN(input, *output, kOutputCapacity);
+			}
+		}
+
+		std::vector<Crate> crates;
+		Queue input{ kInputCapacity };
+		std::vector<std::unique_ptr<Queue>> outputs;
+	};
+
+	// Split items one by one with an exchange per item and output.
+	void SplitByExchange(benchmark::State& state)
+	{
+		SplitBelts belts;
+
+		for (auto _ : state)
+		{
+			for (size_t index = 0u; index < kItemsPerTick; ++index)
+			{
+				belts.input >> *belts.outputs[index % kOutputCount];
+			}
+
+			belts.Recycle();
+		}
+
+		state.SetItemsProcessed(state.iterations() * kItemsPerTick);
+	}
+
+	// Split items with a round-robin splitter in one batch per tick.
+	void SplitBySplitter(benchmark::State& state)
+	{
+		SplitBelts belts;
+
+		::Vessel::Splitter<Crate> splitter{ belts.input, ::Vessel::JunctionPolicy::RoundRobin, kItemsPerTick };
+		for (const std::unique_ptr<Queue>& output : belts.outputs)
+		{
+			splitter.AddOutput(*output);
+		}
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(splitter.Tick());
+			belts.Recycle();
+		}
+
+		state.SetItemsProcessed(state.iterations() * kItemsPerTick);
+	}
+} // namespace
+
+BENCHMARK(SplitByExchange);
+BENCHMARK(SplitBySplitter);
@@ -0,0 +1,94 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <Polymorphic/PriorityBelt.h>
+#include <Polymorphic/Queue.h>
+
+namespace
+{
+	struct Supply
+	{
+		int urgency = 0;
+	};
+
+	struct LessUrgent
+	{
+		bool operator()(const Supply& left, const Supply& right) const { return left.urgency < right.urgency; }
+	};
+
+	using Exchanger = ::Vessel::Exchanger<Supply>;
+	using Queue = ::Vessel::Queue<Supply>;
+	using PriorityBelt = ::Vessel::PriorityBelt<Supply, LessUrgent>;
+
+	// Supplies of random urgency, twice as many as belt slots.
+	std::vector<Supply> MakeSupplies(size_t count)
+	{
+		std::vector<Supply> supplies(count * 2u);
+		std::mt19937 random{ 5u };
+		for (Supply& supply : supplies)
+		{
+			supply.urgency = static_cast<int>(random() % 64u);
+		}
+		return supplies;
+	}
+
+	// Sort the queue every tick, then take the most urgent supply and push the next one.
+	void ResortQueue(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		const std::vector<Supply> supplies = MakeSupplies(count);
+
+		Queue queue{ count };
+		for (size_t index = 0u; index < count; ++index)
+		{
+			queue.ExchangeReceiverSlot(supplies[index]);
+		}
+
+		size_t nextIndex = count;
+		for (auto _ : state)
+		{
+			std::vector<Queue::OptionalRefWrapper> slotItems = queue.GetSlotItems();
+			std::stable_sort(slotItems.begin(), slotItems.end(), [](const Queue::OptionalRefWrapper& left, const Queue::OptionalRefWrapper& right) {
+				return left.has_value() && (!right.has_value() || left.value().get().urgency > right.value().get().urgency);
+				});
+			queue.SetSlotItems(std::move(slotItems));
+
+			benchmark::DoNotOptimize(Exchanger::PullItem(queue));
+			Exchanger::PushItem(queue, supplies[nextIndex]);
+			nextIndex = nextIndex + 1u < supplies.size() ? nextIndex + 1u : 0u;
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Take the most urgent supply from the heap and push the next one.
+	void PriorityBeltTick(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		const std::vector<Supply> supplies = MakeSupplies(count);
+
+		PriorityBelt belt{ count };
+		for (size_t index = 0u; index < count; ++index)
+		{
+			belt.ExchangeReceiverSlot(supplies[index]);
+		}
+
+		size_t nextIndex = count;
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(Exchanger::PullItem(belt));
+			Exchanger::PushItem(belt, supplies[nextIndex]);
+			nextIndex = nextIndex + 1u < supplies.size() ? nextIndex + 1u : 0u;
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+} // namespace
+
+BENCHMARK(ResortQueue)->Arg(256)->Arg(4096);
+BENCHMARK(PriorityBeltTick)->Arg(256)->Arg(4096);
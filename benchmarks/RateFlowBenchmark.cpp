@@ -0,0 +1,109 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <Stackable/Package.h>
+#include <Stackable/RateFlow.h>
+
+namespace
+{
+	struct RateBenchTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Water,
+			Oil,
+			Count,
+		};
+	};
+
+	using RateModel = ::Vessel::ResourceModel<RateBenchTag>;
+	using ResourceId = RateModel::ResourceId;
+	using Units = RateModel::Units;
+	using Package = ::Vessel::Package<RateModel>;
+	using Transfer = ::Vessel::Transfer<RateModel>;
+	using RateFlow = ::Vessel::RateFlow<RateModel>;
+	using RateFlowBatch = ::Vessel::RateFlowBatch<RateModel>;
+
+	constexpr float kDeltaSeconds = 1.f / 60.f;
+
+	static const Package::ResourceTable kCapacities
+	{
+		{ ResourceId::Water, 1e9f },
+		{ ResourceId::Oil, 1e9f },
+	};
+
+	static const Package::ResourceTable kStartAmounts
+	{
+		{ ResourceId::Water, 1e8f },
+		{ ResourceId::Oil, 1e8f },
+	};
+
+	// Network of packages connected into a ring of pipes.
+	struct Network
+	{
+		explicit Network(size_t count)
+		{
+			packages.reserve(count);
+			for (size_t index = 0u; index < count; ++index)
+			{
+				packages.emplace_back(kCapacities).LoadState(kStartAmounts);
+			}
+
+			for (size_t index = 0u; index < count; ++index)
+			{
+				flows.push_back({ &packages[index], &packages[(index + 1u) % count], static_cast<ResourceId>(index % RateModel::kResourceCount), 60.f + static_cast<float>(index % 7u) });
+			}
+		}
+
+		std::vector<Package> packages;
+		std::vector<RateFlow> flows;
+	};
+
+	// Every pipe computes its chunk and calls exchange on its own.
+	void IntegratePerEdge(benchmark::State& state)
+	{
+		Network network{ static_cast<size_t>(state.range(0)) };
+
+		for (auto _ : state)
+		{
+			for (const RateFlow& flow : network.flows)
+			{
+				const Units available = flow.provider->GetAvailableUnits(flow.resourceId);
+				const Units requested = flow.consumer->GetRequestedUnits(flow.resourceId);
+				const Units chunk = std::min({ flow.rate * kDeltaSeconds, available, requested });
+				benchmark::DoNotOptimize(Transfer::Exchange(*flow.provider, *flow.consumer, flow.resourceId, chunk));
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// All pipes integrated by one batch.
+	void IntegrateBatch(benchmark::State& state)
+	{
+		Network network{ static_cast<size_t>(state.range(0)) };
+
+		RateFlowBatch batch;
+		batch.Reserve(network.flows.size());
+		for (const RateFlow& flow : network.flows)
+		{
+			batch.Add(flow);
+		}
+
+		for (auto _ : state)
+		{
+			batch.Integrate(kDeltaSeconds);
+			benchmark::DoNotOptimize(batch.GetMovedUnits(0u));
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+} // namespace
+
+BENCHMARK(IntegratePerEdge)->Arg(64)->Arg(4096);
+BENCHMARK(IntegrateBatch)->Arg(64)->Arg(4096);
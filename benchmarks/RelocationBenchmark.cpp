@@ -0,0 +1,101 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <Stackable/Package.h>
+#include <Stackable/Container.h>
+
+namespace
+{
+	struct StealBenchTag
+	{
+		using Units = int;
+
+		enum class ResourceId : uint8_t
+		{
+			Health,
+			Armor,
+			Count,
+		};
+	};
+
+	struct RelocateBenchTag
+	{
+		using Units = int;
+
+		enum class ResourceId : uint8_t
+		{
+			Health,
+			Armor,
+			Count,
+		};
+
+		static constexpr bool RelocatePackages = true;
+	};
+
+	using StealModel = ::Vessel::ResourceModel<StealBenchTag>;
+	using RelocateModel = ::Vessel::ResourceModel<RelocateBenchTag>;
+
+	constexpr size_t kPackageCount = 1u << 20;
+
+	template<typename Model>
+	const typename ::Vessel::Package<Model>::ResourceTable& GetCapacities()
+	{
+		static const typename ::Vessel::Package<Model>::ResourceTable kCapacities
+		{
+			{ Model::ResourceId::Health, 100 },
+			{ Model::ResourceId::Armor, 100 },
+		};
+
+		return kCapacities;
+	}
+
+	// Grow vector without reserve, so every reallocation moves all packages.
+	template<typename Model>
+	void GrowVector(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			std::vector<::Vessel::Package<Model>> packages;
+			for (size_t index = 0u; index < kPackageCount; ++index)
+			{
+				packages.emplace_back(GetCapacities<Model>());
+			}
+
+			benchmark::DoNotOptimize(packages.data());
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kPackageCount));
+	}
+
+	// Relocate whole vector storage with memcpy back and forth.
+	void BulkRelocate(benchmark::State& state)
+	{
+		using Package = ::Vessel::Package<RelocateModel>;
+
+		std::vector<Package> packages;
+		packages.reserve(kPackageCount);
+		for (size_t index = 0u; index < kPackageCount; ++index)
+		{
+			packages.emplace_back(GetCapacities<RelocateModel>());
+		}
+
+		std::unique_ptr<std::byte[]> storage = std::make_unique<std::byte[]>(sizeof(Package) * kPackageCount);
+		Package* buffer = reinterpret_cast<Package*>(storage.get());
+
+		for (auto _ : state)
+		{
+			::Vessel::Relocate(packages.data(), packages.data() + kPackageCount, buffer);
+			::Vessel::Relocate(buffer, buffer + kPackageCount, packages.data());
+			benchmark::DoNotOptimize(packages.data());
+		}
+
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * kPackageCount * sizeof(Package) * 2u));
+	}
+} // namespace
+
+BENCHMARK(GrowVector<StealModel>)->Unit(benchmark::kMillisecond);
+BENCHMARK(GrowVector<RelocateModel>)->Unit(benchmark::kMillisecond);
+BENCHMARK(BulkRelocate)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,81 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+#include <array>
+
+#include <Stackable/Package.h>
+#include <Stackable/Container.h>
+
+namespace
+{
+	struct StateBenchTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Steel,
+			Wood,
+			Stone,
+			Coal,
+			Count,
+		};
+	};
+
+	using StateModel = ::Vessel::ResourceModel<StateBenchTag>;
+	using ResourceId = StateModel::ResourceId;
+	using Package = ::Vessel::Package<StateModel>;
+
+	static const Package::ResourceTable kCapacities
+	{
+		{ ResourceId::Steel, 500.f },
+		{ ResourceId::Wood, 500.f },
+		{ ResourceId::Stone, 500.f },
+		{ ResourceId::Coal, 500.f },
+	};
+
+	void RoundTripResourceTable(benchmark::State& state)
+	{
+		Package package{ kCapacities };
+		package.LoadState(kCapacities);
+
+		for (auto _ : state)
+		{
+			Package::ResourceTable table;
+			package.SaveState(table);
+			package.LoadState(table);
+			benchmark::DoNotOptimize(package);
+		}
+	}
+
+	void RoundTripResourceArray(benchmark::State& state)
+	{
+		Package package{ kCapacities };
+		package.LoadState(kCapacities);
+
+		for (auto _ : state)
+		{
+			Package::ResourceArray array;
+			package.SaveState(array);
+			package.LoadState(array);
+			benchmark::DoNotOptimize(package);
+		}
+	}
+
+	void RoundTripOutputIterator(benchmark::State& state)
+	{
+		Package package{ kCapacities };
+		package.LoadState(kCapacities);
+
+		for (auto _ : state)
+		{
+			std::array<std::pair<ResourceId, float>, StateModel::kResourceCount> states;
+			package.SaveState(states.begin());
+			package.LoadState(states);
+			benchmark::DoNotOptimize(package);
+		}
+	}
+} // namespace
+
+BENCHMARK(RoundTripResourceTable);
+BENCHMARK(RoundTripResourceArray);
+BENCHMARK(RoundTripOutputIterator);
@@ -0,0 +1,91 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <Polymorphic/Queue.h>
+#include <Polymorphic/SupplyChain.h>
+
+namespace
+{
+	struct Parcel
+	{
+		int weight = 1;
+	};
+
+	using Queue = ::Vessel::Queue<Parcel>;
+	using SupplyChain = ::Vessel::SupplyChain<Parcel>;
+
+	constexpr size_t kBeltCapacity = 16u;
+	constexpr size_t kRingLength = 8u;
+
+	const Parcel kParcel{};
+
+	// Rings of belts with parcels circling around, so every tick has work to do.
+	struct Network
+	{
+		explicit Network(size_t beltCount)
+		{
+			for (size_t beltIndex = 0u; beltIndex < beltCount; ++beltIndex)
+			{
+				belts.push_back(std::make_unique<Queue>(kBeltCapacity));
+				chain.AddBelt(*belts.back());
+
+				if (beltIndex % 2u == 0u)
+				{
+					for (size_t index = 0u; index < kBeltCapacity / 2u; ++index)
+					{
+						belts.back()->ExchangeReceiverSlot(kParcel);
+					}
+				}
+			}
+
+			for (size_t beltIndex = 0u; beltIndex < beltCount; ++beltIndex)
+			{
+				const size_t ringStart = beltIndex - beltIndex % kRingLength;
+				const size_t nextIndex = ringStart + (beltIndex + 1u - ringStart) % kRingLength;
+				links.emplace_back(beltIndex, nextIndex);
+				chain.Link(beltIndex, nextIndex, 2u);
+			}
+		}
+
+		std::vector<std::unique_ptr<Queue>> belts;
+		std::vector<std::pair<size_t, size_t>> links;
+		SupplyChain chain;
+	};
+
+	// Every link is driven by hand with the exchange operator.
+	void TickPerLink(benchmark::State& state)
+	{
+		Network network{ static_cast<size_t>(state.range(0)) };
+
+		for (auto _ : state)
+		{
+			for (const auto& [feederIndex, receiverIndex] : network.links)
+			{
+				*network.belts[feederIndex] >> *network.belts[receiverIndex];
+				*network.belts[feederIndex] >> *network.belts[receiverIndex];
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+
+	// Whole network is advanced by the supply chain.
+	void TickSupplyChain(benchmark::State& state)
+	{
+		Network network{ static_cast<size_t>(state.range(0)) };
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(network.chain.Tick(static_cast<size_t>(state.range(1))));
+		}
+
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+} // namespace
+
+BENCHMARK(TickPerLink)->Arg(4096);
+BENCHMARK(TickSupplyChain)->Args({ 4096, 1 })->Args({ 4096, 4 });
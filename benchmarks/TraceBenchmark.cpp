@@ -0,0 +1,38 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <Profiling/TraceRecorder.h>
+
+namespace
+{
+	// Cost of one recorded zone, the price every traced entry point pays in builds with VESSEL_TRACE.
+	void RecordTraceZone(benchmark::State& state)
+	{
+		::Vessel::TraceRecorder::Clear();
+
+		for (auto _ : state)
+		{
+			const ::Vessel::TraceZone zone{ "Bench" };
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Cost of one zone as compiled into the library, nothing in builds without VESSEL_TRACE.
+	void ScopedTraceZone(benchmark::State& state)
+	{
+		::Vessel::TraceRecorder::Clear();
+
+		for (auto _ : state)
+		{
+			const ::Vessel::ScopedTraceZone zone{ "Bench" };
+			benchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+} // namespace
+
+BENCHMARK(RecordTraceZone);
+BENCHMARK(ScopedTraceZone);
@@ -0,0 +1,125 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <vector>
+
+#include <Stackable/Package.h>
+#include <Stackable/Container.h>
+
+namespace
+{
+	struct LogBenchTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Steel,
+			Wood,
+			Count,
+		};
+
+		static constexpr bool LogTransfers = true;
+	};
+
+	using LogModel = ::Vessel::ResourceModel<LogBenchTag>;
+	using Package = ::Vessel::Package<LogModel>;
+	using TransferLog = ::Vessel::TransferLog<LogModel>;
+	using TransferReplay = ::Vessel::TransferReplay<LogModel>;
+
+	constexpr float kCapacityAmountKg = 500.f;
+	constexpr size_t kPackageCount = 64u;
+
+	static const Package::ResourceTable kCapacities
+	{
+		{ LogModel::ResourceId::Steel, kCapacityAmountKg },
+		{ LogModel::ResourceId::Wood, kCapacityAmountKg },
+	};
+
+	// Ring of packages passing their resources to the next one.
+	class World final
+	{
+	public:
+		World()
+		{
+			packages.reserve(kPackageCount);
+			for (uint32_t index = 0u; index < kPackageCount; ++index)
+			{
+				packages.emplace_back(kCapacities);
+				packages.back().SetLogId(index);
+			}
+
+			for (Package& package : packages)
+			{
+				pointers.push_back(&package);
+			}
+
+			packages.front().LoadState(kCapacities);
+		}
+
+		void Tick(size_t step)
+		{
+			packages[step % kPackageCount] >> packages[(step + 1u) % kPackageCount];
+		}
+
+	public:
+		std::vector<Package> packages;
+		std::vector<Package*> pointers;
+	};
+
+	const std::filesystem::path& GetLogPath()
+	{
+		static const std::filesystem::path kPath = std::filesystem::temp_directory_path() / "VesselTransferLogBenchmark.bin";
+		return kPath;
+	}
+
+	void ExchangeRecording(benchmark::State& state)
+	{
+		World world;
+		TransferLog::Open(GetLogPath());
+
+		size_t step = 0u;
+		for (auto _ : state)
+		{
+			world.Tick(step++);
+		}
+
+		TransferLog::Close();
+	}
+
+	void ReplayThroughput(benchmark::State& state)
+	{
+		// Record the log once.
+		{
+			World world;
+			TransferLog::Open(GetLogPath());
+			for (size_t step = 0u; step < static_cast<size_t>(state.range(0)); ++step)
+			{
+				world.Tick(step);
+			}
+			TransferLog::Close(TransferLog::Checksum(world.pointers));
+		}
+
+		const size_t logBytes = std::filesystem::file_size(GetLogPath());
+
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			World snapshot;
+			state.ResumeTiming();
+
+			std::optional<TransferReplay::Result> result = TransferReplay::Replay(GetLogPath(), snapshot.pointers);
+			if (!result.has_value() || !result->IsDeterministic())
+			{
+				state.SkipWithError("Replay diverged from the recorded state.");
+				break;
+			}
+		}
+
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * logBytes));
+		std::filesystem::remove(GetLogPath());
+	}
+} // namespace
+
+BENCHMARK(ExchangeRecording);
+BENCHMARK(ReplayThroughput)->Arg(1 << 16)->Arg(1 << 20);
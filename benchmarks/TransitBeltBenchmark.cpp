@@ -0,0 +1,90 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <Polymorphic/BeltInterface.h>
+#include <Polymorphic/Drum.h>
+#include <Polymorphic/TransitBelt.h>
+
+namespace
+{
+	struct Crate
+	{
+		int weight = 1;
+	};
+
+	using Drum = ::Vessel::Drum<Crate>;
+	using Exchanger = ::Vessel::Exchanger<Crate>;
+	using TransitClock = ::Vessel::TransitClock<Crate>;
+	using TransitBelt = ::Vessel::TransitBelt<Crate>;
+
+	constexpr size_t kBeltCapacity = 16u;
+	constexpr size_t kBeltCount = 100000u;
+
+	// Every belt of the stride carries a crate, the rest stand idle.
+	constexpr size_t kLoadedStride = 100u;
+
+	// Turn every drum on every tick and take crates which reached the feeder.
+	void TurnEveryDrum(benchmark::State& state)
+	{
+		Crate crate;
+		std::vector<std::unique_ptr<Drum>> drums;
+		for (size_t beltIndex = 0u; beltIndex < kBeltCount; ++beltIndex)
+		{
+			Drum& drum = *drums.emplace_back(std::make_unique<Drum>(kBeltCapacity, 0u));
+			if (beltIndex % kLoadedStride == 0u)
+			{
+				drum.ExchangeReceiverSlot(crate);
+			}
+		}
+
+		for (auto _ : state)
+		{
+			for (const std::unique_ptr<Drum>& drum : drums)
+			{
+				drum->NextBeltSlot();
+				if (!drum->IsEmptySlot())
+				{
+					// Arrived crate is sent along the belt again.
+					drum->ExchangeFeederSlot();
+					drum->ExchangeReceiverSlot(crate);
+				}
+			}
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Advance the clock, only belts with arriving crates are touched.
+	void TickTransitClock(benchmark::State& state)
+	{
+		Crate crate;
+		TransitClock clock;
+		std::vector<std::unique_ptr<TransitBelt>> belts;
+		for (size_t beltIndex = 0u; beltIndex < kBeltCount; ++beltIndex)
+		{
+			TransitBelt& belt = *belts.emplace_back(std::make_unique<TransitBelt>(clock, kBeltCapacity, kBeltCapacity));
+			if (beltIndex % kLoadedStride == 0u)
+			{
+				belt.ExchangeReceiverSlot(crate);
+			}
+		}
+
+		for (auto _ : state)
+		{
+			clock.Tick([&crate](TransitBelt& belt) {
+				// Arrived crate is sent along the belt again.
+				Exchanger::PullItem(belt);
+				belt.ExchangeReceiverSlot(crate);
+				});
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+} // namespace
+
+BENCHMARK(TurnEveryDrum);
+BENCHMARK(TickTransitClock);
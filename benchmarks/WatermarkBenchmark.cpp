@@ -0,0 +1,99 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <benchmark/benchmark.h>
+
+#include <Stackable/Package.h>
+#include <Stackable/Container.h>
+
+namespace
+{
+	struct PlainBenchTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Steel,
+			Wood,
+			Count,
+		};
+	};
+
+	struct WatchBenchTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Steel,
+			Wood,
+			Count,
+		};
+
+		static constexpr bool WatchWatermarks = true;
+	};
+
+	using PlainModel = ::Vessel::ResourceModel<PlainBenchTag>;
+	using WatchModel = ::Vessel::ResourceModel<WatchBenchTag>;
+
+	constexpr float kCapacityAmountKg = 500.f;
+	constexpr float kHalfCapacityAmountKg = kCapacityAmountKg * 0.5f;
+
+	template<typename Model>
+	const typename ::Vessel::Package<Model>::ResourceTable& GetCapacities()
+	{
+		static const typename ::Vessel::Package<Model>::ResourceTable kCapacities
+		{
+			{ Model::ResourceId::Steel, kCapacityAmountKg },
+			{ Model::ResourceId::Wood, kCapacityAmountKg },
+		};
+
+		return kCapacities;
+	}
+
+	// Ping-pong half of the resources between two packages, every step crosses nothing or a watermark.
+	template<typename Model>
+	void RunExchange(benchmark::State& state, ::Vessel::Package<Model>& left, ::Vessel::Package<Model>& right)
+	{
+		left.LoadState(GetCapacities<Model>());
+
+		for (auto _ : state)
+		{
+			left >> right;
+			right >> left;
+			benchmark::DoNotOptimize(left);
+		}
+	}
+
+	void ExchangeWithoutWatermarks(benchmark::State& state)
+	{
+		::Vessel::Package<PlainModel> left{ GetCapacities<PlainModel>() };
+		::Vessel::Package<PlainModel> right{ GetCapacities<PlainModel>() };
+
+		RunExchange(state, left, right);
+	}
+
+	void ExchangeWithoutWatchers(benchmark::State& state)
+	{
+		::Vessel::Package<WatchModel> left{ GetCapacities<WatchModel>() };
+		::Vessel::Package<WatchModel> right{ GetCapacities<WatchModel>() };
+
+		RunExchange(state, left, right);
+	}
+
+	void ExchangeWithWatchers(benchmark::State& state)
+	{
+		::Vessel::Package<WatchModel> left{ GetCapacities<WatchModel>() };
+		::Vessel::Package<WatchModel> right{ GetCapacities<WatchModel>() };
+
+		size_t fired = 0u;
+		left.AddLowWatermark(WatchModel::ResourceId::Steel, kHalfCapacityAmountKg, [&fired](auto, auto) { ++fired; });
+		right.AddHighWatermark(WatchModel::ResourceId::Steel, kHalfCapacityAmountKg, [&fired](auto, auto) { ++fired; });
+
+		RunExchange(state, left, right);
+		benchmark::DoNotOptimize(fired);
+	}
+} // namespace
+
+BENCHMARK(ExchangeWithoutWatermarks);
+BENCHMARK(ExchangeWithoutWatchers);
+BENCHMARK(ExchangeWithWatchers);
@@ -0,0 +1,478 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <Polymorphic/Drum.h>
+#include <Polymorphic/Queue.h>
+#include <Polymorphic/SupplyChain.h>
+#include <Profiling/TraceRecorder.h>
+#include <Stackable/Container.h>
+#include <Stackable/ContainerBatch.h>
+#include <Stackable/Package.h>
+#include <Stackable/Transfer.h>
+
+namespace
+{
+	// Bulk goods measured in kilograms.
+	struct CargoTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Steel,
+			Wood,
+			Coal,
+			Stone,
+			Count,
+		};
+
+		static constexpr bool RelocatePackages = true;
+	};
+
+	// Goods counted by pieces.
+	struct PartsTag
+	{
+		using Units = int;
+
+		enum class ResourceId : uint8_t
+		{
+			Gears,
+			Bolts,
+			Circuits,
+			Count,
+		};
+
+		static constexpr bool RelocatePackages = true;
+	};
+
+	// States which are either on or off, kept as units with capacity of one.
+	struct PowerTag
+	{
+		using Units = int;
+
+		enum class ResourceId : uint8_t
+		{
+			Powered,
+			Guarded,
+			Count,
+		};
+
+		static constexpr bool RelocatePackages = true;
+	};
+
+	struct Crate
+	{
+		int weight = 1;
+	};
+
+	// Scenario settings, every one can be set from the command line as --name=value.
+	struct Config
+	{
+		size_t packages = 30000u;
+		size_t belts = 10000u;
+		size_t ticks = 1000u;
+		size_t layers = 4u;
+		size_t fanIn = 4u;
+		uint32_t seed = 1u;
+
+		// File to export the trace of latest zones to, builds with VESSEL_TRACE record them.
+		const char* trace = nullptr;
+	};
+
+	// Sinks are emptied once in this count of ticks, each on its own tick.
+	constexpr size_t kConsumePeriod = 8u;
+
+	// Count of crates sources load and sinks unload per tick.
+	constexpr size_t kCratesPerTick = 2u;
+
+	// Draw a number below the bound, only raw engine output is used, standard distributions differ between libraries.
+	size_t Draw(std::mt19937& random, size_t bound)
+	{
+		return static_cast<size_t>(random() % bound);
+	}
+
+	// Get the layer of the element in the evenly split range.
+	size_t GetLayer(size_t index, size_t count, size_t layerCount)
+	{
+		return index * layerCount / count;
+	}
+
+	// Get the first element of the layer in the evenly split range.
+	size_t GetLayerBegin(size_t layer, size_t count, size_t layerCount)
+	{
+		return (layer * count + layerCount - 1u) / layerCount;
+	}
+
+	/**
+	* Economy is a layered graph of packages of one model.
+	*
+	* Behaviour:
+	* - Packages of the first layer are filled with loot every tick.
+	* - Every package of other layers is supplied by up to fan-in random packages of the previous layer, so fan-out varies.
+	* - Packages of the last layer are emptied periodically.
+	*/
+	template<class Tag>
+	class Economy final
+	{
+		// Public nested types.
+	public:
+		using Model = ::Vessel::ResourceModel<Tag>;
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+		using Package = ::Vessel::Package<Model>;
+		using Transfer = ::Vessel::Transfer<Model>;
+		using ContainerBatch = ::Vessel::ContainerBatch<Model>;
+
+		// Life circle.
+	public:
+		Economy(size_t packageCount, Units capacity, const Config& config, std::mt19937& random);
+
+		// Public interface.
+	public:
+		// Fill sources, exchange over every link and empty due sinks.
+		void Tick(size_t tick);
+
+		// Get sum of all units in packages.
+		double GetUnitsSum() const;
+
+		// Private nested types.
+	private:
+		struct Link
+		{
+			size_t providerIndex;
+			size_t consumerIndex;
+		};
+
+		// Private state.
+	private:
+		typename Package::ResourceTable mCapacities;
+		std::vector<Package> mPackages;
+		std::vector<Link> mLinks;
+		std::vector<ContainerBatch> mLoot;
+		size_t mSinkBegin = 0u;
+	};
+
+	template<class Tag>
+	Economy<Tag>::Economy(size_t packageCount, Units capacity, const Config& config, std::mt19937& random)
+	{
+		for (uint8_t index = 0u; index < Model::kResourceCount; ++index)
+		{
+			mCapacities[static_cast<ResourceId>(index)] = capacity;
+		}
+
+		const size_t layerCount = std::max<size_t>(config.layers, 2u);
+		packageCount = std::max(packageCount, layerCount);
+
+		mPackages.reserve(packageCount);
+		for (size_t index = 0u; index < packageCount; ++index)
+		{
+			mPackages.emplace_back(mCapacities);
+		}
+
+		// Every source drops a few random resources a tick.
+		mLoot.resize(GetLayerBegin(1u, packageCount, layerCount));
+		for (ContainerBatch& loot : mLoot)
+		{
+			for (size_t count = 1u + Draw(random, 3u); count > 0u; --count)
+			{
+				loot.Add(static_cast<ResourceId>(Draw(random, Model::kResourceCount)), std::min(static_cast<Units>(1u + Draw(random, 8u)), capacity));
+			}
+		}
+
+		for (size_t consumerIndex = mLoot.size(); consumerIndex < packageCount; ++consumerIndex)
+		{
+			const size_t layer = GetLayer(consumerIndex, packageCount, layerCount);
+			const size_t providerBegin = GetLayerBegin(layer - 1u, packageCount, layerCount);
+			const size_t providerCount = GetLayerBegin(layer, packageCount, layerCount) - providerBegin;
+
+			for (size_t count = 1u + Draw(random, std::max<size_t>(config.fanIn, 1u)); count > 0u; --count)
+			{
+				mLinks.push_back({ providerBegin + Draw(random, providerCount), consumerIndex });
+			}
+		}
+
+		mSinkBegin = GetLayerBegin(layerCount - 1u, packageCount, layerCount);
+	}
+
+	template<class Tag>
+	void Economy<Tag>::Tick(size_t tick)
+	{
+		for (size_t index = 0u; index < mLoot.size(); ++index)
+		{
+			Transfer::Fill(mPackages[index], mLoot[index]);
+		}
+
+		for (const Link& link : mLinks)
+		{
+			Transfer::Exchange(mPackages[link.providerIndex], mPackages[link.consumerIndex]);
+		}
+
+		for (size_t index = mSinkBegin; index < mPackages.size(); ++index)
+		{
+			if ((index + tick) % kConsumePeriod == 0u)
+			{
+				mPackages[index].ResetState();
+			}
+		}
+	}
+
+	template<class Tag>
+	double Economy<Tag>::GetUnitsSum() const
+	{
+		double sum = 0.0;
+		for (const Package& package : mPackages)
+		{
+			for (uint8_t index = 0u; index < Model::kResourceCount; ++index)
+			{
+				sum += static_cast<double>(package.GetAvailableUnits(static_cast<ResourceId>(index)));
+			}
+		}
+		return sum;
+	}
+
+	/**
+	* Logistics is a layered supply chain of drums and queues.
+	*
+	* Behaviour:
+	* - Belts of the first layer are loaded with crates every tick and belts of the last layer are unloaded.
+	* - Every belt of other layers is fed by up to fan-in random belts of the previous layer with random rates.
+	*/
+	class Logistics final
+	{
+		// Public nested types.
+	public:
+		using BeltInterface = ::Vessel::BeltInterface<Crate>;
+		using Exchanger = ::Vessel::Exchanger<Crate>;
+
+		// Life circle.
+	public:
+		Logistics(const Config& config, std::mt19937& random);
+
+		// Public interface.
+	public:
+		// Load sources, advance the chain and unload sinks, returns count of moved crates.
+		size_t Tick();
+
+		// Get count of crates on belts.
+		size_t GetItemCount() const;
+
+		// Private constants.
+	private:
+		static constexpr size_t kCrateCount = 1024u;
+
+		// Private state.
+	private:
+		std::vector<Crate> mCrates = std::vector<Crate>(kCrateCount);
+		std::vector<std::unique_ptr<BeltInterface>> mBelts;
+		::Vessel::SupplyChain<Crate> mChain;
+		size_t mSourceEnd = 0u;
+		size_t mSinkBegin = 0u;
+		size_t mNextCrate = 0u;
+	};
+
+	Logistics::Logistics(const Config& config, std::mt19937& random)
+	{
+		const size_t layerCount = std::max<size_t>(config.layers, 2u);
+		const size_t beltCount = std::max(config.belts, layerCount);
+
+		for (size_t index = 0u; index < beltCount; ++index)
+		{
+			const size_t capacity = 8u + Draw(random, 57u);
+			if (Draw(random, 2u) == 0u)
+			{
+				mBelts.push_back(std::make_unique<::Vessel::Drum<Crate>>(capacity));
+			}
+			else
+			{
+				mBelts.push_back(std::make_unique<::Vessel::Queue<Crate>>(capacity));
+			}
+
+			mChain.AddBelt(*mBelts.back());
+		}
+
+		mSourceEnd = GetLayerBegin(1u, beltCount, layerCount);
+		mSinkBegin = GetLayerBegin(layerCount - 1u, beltCount, layerCount);
+
+		for (size_t receiverIndex = mSourceEnd; receiverIndex < beltCount; ++receiverIndex)
+		{
+			const size_t layer = GetLayer(receiverIndex, beltCount, layerCount);
+			const size_t feederBegin = GetLayerBegin(layer - 1u, beltCount, layerCount);
+			const size_t feederCount = GetLayerBegin(layer, beltCount, layerCount) - feederBegin;
+
+			for (size_t count = 1u + Draw(random, std::max<size_t>(config.fanIn, 1u)); count > 0u; --count)
+			{
+				mChain.Link(feederBegin + Draw(random, feederCount), receiverIndex, 1u + Draw(random, 4u));
+			}
+		}
+	}
+
+	size_t Logistics::Tick()
+	{
+		for (size_t index = 0u; index < mSourceEnd; ++index)
+		{
+			for (size_t count = 0u; count < kCratesPerTick; ++count)
+			{
+				Exchanger::PushItem(*mBelts[index], mCrates[mNextCrate]);
+				mNextCrate = mNextCrate + 1u < kCrateCount ? mNextCrate + 1u : 0u;
+			}
+		}
+
+		const size_t movedCount = mChain.Tick();
+
+		for (size_t index = mSinkBegin; index < mBelts.size(); ++index)
+		{
+			for (size_t count = 0u; count < kCratesPerTick; ++count)
+			{
+				Exchanger::PullItem(*mBelts[index]);
+			}
+		}
+
+		return movedCount;
+	}
+
+	size_t Logistics::GetItemCount() const
+	{
+		size_t count = 0u;
+		for (const std::unique_ptr<BeltInterface>& belt : mBelts)
+		{
+			count += belt->GetItemCount();
+		}
+		return count;
+	}
+
+	// Read --name=value arguments, returns false on unknown ones.
+	bool ParseConfig(int argc, char** argv, Config& config)
+	{
+		for (int index = 1; index < argc; ++index)
+		{
+			const std::string_view argument = argv[index];
+			const size_t separator = argument.find('=');
+			if (argument.substr(0u, 2u) != "--" || separator == std::string_view::npos)
+			{
+				return false;
+			}
+
+			const std::string_view name = argument.substr(2u, separator - 2u);
+			if (name == "trace")
+			{
+				config.trace = argv[index] + separator + 1u;
+				continue;
+			}
+
+			const size_t value = static_cast<size_t>(std::strtoull(argv[index] + separator + 1u, nullptr, 10));
+
+			if (name == "packages") { config.packages = value; }
+			else if (name == "belts") { config.belts = value; }
+			else if (name == "ticks") { config.ticks = value; }
+			else if (name == "layers") { config.layers = value; }
+			else if (name == "fan-in") { config.fanIn = value; }
+			else if (name == "seed") { config.seed = static_cast<uint32_t>(value); }
+			else { return false; }
+		}
+
+		return true;
+	}
+
+	// Get peak resident memory of the process in kilobytes.
+	size_t GetPeakMemoryKb()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters{};
+		GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+		return static_cast<size_t>(counters.PeakWorkingSetSize / 1024u);
+#else
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+		return static_cast<size_t>(usage.ru_maxrss) / 1024u;
+#else
+		return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#endif
+	}
+
+	// Get the percentile of sorted values.
+	double GetPercentile(const std::vector<double>& sortedValues, size_t percent)
+	{
+		return sortedValues.empty() ? 0.0 : sortedValues[(sortedValues.size() - 1u) * percent / 100u];
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Config config;
+	if (!ParseConfig(argc, argv, config))
+	{
+		std::printf("Usage: %s [--packages=N] [--belts=M] [--ticks=K] [--layers=L] [--fan-in=F] [--seed=S] [--trace=FILE]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	// World is built from one seeded engine in a fixed order, so equal settings build equal worlds.
+	std::mt19937 random{ config.seed };
+	Economy<CargoTag> cargo{ config.packages * 5u / 10u, 64.f, config, random };
+	Economy<PartsTag> parts{ config.packages * 3u / 10u, 64, config, random };
+	Economy<PowerTag> power{ config.packages - config.packages * 8u / 10u, 1, config, random };
+	Logistics logistics{ config, random };
+
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<double> tickMicroseconds;
+	tickMicroseconds.reserve(config.ticks);
+	size_t movedCount = 0u;
+
+	const Clock::time_point runStart = Clock::now();
+	for (size_t tick = 0u; tick < config.ticks; ++tick)
+	{
+		const Clock::time_point tickStart = Clock::now();
+		const ::Vessel::ScopedTraceZone zone{ "Scenario::Tick" };
+
+		cargo.Tick(tick);
+		parts.Tick(tick);
+		power.Tick(tick);
+		movedCount += logistics.Tick();
+
+		tickMicroseconds.push_back(std::chrono::duration<double, std::micro>(Clock::now() - tickStart).count());
+	}
+	const double runSeconds = std::chrono::duration<double>(Clock::now() - runStart).count();
+
+	std::sort(tickMicroseconds.begin(), tickMicroseconds.end());
+
+	// Checksum of the final state tells whether two runs simulated the same world.
+	const double unitsSum = cargo.GetUnitsSum() + parts.GetUnitsSum() + power.GetUnitsSum();
+
+	std::printf("seed=%u packages=%zu belts=%zu ticks=%zu layers=%zu fan-in=%zu\n", config.seed, config.packages, config.belts, config.ticks, config.layers, config.fanIn);
+	std::printf("ticks_per_second=%.1f\n", runSeconds > 0.0 ? static_cast<double>(config.ticks) / runSeconds : 0.0);
+	std::printf("tick_p50_us=%.1f\n", GetPercentile(tickMicroseconds, 50u));
+	std::printf("tick_p99_us=%.1f\n", GetPercentile(tickMicroseconds, 99u));
+	std::printf("peak_rss_kb=%zu\n", GetPeakMemoryKb());
+	std::printf("checksum_units=%.3f\n", unitsSum);
+	std::printf("checksum_crates=%zu/%zu\n", movedCount, logistics.GetItemCount());
+
+	if (config.trace != nullptr)
+	{
+		if (!::Vessel::TraceRecorder::ExportChromeTrace(config.trace))
+		{
+			std::printf("Can't write trace to %s\n", config.trace);
+			return EXIT_FAILURE;
+		}
+
+		std::printf("trace_zones=%zu\n", ::Vessel::TraceRecorder::GetZoneCount());
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -1,15 +1,36 @@
 ﻿// (c) 2024 Acid7Beast. Use with wisdom.
 #pragma once
 
+#include "../Profiling/Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
 #include <optional>
 #include <memory>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace Vessel
 {
+	// Are slot scans cross-checking maintained counts compiled in, enabled by defining VESSEL_CHECK_BELTS, e.g. for tests.
+#if defined(VESSEL_CHECK_BELTS)
+	inline constexpr bool kCheckBelts = true;
+#else
+	inline constexpr bool kCheckBelts = false;
+#endif
+
 	template<class BasicType>
 	class SupplyChain;
 
+	template<class BasicType>
+	class Exchanger;
+
+	template<class BasicType>
+	class BeltSnapshot;
+
 	template<class BasicType>
 	class BeltInterface
 	{
@@ -18,6 +39,19 @@ namespace Vessel
 		using ReferenceWrapper = std::reference_wrapper<const BasicType>;
 		using OptionalRefWrapper = std::optional<ReferenceWrapper>;
 
+		// Compact slot storage, null marks a free slot.
+		using SlotPointer = const BasicType*;
+
+		// Callback for a run of contiguous slots.
+		using SlotRunCallback = void (*)(void* context, std::span<const SlotPointer> slots);
+
+		// Slots of belts which keep them in a plain buffer, the feeder faces the slot at the feeder index.
+		struct SlotLayout
+		{
+			std::span<const SlotPointer> slots;
+			size_t feederIndex;
+		};
+
 		// Life circle.
 	public:
 		virtual ~BeltInterface() = default;
@@ -40,6 +74,12 @@ namespace Vessel
 		// Is here free slot on belt end.
 		virtual bool IsEmptySlot(size_t offset = 0u) const = 0;
 
+		// Get distance from the offset to the nearest occupied slot, wrapping around the belt.
+		virtual std::optional<size_t> FindOccupiedSlot(size_t offset = 0u) const { return FindSlot(offset, false); }
+
+		// Get distance from the offset to the nearest free slot, wrapping around the belt.
+		virtual std::optional<size_t> FindEmptySlot(size_t offset = 0u) const { return FindSlot(offset, true); }
+
 		// Get non-empty items count.
 		virtual size_t GetItemCount() const = 0;
 
@@ -49,14 +89,153 @@ namespace Vessel
 		// Get receiver slot offset for feeder.
 		virtual size_t GetReceiverSlotOffset() const = 0;
 
+		// Get count of items the receiver end takes before it refuses them.
+		virtual size_t GetReceivableCount() const { return GetSlotCount() - GetItemCount(); }
+
 		// Get slot items for saving or displaying.
-		virtual std::vector<OptionalRefWrapper> GetSlotItems() const = 0;
+		virtual std::vector<OptionalRefWrapper> GetSlotItems() const;
+
+		// Pull items from the feeder end in the order single pulls would take them, returns count of pulled items.
+		virtual size_t PullFeederItems(std::span<SlotPointer> items);
+
+		// Push non-empty items to the receiver end in the order single pushes would place them, returns count of pushed items.
+		virtual size_t PushReceiverItems(std::span<const SlotPointer> items);
+
+		// Can items just pulled from the feeder end go back to it.
+		virtual bool CanReturnFeederItems() const { return true; }
+
+		// Put items just pulled back to the feeder end in front of the rest, items go in pull order, returns count of returned items.
+		virtual size_t ReturnFeederItems(std::span<const SlotPointer> items);
+
+		// Public interface.
+	public:
+		// Visit slots from the feeder end run by run without allocations or copies, slots behind the last run are free.
+		// Belts which keep items out of feeder order, like PriorityBelt, sort them once after every change.
+		template<typename Visitor>
+		inline void VisitSlots(Visitor&& visitor) const;
+
+		// Inheritable virtual interface.
+	protected:
+		// Pass runs of contiguous slots from the feeder end to the callback.
+		virtual void VisitSlotRuns(void* context, SlotRunCallback callback) const = 0;
+
+		// Get the plain slot buffer, belts without one return nothing.
+		virtual std::optional<SlotLayout> GetSlotLayout() const { return {}; }
+
+		// Replace the plain slot buffer, set bits of occupancy words take items in order, returns false for belts without one.
+		virtual bool SetSlotLayout(size_t feederIndex, std::span<const uint64_t> occupancyWords, std::span<const SlotPointer> items) { return false; }
+
+		// Inheritable static interface.
+	protected:
+		// Convert an item to compact slot storage.
+		static SlotPointer ToSlot(OptionalRefWrapper item) { return item.has_value() ? &item.value().get() : nullptr; }
+
+		// Convert compact slot storage back to an item.
+		static OptionalRefWrapper ToItem(SlotPointer slot) { return slot != nullptr ? OptionalRefWrapper{ *slot } : OptionalRefWrapper{}; }
+
+		// Private interface.
+	private:
+		// Walk slots one by one for belts without own lookup.
+		std::optional<size_t> FindSlot(size_t offset, bool empty) const
+		{
+			const size_t slotCount = GetSlotCount();
+			for (size_t distance = 0u; distance < slotCount; ++distance)
+			{
+				if (IsEmptySlot(offset + distance) == empty)
+				{
+					return distance;
+				}
+			}
+
+			return {};
+		}
 
 		// Inheritable friend types.
 	protected:
 		friend SupplyChain<BasicType>;
+		friend BeltSnapshot<BasicType>;
 	};
 
+	template<class BasicType>
+	template<typename Visitor>
+	inline void BeltInterface<BasicType>::VisitSlots(Visitor&& visitor) const
+	{
+		const ScopedTraceZone zone{ "BeltInterface::VisitSlots" };
+
+		using VisitorType = std::remove_reference_t<Visitor>;
+
+		void* context = const_cast<void*>(static_cast<const void*>(std::addressof(visitor)));
+		VisitSlotRuns(context, [](void* context, std::span<const SlotPointer> slots) {
+			(*static_cast<VisitorType*>(context))(slots);
+			});
+	}
+
+	template<class BasicType>
+	inline std::vector<typename BeltInterface<BasicType>::OptionalRefWrapper> BeltInterface<BasicType>::GetSlotItems() const
+	{
+		std::vector<OptionalRefWrapper> result;
+		result.reserve(GetSlotCount());
+
+		VisitSlots([&result](std::span<const SlotPointer> slots) {
+			for (SlotPointer slot : slots)
+			{
+				result.push_back(ToItem(slot));
+			}
+			});
+
+		result.resize(GetSlotCount());
+		return result;
+	}
+
+	template<class BasicType>
+	inline size_t BeltInterface<BasicType>::PullFeederItems(std::span<SlotPointer> items)
+	{
+		size_t pulledCount = 0u;
+		for (; pulledCount < items.size(); ++pulledCount)
+		{
+			const OptionalRefWrapper item = Exchanger<BasicType>::PullItem(*this);
+			if (!item.has_value())
+			{
+				break;
+			}
+
+			items[pulledCount] = ToSlot(item);
+		}
+
+		return pulledCount;
+	}
+
+	template<class BasicType>
+	inline size_t BeltInterface<BasicType>::PushReceiverItems(std::span<const SlotPointer> items)
+	{
+		size_t pushedCount = 0u;
+		for (; pushedCount < items.size(); ++pushedCount)
+		{
+			if (Exchanger<BasicType>::PushItem(*this, ToItem(items[pushedCount])).has_value())
+			{
+				break;
+			}
+		}
+
+		return pushedCount;
+	}
+
+	template<class BasicType>
+	inline size_t BeltInterface<BasicType>::ReturnFeederItems(std::span<const SlotPointer> items)
+	{
+		// Feeder end takes an item to a free slot in front of the rest, the last pulled item goes first.
+		size_t returnedCount = 0u;
+		for (; returnedCount < items.size() && GetItemCount() < GetSlotCount(); ++returnedCount)
+		{
+			if (ExchangeFeederSlot(ToItem(items[items.size() - 1u - returnedCount])).has_value())
+			{
+				break;
+			}
+		}
+
+		return returnedCount;
+	}
+
 	template<class BasicType>
 	class Exchanger
 	{
@@ -64,19 +243,28 @@ namespace Vessel
 	public:
 		using ReferenceWrapper = std::reference_wrapper<const BasicType>;
 		using OptionalRefWrapper = std::optional<ReferenceWrapper>;
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
 
 		// Static public interface.
 	public:
 		static OptionalRefWrapper PullItem(BeltInterface<BasicType>& feeder)
 		{
+			const ScopedTraceZone zone{ "Exchanger::PullItem" };
+
 			if (feeder.GetItemCount() == 0)
 			{
 				return {};
 			}
 
-			while (feeder.IsEmptySlot())
+			const std::optional<size_t> distance = feeder.FindOccupiedSlot();
+			if (!distance.has_value())
+			{
+				return {};
+			}
+
+			if (distance.value() > 0u)
 			{
-				feeder.NextBeltSlot();
+				feeder.NextBeltSlot(distance.value());
 			}
 
 			return feeder.ExchangeFeederSlot({});
@@ -84,14 +272,29 @@ namespace Vessel
 
 		static OptionalRefWrapper PushItem(BeltInterface<BasicType>& receiver, OptionalRefWrapper item)
 		{
+			const ScopedTraceZone zone{ "Exchanger::PushItem" };
+
 			if (receiver.GetSlotCount() == receiver.GetItemCount())
 			{
 				return item;
 			}
 
-			while (!receiver.IsEmptySlot(receiver.GetReceiverSlotOffset()))
+			const size_t receiverOffset = receiver.GetReceiverSlotOffset();
+			const std::optional<size_t> distance = receiver.FindEmptySlot(receiverOffset);
+			if (!distance.has_value())
+			{
+				return item;
+			}
+
+			if (distance.value() > 0u)
 			{
-				receiver.NextBeltSlot();
+				receiver.NextBeltSlot(distance.value());
+			}
+
+			// Belts which can't turn keep their free slots where they are.
+			if (!receiver.IsEmptySlot(receiverOffset))
+			{
+				return item;
 			}
 
 			return receiver.ExchangeReceiverSlot(item);
@@ -108,6 +311,52 @@ namespace Vessel
 
 			PushItem(receiver, item);
 		}
+
+		// Move up to count items at once in the order of single exchanges, returns count of moved items.
+		static size_t ExchangeN(BeltInterface<BasicType>& receiver, BeltInterface<BasicType>& feeder, size_t count)
+		{
+			const ScopedTraceZone zone{ "Exchanger::ExchangeN" };
+
+			// Items which the receiver refuses go back, feeders which can't take them are refused.
+			if (!feeder.CanReturnFeederItems())
+			{
+				return 0u;
+			}
+
+			// Counts are read once, items which can't be placed are never pulled.
+			count = std::min({ count, feeder.GetItemCount(), receiver.GetReceivableCount() });
+
+			std::array<SlotPointer, kBatchSize> batch;
+			size_t movedCount = 0u;
+
+			while (movedCount < count)
+			{
+				const size_t batchSize = std::min(count - movedCount, kBatchSize);
+				const size_t pulledCount = feeder.PullFeederItems(std::span{ batch.data(), batchSize });
+				const size_t pushedCount = receiver.PushReceiverItems(std::span<const SlotPointer>{ batch.data(), pulledCount });
+				movedCount += pushedCount;
+
+				// Receiver refuses items within its receivable count only if it's filled meanwhile, the rest goes back.
+				if (pushedCount < pulledCount)
+				{
+					[[maybe_unused]] const size_t returnedCount = feeder.ReturnFeederItems(std::span<const SlotPointer>{ batch.data() + pushedCount, pulledCount - pushedCount });
+					assert(returnedCount == pulledCount - pushedCount && "Items put back to the feeder end are lost.");
+					break;
+				}
+
+				if (pulledCount < batchSize)
+				{
+					break;
+				}
+			}
+
+			return movedCount;
+		}
+
+		// Private constants.
+	private:
+		// Count of items moved between belts at once.
+		static constexpr size_t kBatchSize = 64u;
 	};
 
 
@@ -0,0 +1,240 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "BeltInterface.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace Vessel
+{
+	/**
+	* BeltSnapshot is a compact binary state of a belt, items are stored as indices of an item table owned by the caller.
+	*
+	* Layout, native byte order:
+	* - Header: count of slots, feeder index and count of items as 32-bit values.
+	* - Occupancy bitmap of slot storage, one bit per slot in 64-bit words.
+	* - Item table indices of occupied slots in storage order, 32 bits each.
+	*
+	* Behaviour:
+	* - Drum and Queue are saved from and restored into their slot buffers directly, keeping the feeder index.
+	* - Other belts are saved in order from the feeder end and restored through SetSlotItems.
+	* - A snapshot reused to read many belts grows its buffers once, then loads without allocations.
+	*/
+	template<class BasicType>
+	class BeltSnapshot final
+	{
+		// Public nested types.
+	public:
+		using OptionalRefWrapper = BeltInterface<BasicType>::OptionalRefWrapper;
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
+		using ItemIndex = uint32_t;
+		using Word = uint64_t;
+
+		// Public constants.
+	public:
+		// Bytes of the header.
+		static constexpr size_t kHeaderBytes = sizeof(uint32_t) * 3u;
+
+		// Public interface.
+	public:
+		// Save the belt, the indexer maps every item to its index in the item table.
+		template<typename ItemIndexer>
+		inline void Save(const BeltInterface<BasicType>& belt, ItemIndexer&& indexer);
+
+		// Restore the belt with items of the table, returns false if the snapshot doesn't fit the belt or the table.
+		inline bool Restore(BeltInterface<BasicType>& belt, std::span<const SlotPointer> itemTable);
+
+		// Append binary form to the bytes.
+		inline void Write(std::vector<std::byte>& bytes) const;
+
+		// Read binary form from the front of the bytes, returns count of read bytes or zero if they're truncated or broken.
+		inline size_t Read(std::span<const std::byte> bytes);
+
+		// Get count of bytes of binary form.
+		inline size_t GetByteSize() const { return kHeaderBytes + mOccupancy.size() * sizeof(Word) + mItemIndices.size() * sizeof(ItemIndex); }
+
+		// Get count of belt slots.
+		inline size_t GetSlotCount() const { return mSlotCount; }
+
+		// Get storage index of the slot the feeder faces.
+		inline size_t GetFeederIndex() const { return mFeederIndex; }
+
+		// Get count of items.
+		inline size_t GetItemCount() const { return mItemIndices.size(); }
+
+		// Private interface.
+	private:
+		// Get count of occupancy words for the count of slots.
+		static inline size_t GetWordCount(size_t slotCount) { return (slotCount + kWordBits - 1u) / kWordBits; }
+
+		// Private constants.
+	private:
+		static constexpr size_t kWordBits = sizeof(Word) * 8u;
+
+		// Private state.
+	private:
+		size_t mSlotCount = 0u;
+		size_t mFeederIndex = 0u;
+		std::vector<Word> mOccupancy;
+		std::vector<ItemIndex> mItemIndices;
+
+		// Items resolved on restore, kept to reuse the buffer.
+		std::vector<SlotPointer> mItems;
+	};
+
+	template<class BasicType>
+	template<typename ItemIndexer>
+	inline void BeltSnapshot<BasicType>::Save(const BeltInterface<BasicType>& belt, ItemIndexer&& indexer)
+	{
+		const std::optional<typename BeltInterface<BasicType>::SlotLayout> layout = belt.GetSlotLayout();
+
+		mSlotCount = belt.GetSlotCount();
+		mFeederIndex = layout.has_value() ? layout.value().feederIndex : 0u;
+		mOccupancy.assign(GetWordCount(mSlotCount), Word{ 0 });
+		mItemIndices.clear();
+		mItemIndices.reserve(belt.GetItemCount());
+
+		assert(mSlotCount <= std::numeric_limits<uint32_t>::max() && "Belt is too large for the snapshot.");
+
+		size_t slotIndex = 0u;
+		auto saveSlots = [&](std::span<const SlotPointer> slots) {
+			for (SlotPointer slot : slots)
+			{
+				if (slot != nullptr)
+				{
+					mOccupancy[slotIndex / kWordBits] |= Word{ 1 } << (slotIndex % kWordBits);
+					mItemIndices.push_back(static_cast<ItemIndex>(indexer(*slot)));
+				}
+				++slotIndex;
+			}
+			};
+
+		if (layout.has_value())
+		{
+			saveSlots(layout.value().slots);
+		}
+		else
+		{
+			belt.VisitSlots(saveSlots);
+		}
+	}
+
+	template<class BasicType>
+	inline bool BeltSnapshot<BasicType>::Restore(BeltInterface<BasicType>& belt, std::span<const SlotPointer> itemTable)
+	{
+		if (belt.GetSlotCount() != mSlotCount)
+		{
+			return false;
+		}
+
+		mItems.resize(mItemIndices.size());
+		for (size_t index = 0u; index < mItemIndices.size(); ++index)
+		{
+			if (mItemIndices[index] >= itemTable.size())
+			{
+				return false;
+			}
+
+			mItems[index] = itemTable[mItemIndices[index]];
+		}
+
+		if (belt.SetSlotLayout(mFeederIndex, mOccupancy, mItems))
+		{
+			return true;
+		}
+
+		// Belts without a plain slot buffer take items in order from the feeder end.
+		std::vector<OptionalRefWrapper> slotItems(mSlotCount);
+		size_t itemIndex = 0u;
+		for (size_t slotIndex = 0u; slotIndex < mSlotCount; ++slotIndex)
+		{
+			if ((mOccupancy[slotIndex / kWordBits] >> (slotIndex % kWordBits)) & Word{ 1 })
+			{
+				slotItems[(slotIndex + mSlotCount - mFeederIndex) % mSlotCount] = *mItems[itemIndex++];
+			}
+		}
+
+		belt.SetSlotItems(std::move(slotItems));
+		return true;
+	}
+
+	template<class BasicType>
+	inline void BeltSnapshot<BasicType>::Write(std::vector<std::byte>& bytes) const
+	{
+		const uint32_t header[] = {
+			static_cast<uint32_t>(mSlotCount),
+			static_cast<uint32_t>(mFeederIndex),
+			static_cast<uint32_t>(mItemIndices.size()),
+		};
+
+		const size_t offset = bytes.size();
+		bytes.resize(offset + GetByteSize());
+
+		std::byte* data = bytes.data() + offset;
+		std::memcpy(data, header, kHeaderBytes);
+		data += kHeaderBytes;
+		std::memcpy(data, mOccupancy.data(), mOccupancy.size() * sizeof(Word));
+		data += mOccupancy.size() * sizeof(Word);
+		std::memcpy(data, mItemIndices.data(), mItemIndices.size() * sizeof(ItemIndex));
+	}
+
+	template<class BasicType>
+	inline size_t BeltSnapshot<BasicType>::Read(std::span<const std::byte> bytes)
+	{
+		if (bytes.size() < kHeaderBytes)
+		{
+			return 0u;
+		}
+
+		uint32_t header[3];
+		std::memcpy(header, bytes.data(), kHeaderBytes);
+
+		const size_t slotCount = header[0];
+		const size_t feederIndex = header[1];
+		const size_t itemCount = header[2];
+		const size_t wordCount = GetWordCount(slotCount);
+		const size_t byteSize = kHeaderBytes + wordCount * sizeof(Word) + itemCount * sizeof(ItemIndex);
+
+		if (bytes.size() < byteSize || itemCount > slotCount || (feederIndex >= slotCount && slotCount > 0u))
+		{
+			return 0u;
+		}
+
+		mSlotCount = slotCount;
+		mFeederIndex = feederIndex;
+		mOccupancy.resize(wordCount);
+		mItemIndices.resize(itemCount);
+
+		const std::byte* data = bytes.data() + kHeaderBytes;
+		std::memcpy(mOccupancy.data(), data, wordCount * sizeof(Word));
+		data += wordCount * sizeof(Word);
+		std::memcpy(mItemIndices.data(), data, itemCount * sizeof(ItemIndex));
+
+		// Every item must have its slot and no slot may lay behind the end of the belt.
+		const size_t occupiedCount = std::accumulate(mOccupancy.cbegin(), mOccupancy.cend(), size_t{ 0 }, [](size_t count, Word word) {
+			return count + static_cast<size_t>(std::popcount(word));
+			});
+		const size_t tailBits = slotCount % kWordBits;
+		const bool hasTailGarbage = tailBits != 0u && (mOccupancy.back() >> tailBits) != Word{ 0 };
+
+		if (occupiedCount != itemCount || hasTailGarbage)
+		{
+			mSlotCount = 0u;
+			mFeederIndex = 0u;
+			mOccupancy.clear();
+			mItemIndices.clear();
+			return 0u;
+		}
+
+		return byteSize;
+	}
+} // Vessel
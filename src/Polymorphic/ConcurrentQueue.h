@@ -0,0 +1,203 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "BeltInterface.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+
+namespace Vessel
+{
+	/**
+	* ConcurrentQueue is a lock-free belt between exactly one producer thread and one consumer thread.
+	*
+	* Requirements:
+	* - ExchangeReceiverSlot is called only from the producer thread, it's the producer end of the belt.
+	* - ExchangeFeederSlot, NextBeltSlot, GetSlotItems and VisitSlots are called only from the consumer thread.
+	*
+	* Behaviour:
+	* - Items are kept in a ring buffer, head and tail indices live on separate cache lines.
+	* - Each end caches the opposite index, so the shared cache line is touched only when the belt looks full or empty.
+	* - The consumer end can't take items back, exchanging an item with the feeder returns it untouched.
+	* - Bulk exchanges refuse the queue as a feeder, since items their receiver refuses couldn't go back, so consumers pull items one by one.
+	* - Counts seen from the other thread are snapshots which may be outdated by the moment they're used.
+	*/
+	template<class BasicType>
+	class ConcurrentQueue final : public BeltInterface<BasicType>
+	{
+		// Public nested types.
+	public:
+		using ReferenceWrapper = BeltInterface<BasicType>::ReferenceWrapper;
+		using OptionalRefWrapper = BeltInterface<BasicType>::OptionalRefWrapper;
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
+
+		// Life circle.
+	public:
+		inline ConcurrentQueue(size_t capacity = 1u);
+
+		// Public virtual interface substitution.
+	public:
+		// BeltInterface::ExchangeFeederSlot
+		inline OptionalRefWrapper ExchangeFeederSlot(OptionalRefWrapper item = {}) override;
+
+		// BeltInterface::ExchangeReceiverSlot
+		inline OptionalRefWrapper ExchangeReceiverSlot(OptionalRefWrapper item = {}) override;
+
+		// BeltInterface::IsEmptySlot
+		inline bool IsEmptySlot(size_t offset = 0u) const override { return offset >= GetItemCount(); }
+
+		// BeltInterface::FindOccupiedSlot
+		inline std::optional<size_t> FindOccupiedSlot(size_t offset = 0u) const override;
+
+		// BeltInterface::FindEmptySlot
+		inline std::optional<size_t> FindEmptySlot(size_t offset = 0u) const override;
+
+		// BeltInterface::GetItemCount
+		inline size_t GetItemCount() const override;
+
+		// BeltInterface::GetSlotCount
+		inline size_t GetSlotCount() const override { return mCapacity; }
+
+		// BeltInterface::GetReceiverSlotOffset
+		inline size_t GetReceiverSlotOffset() const override { return mCapacity - 1u; }
+
+		// BeltInterface::CanReturnFeederItems
+		inline bool CanReturnFeederItems() const override { return false; }
+
+		// Inheritable virtual interface substitution.
+	protected:
+		// BeltInterface::VisitSlotRuns
+		inline void VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const override;
+
+		// Private constants.
+	private:
+		static constexpr size_t kCacheLineSize = 64u;
+
+		// Private state.
+	private:
+		// Consumer end.
+		alignas(kCacheLineSize) std::atomic<size_t> mHead{ 0u };
+		size_t mCachedTail = 0u;
+
+		// Producer end.
+		alignas(kCacheLineSize) std::atomic<size_t> mTail{ 0u };
+		size_t mCachedHead = 0u;
+
+		// Private properties.
+	private:
+		alignas(kCacheLineSize) const size_t mCapacity = 1u;
+		const size_t mMask = 0u;
+		std::vector<SlotPointer> mSlots;
+	};
+
+	template<class BasicType>
+	inline ConcurrentQueue<BasicType>::ConcurrentQueue(size_t capacity)
+		: mCapacity{ std::max(capacity, size_t{ 1 }) }
+		, mMask{ std::bit_ceil(mCapacity) - 1u }
+		, mSlots(mMask + 1u)
+	{
+	}
+
+	template<class BasicType>
+	inline ConcurrentQueue<BasicType>::OptionalRefWrapper ConcurrentQueue<BasicType>::ExchangeFeederSlot(OptionalRefWrapper item)
+	{
+		if (item.has_value())
+		{
+			return item;
+		}
+
+		const size_t head = mHead.load(std::memory_order_relaxed);
+		if (head == mCachedTail)
+		{
+			mCachedTail = mTail.load(std::memory_order_acquire);
+			if (head == mCachedTail)
+			{
+				return {};
+			}
+		}
+
+		const SlotPointer result = mSlots[head & mMask];
+		mHead.store(head + 1u, std::memory_order_release);
+
+		return BeltInterface<BasicType>::ToItem(result);
+	}
+
+	template<class BasicType>
+	inline ConcurrentQueue<BasicType>::OptionalRefWrapper ConcurrentQueue<BasicType>::ExchangeReceiverSlot(OptionalRefWrapper item)
+	{
+		if (!item.has_value())
+		{
+			return {};
+		}
+
+		const size_t tail = mTail.load(std::memory_order_relaxed);
+		if (tail - mCachedHead == mCapacity)
+		{
+			mCachedHead = mHead.load(std::memory_order_acquire);
+			if (tail - mCachedHead == mCapacity)
+			{
+				return item;
+			}
+		}
+
+		mSlots[tail & mMask] = BeltInterface<BasicType>::ToSlot(item);
+		mTail.store(tail + 1u, std::memory_order_release);
+
+		return {};
+	}
+
+	template<class BasicType>
+	inline std::optional<size_t> ConcurrentQueue<BasicType>::FindOccupiedSlot(size_t offset) const
+	{
+		const size_t count = GetItemCount();
+		if (count == 0u)
+		{
+			return {};
+		}
+
+		// Items are always packed at the feeder end.
+		offset %= mCapacity;
+		return offset < count ? 0u : mCapacity - offset;
+	}
+
+	template<class BasicType>
+	inline std::optional<size_t> ConcurrentQueue<BasicType>::FindEmptySlot(size_t offset) const
+	{
+		const size_t count = GetItemCount();
+		if (count == mCapacity)
+		{
+			return {};
+		}
+
+		offset %= mCapacity;
+		return offset < count ? count - offset : 0u;
+	}
+
+	template<class BasicType>
+	inline size_t ConcurrentQueue<BasicType>::GetItemCount() const
+	{
+		// Head is read first, so the tail can't be behind it.
+		const size_t head = mHead.load(std::memory_order_acquire);
+		const size_t tail = mTail.load(std::memory_order_acquire);
+
+		return std::min(tail - head, mCapacity);
+	}
+
+	template<class BasicType>
+	inline void ConcurrentQueue<BasicType>::VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const
+	{
+		const size_t head = mHead.load(std::memory_order_relaxed);
+		const size_t tail = mTail.load(std::memory_order_acquire);
+
+		const size_t frontIndex = head & mMask;
+		const size_t backIndex = frontIndex + (tail - head);
+		const size_t ringSize = mSlots.size();
+
+		callback(context, { mSlots.data() + frontIndex, std::min(backIndex, ringSize) - frontIndex });
+		if (backIndex > ringSize)
+		{
+			callback(context, { mSlots.data(), backIndex - ringSize });
+		}
+	}
+} // Vessel
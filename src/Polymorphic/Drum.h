@@ -2,26 +2,55 @@
 #pragma once
 
 #include "BeltInterface.h"
+#include "OccupancyBitmap.h"
 
-#include <numeric>
-#include <deque>
+#include "SlotStorage.h"
+#include "SlotTypeTags.h"
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <variant>
 
 namespace Vessel
 {
-	template<class BasicType>
+	/**
+	* Drum is a revolving belt, items stay in their slots while the feeder turns around them.
+	*
+	* Behaviour:
+	* - Capacity is set at runtime and slots are allocated on the heap by default.
+	* - With compile-time Capacity slots are stored inline, power of two capacities wrap indices with a mask.
+	* - With Tagger every slot keeps a byte tag of its item type, so items of a type are counted and found without touching items.
+	*
+	* Tagger requirements:
+	* - static constexpr size_t kTypeCount, count of item types.
+	* - TypeTag operator()(const BasicType&) const, returns tag below kTypeCount, called once per placed item.
+	*/
+	template<class BasicType, size_t Capacity = kDynamicCapacity, class Tagger = void>
 	class Drum final : public BeltInterface<BasicType>
 	{
 		// Public nested types.
 	public:
 		using ReferenceWrapper = BeltInterface<BasicType>::ReferenceWrapper;
 		using OptionalRefWrapper = BeltInterface<BasicType>::OptionalRefWrapper;
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
+
+		// Public constants.
+	public:
+		static constexpr bool kIsDynamic = Capacity == kDynamicCapacity;
+		static constexpr bool kIsTyped = !std::is_void_v<Tagger>;
 
 		// Life circle.
 	public:
-		inline Drum(size_t capacity = 1u, std::optional<size_t> receiverOffset = {});
+		inline Drum(size_t capacity = 1u, std::optional<size_t> receiverOffset = {}) requires (kIsDynamic);
+		inline explicit Drum(std::optional<size_t> receiverOffset = {}) requires (!kIsDynamic);
 
 		// Public virtual interface substitution.
 	public:
+		// BeltInterface::SetSlotItems
+		inline void SetSlotItems(std::vector<OptionalRefWrapper> slotItems) override;
+
 		// BeltInterface::ExchangeFeederSlot
 		inline OptionalRefWrapper ExchangeFeederSlot(OptionalRefWrapper item = {}) override;
 
@@ -34,6 +63,12 @@ namespace Vessel
 		// BeltInterface::IsEmptySlot
 		inline bool IsEmptySlot(size_t offset = 0u) const override;
 
+		// BeltInterface::FindOccupiedSlot
+		inline std::optional<size_t> FindOccupiedSlot(size_t offset = 0u) const override { return FindSlot(offset, true); }
+
+		// BeltInterface::FindEmptySlot
+		inline std::optional<size_t> FindEmptySlot(size_t offset = 0u) const override { return FindSlot(offset, false); }
+
 		// BeltInterface::GetItemCount
 		inline size_t GetItemCount() const override;
 
@@ -43,6 +78,34 @@ namespace Vessel
 		// BeltInterface::GetReceiverSlotOffset
 		inline size_t GetReceiverSlotOffset() const override { return mReceiverOffset; }
 
+		// BeltInterface::PullFeederItems
+		inline size_t PullFeederItems(std::span<SlotPointer> items) override;
+
+		// BeltInterface::PushReceiverItems
+		inline size_t PushReceiverItems(std::span<const SlotPointer> items) override;
+
+		// BeltInterface::ReturnFeederItems, the feeder turns back to the nearest free slots behind it.
+		inline size_t ReturnFeederItems(std::span<const SlotPointer> items) override;
+
+		// Public interface.
+	public:
+		// Get count of items of the type.
+		inline size_t GetTypeCount(TypeTag tag) const requires (kIsTyped);
+
+		// Get distance from the offset to the nearest slot with item of the type, wrapping around the belt.
+		inline std::optional<size_t> FindTypeSlot(TypeTag tag, size_t offset = 0u) const requires (kIsTyped);
+
+		// Inheritable virtual interface substitution.
+	protected:
+		// BeltInterface::VisitSlotRuns, slots in front of the feeder and then the wrapped part.
+		inline void VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const override;
+
+		// BeltInterface::GetSlotLayout
+		inline std::optional<typename BeltInterface<BasicType>::SlotLayout> GetSlotLayout() const override;
+
+		// BeltInterface::SetSlotLayout
+		inline bool SetSlotLayout(size_t feederIndex, std::span<const uint64_t> occupancyWords, std::span<const SlotPointer> items) override;
+
 		// Private interface.
 	private:
 		// Exchange the item with the certain slot of the belt.
@@ -51,30 +114,62 @@ namespace Vessel
 		// Translate index to cyclic buffer.
 		inline size_t TranslateIndex(size_t offset) const;
 
-		// Exchange the item with the certain slot of the belt.
-		inline std::vector<OptionalRefWrapper> GetSlotItems() const;
+		// Get distance from the offset to the nearest slot with the occupancy.
+		inline std::optional<size_t> FindSlot(size_t offset, bool occupied) const;
+
+		// Get end of the run of slots with the same occupancy which starts at the index, limited by the end of the buffer.
+		inline size_t FindRunEnd(size_t index, size_t limit) const;
+
+		// Count non-empty slots one by one to verify the maintained count in builds with VESSEL_CHECK_BELTS.
+		inline size_t CountItems() const;
+
+		// Retag items of slots in [begin, end).
+		inline void UpdateTypeTags(size_t begin, size_t end);
+
+		// Private nested types.
+	private:
+		using TypeTags = std::conditional_t<kIsTyped, SlotTypeTagsOf<Capacity, Tagger>, std::type_identity<std::monostate>>::type;
 
 		// Private state.
 	private:
 		size_t mIndex = 0u;
-		std::vector<OptionalRefWrapper> mCyclicBelt;
+		SlotStorage<SlotPointer, Capacity> mCyclicBelt{};
+		OccupancyBitmap<Capacity> mOccupancy;
+		TypeTags mTypeTags{};
 
 		// Private properties.
 	private:
 		const size_t mCapacity = 1u;
 		const size_t mReceiverOffset = mCapacity;
+
+		// CT checks.
+	private:
+		static_assert(Capacity > 0u, "Drum<T, N>: N must be greater than zero.");
 	};
 
-	template<class BasicType>
-	inline Drum<BasicType>::Drum(size_t capacity, std::optional<size_t> receiverOffset)
-		: mCapacity{ std::max(capacity, size_t{ 1 }) }
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline Drum<BasicType, Capacity, Tagger>::Drum(size_t capacity, std::optional<size_t> receiverOffset) requires (kIsDynamic)
+		: mOccupancy{ std::max(capacity, size_t{ 1 }) }
+		, mCapacity{ std::max(capacity, size_t{ 1 }) }
 		, mReceiverOffset{ std::min(receiverOffset.value_or(mCapacity - 1), mCapacity - 1) }
 	{
 		mCyclicBelt.resize(mCapacity);
+
+		if constexpr (kIsTyped)
+		{
+			mTypeTags = TypeTags{ mCapacity };
+		}
 	}
 
-	template<class BasicType>
-	inline Drum<BasicType>::OptionalRefWrapper Drum<BasicType>::ExchangeFeederSlot(OptionalRefWrapper item)
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline Drum<BasicType, Capacity, Tagger>::Drum(std::optional<size_t> receiverOffset) requires (!kIsDynamic)
+		: mCapacity{ Capacity }
+		, mReceiverOffset{ std::min(receiverOffset.value_or(Capacity - 1), Capacity - 1) }
+	{
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline Drum<BasicType, Capacity, Tagger>::OptionalRefWrapper Drum<BasicType, Capacity, Tagger>::ExchangeFeederSlot(OptionalRefWrapper item)
 	{
 		const bool pushEmpty = !item.has_value();
 		OptionalRefWrapper result = ExchangeSlotAtIndex(mIndex, item);
@@ -88,8 +183,8 @@ namespace Vessel
 		return result;
 	}
 
-	template<class BasicType>
-	inline Drum<BasicType>::OptionalRefWrapper Drum<BasicType>::ExchangeReceiverSlot(OptionalRefWrapper item)
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline Drum<BasicType, Capacity, Tagger>::OptionalRefWrapper Drum<BasicType, Capacity, Tagger>::ExchangeReceiverSlot(OptionalRefWrapper item)
 	{
 		const bool pushNonEmpty = item.has_value();
 		OptionalRefWrapper result = ExchangeSlotAtIndex(TranslateIndex(mReceiverOffset), item);
@@ -103,57 +198,230 @@ namespace Vessel
 		return result;
 	}
 
-	template<class BasicType>
-	inline void Drum<BasicType>::NextBeltSlot(size_t offset)
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline void Drum<BasicType, Capacity, Tagger>::NextBeltSlot(size_t offset)
 	{
 		mIndex = TranslateIndex(offset);
 	}
 
-	template<class BasicType>
-	inline bool Drum<BasicType>::IsEmptySlot(size_t offset) const
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline bool Drum<BasicType, Capacity, Tagger>::IsEmptySlot(size_t offset) const
 	{
-		return !mCyclicBelt[TranslateIndex(offset)].has_value();
+		return mCyclicBelt[TranslateIndex(offset)] == nullptr;
 	}
 
-	template<class BasicType>
-	inline size_t Drum<BasicType>::GetItemCount() const
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline void Drum<BasicType, Capacity, Tagger>::SetSlotItems(std::vector<OptionalRefWrapper> slotItems)
 	{
-		return std::accumulate(mCyclicBelt.cbegin(), mCyclicBelt.cend(), 0u, [](size_t sum, OptionalRefWrapper wrapper) -> size_t
+		mIndex = 0u;
+
+		for (size_t index = 0u; index < mCapacity; ++index)
+		{
+			ExchangeSlotAtIndex(index, index < slotItems.size() ? slotItems[index] : OptionalRefWrapper{});
+		}
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline size_t Drum<BasicType, Capacity, Tagger>::PullFeederItems(std::span<SlotPointer> items)
+	{
+		size_t pulledCount = 0u;
+		while (pulledCount < items.size())
+		{
+			const std::optional<size_t> runBegin = mOccupancy.FindNext(true, mIndex);
+			if (!runBegin.has_value())
 			{
-				if (!wrapper.has_value())
-				{
-					return sum;
-				}
+				break;
+			}
+
+			// The feeder turns over the whole run, just like after single pulls.
+			const size_t runEnd = FindRunEnd(runBegin.value(), runBegin.value() + items.size() - pulledCount);
+			std::copy(mCyclicBelt.begin() + runBegin.value(), mCyclicBelt.begin() + runEnd, items.begin() + pulledCount);
+			std::fill(mCyclicBelt.begin() + runBegin.value(), mCyclicBelt.begin() + runEnd, nullptr);
+			mOccupancy.SetRange(runBegin.value(), runEnd, false);
+			UpdateTypeTags(runBegin.value(), runEnd);
+
+			pulledCount += runEnd - runBegin.value();
+			mIndex = WrapSlotIndex<Capacity>(runEnd, mCapacity);
+		}
 
-				return sum + 1u;
-			});
+		return pulledCount;
 	}
 
-	template<class BasicType>
-	inline Drum<BasicType>::OptionalRefWrapper Drum<BasicType>::ExchangeSlotAtIndex(size_t index, Drum<BasicType>::OptionalRefWrapper item)
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline size_t Drum<BasicType, Capacity, Tagger>::PushReceiverItems(std::span<const SlotPointer> items)
 	{
-		item.swap(mCyclicBelt[index]);
+		size_t pushedCount = 0u;
+		while (pushedCount < items.size())
+		{
+			const std::optional<size_t> runBegin = mOccupancy.FindNext(false, TranslateIndex(mReceiverOffset));
+			if (!runBegin.has_value())
+			{
+				break;
+			}
 
-		return item;
+			// The receiver turns over the whole run, just like after single pushes.
+			const size_t runEnd = FindRunEnd(runBegin.value(), runBegin.value() + items.size() - pushedCount);
+			std::copy(items.begin() + pushedCount, items.begin() + pushedCount + (runEnd - runBegin.value()), mCyclicBelt.begin() + runBegin.value());
+			mOccupancy.SetRange(runBegin.value(), runEnd, true);
+			UpdateTypeTags(runBegin.value(), runEnd);
+
+			pushedCount += runEnd - runBegin.value();
+			mIndex = WrapSlotIndex<Capacity>(runEnd + mCapacity - mReceiverOffset, mCapacity);
+		}
+
+		return pushedCount;
 	}
 
-	template<class BasicType>
-	inline size_t Drum<BasicType>::TranslateIndex(size_t offset) const
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline size_t Drum<BasicType, Capacity, Tagger>::ReturnFeederItems(std::span<const SlotPointer> items)
 	{
-		return (mIndex + offset) % mCapacity;
+		size_t returnedCount = 0u;
+		for (; returnedCount < items.size() && mOccupancy.GetCount() < mCapacity; ++returnedCount)
+		{
+			// Slots just pulled are free again, so items take them back in order and gaps between runs are closed.
+			do
+			{
+				mIndex = TranslateIndex(mCapacity - 1u);
+			} while (mCyclicBelt[mIndex] != nullptr);
+
+			ExchangeSlotAtIndex(mIndex, BeltInterface<BasicType>::ToItem(items[items.size() - 1u - returnedCount]));
+		}
+
+		return returnedCount;
 	}
 
-	template<class BasicType>
-	inline std::vector<typename Drum<BasicType>::OptionalRefWrapper> Drum<BasicType>::GetSlotItems() const
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline size_t Drum<BasicType, Capacity, Tagger>::GetItemCount() const
 	{
-		std::vector<OptionalRefWrapper> result;
-		result.reserve(mCapacity);
+		if constexpr (kCheckBelts)
+		{
+			assert(mOccupancy.GetCount() == CountItems() && "Item count is out of sync with slots.");
+		}
 
-		for (size_t index = 0u; index < mCapacity; ++index)
+		return mOccupancy.GetCount();
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline size_t Drum<BasicType, Capacity, Tagger>::GetTypeCount(TypeTag tag) const requires (kIsTyped)
+	{
+		if constexpr (kCheckBelts)
 		{
-			result.emplace_back(mCyclicBelt[TranslateIndex(index)]);
+			assert(mTypeTags.GetCount(tag) == mTypeTags.CountTags(tag) && "Type count is out of sync with tags.");
 		}
 
-		return result;
+		return mTypeTags.GetCount(tag);
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline std::optional<size_t> Drum<BasicType, Capacity, Tagger>::FindTypeSlot(TypeTag tag, size_t offset) const requires (kIsTyped)
+	{
+		const size_t startIndex = TranslateIndex(offset);
+		const std::optional<size_t> foundIndex = mTypeTags.FindNext(tag, startIndex);
+		if (!foundIndex.has_value())
+		{
+			return {};
+		}
+
+		return WrapSlotIndex<Capacity>(foundIndex.value() + mCapacity - startIndex, mCapacity);
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline size_t Drum<BasicType, Capacity, Tagger>::FindRunEnd(size_t index, size_t limit) const
+	{
+		limit = std::min(limit, mCapacity);
+
+		// Slot with other occupancy before the index means the run goes up to the end of the buffer.
+		const std::optional<size_t> otherIndex = mOccupancy.FindNext(!mOccupancy.Test(index), index);
+		if (!otherIndex.has_value() || otherIndex.value() < index)
+		{
+			return limit;
+		}
+
+		return std::min(otherIndex.value(), limit);
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline size_t Drum<BasicType, Capacity, Tagger>::CountItems() const
+	{
+		return static_cast<size_t>(std::count_if(mCyclicBelt.cbegin(), mCyclicBelt.cend(), [](SlotPointer slot) { return slot != nullptr; }));
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline Drum<BasicType, Capacity, Tagger>::OptionalRefWrapper Drum<BasicType, Capacity, Tagger>::ExchangeSlotAtIndex(size_t index, Drum<BasicType, Capacity, Tagger>::OptionalRefWrapper item)
+	{
+		const SlotPointer result = std::exchange(mCyclicBelt[index], BeltInterface<BasicType>::ToSlot(item));
+		mOccupancy.Set(index, mCyclicBelt[index] != nullptr);
+		UpdateTypeTags(index, index + 1u);
+
+		return BeltInterface<BasicType>::ToItem(result);
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline void Drum<BasicType, Capacity, Tagger>::UpdateTypeTags(size_t begin, size_t end)
+	{
+		if constexpr (kIsTyped)
+		{
+			for (size_t index = begin; index < end; ++index)
+			{
+				const SlotPointer slot = mCyclicBelt[index];
+				mTypeTags.Set(index, slot != nullptr ? Tagger{}(*slot) : kFreeSlotTag);
+			}
+		}
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline size_t Drum<BasicType, Capacity, Tagger>::TranslateIndex(size_t offset) const
+	{
+		return WrapSlotIndex<Capacity>(mIndex + offset, mCapacity);
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline std::optional<size_t> Drum<BasicType, Capacity, Tagger>::FindSlot(size_t offset, bool occupied) const
+	{
+		const size_t startIndex = TranslateIndex(offset);
+		const std::optional<size_t> foundIndex = mOccupancy.FindNext(occupied, startIndex);
+		if (!foundIndex.has_value())
+		{
+			return {};
+		}
+
+		return WrapSlotIndex<Capacity>(foundIndex.value() + mCapacity - startIndex, mCapacity);
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline void Drum<BasicType, Capacity, Tagger>::VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const
+	{
+		const SlotPointer* slots = mCyclicBelt.data();
+
+		callback(context, { slots + mIndex, mCapacity - mIndex });
+		if (mIndex > 0u)
+		{
+			callback(context, { slots, mIndex });
+		}
+	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline std::optional<typename BeltInterface<BasicType>::SlotLayout> Drum<BasicType, Capacity, Tagger>::GetSlotLayout() const
+	{
+		return typename BeltInterface<BasicType>::SlotLayout{ { mCyclicBelt.data(), mCapacity }, mIndex };
 	}
+
+	template<class BasicType, size_t Capacity, class Tagger>
+	inline bool Drum<BasicType, Capacity, Tagger>::SetSlotLayout(size_t feederIndex, std::span<const uint64_t> occupancyWords, std::span<const SlotPointer> items)
+	{
+		mIndex = feederIndex;
+		std::fill(mCyclicBelt.begin(), mCyclicBelt.end(), nullptr);
+		mOccupancy.Assign(occupancyWords);
+		assert(mOccupancy.GetCount() == items.size() && "Count of items doesn't match the occupancy.");
+
+		size_t itemIndex = 0u;
+		mOccupancy.VisitOccupied([&](size_t index) { mCyclicBelt[index] = items[itemIndex++]; });
+		UpdateTypeTags(0u, mCapacity);
+
+		return true;
+	}
+
+	// Drum which keeps type tags of items given by the tagger.
+	template<class BasicType, class Tagger, size_t Capacity = kDynamicCapacity>
+	using TypedDrum = Drum<BasicType, Capacity, Tagger>;
 } // Vessel
\ No newline at end of file
@@ -0,0 +1,175 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Vessel
+{
+	/**
+	* InlineItem owns a value of BasicType or of any type derived from it, stored inside a fixed-size buffer.
+	*
+	* Requirements:
+	* - Stored type must fit into Size bytes and Align alignment and must be copyable and nothrow movable.
+	*
+	* Behaviour:
+	* - Value is kept inline next to a pointer to the table of its operations, nothing is allocated on the heap.
+	* - Polymorphic values keep their own virtual table, so virtual calls work as usual.
+	* - Empty item holds no value, like std::optional.
+	*/
+	template<class BasicType, size_t Size = 24u, size_t Align = alignof(void*)>
+	class InlineItem final
+	{
+		// Public constants.
+	public:
+		// Can the type be stored inline.
+		template<class ItemType>
+		static constexpr bool kFits = std::derived_from<ItemType, BasicType>
+			&& sizeof(ItemType) <= Size
+			&& alignof(ItemType) <= Align
+			&& std::is_copy_constructible_v<ItemType>
+			&& std::is_nothrow_move_constructible_v<ItemType>;
+
+		// Life circle.
+	public:
+		inline InlineItem() = default;
+		inline InlineItem(const InlineItem& other);
+		inline InlineItem(InlineItem&& other) noexcept;
+		inline ~InlineItem() { Reset(); }
+
+		template<class ItemType>
+		inline InlineItem(ItemType&& item) requires (kFits<std::remove_cvref_t<ItemType>>);
+
+		template<class ItemType, typename... Arguments>
+		inline explicit InlineItem(std::in_place_type_t<ItemType>, Arguments&&... arguments) requires (kFits<ItemType>);
+
+		inline InlineItem& operator=(const InlineItem& other);
+		inline InlineItem& operator=(InlineItem&& other) noexcept;
+
+		// Public interface.
+	public:
+		// Is here a value.
+		inline bool HasValue() const { return mOperations != nullptr; }
+		inline explicit operator bool() const { return HasValue(); }
+
+		// Get the value, null for empty items.
+		inline BasicType* Get() { return HasValue() ? mOperations->get(mStorage) : nullptr; }
+		inline const BasicType* Get() const { return HasValue() ? mOperations->get(const_cast<std::byte*>(mStorage)) : nullptr; }
+
+		inline BasicType& operator*() { return *Get(); }
+		inline const BasicType& operator*() const { return *Get(); }
+		inline BasicType* operator->() { return Get(); }
+		inline const BasicType* operator->() const { return Get(); }
+
+		// Destroy the value.
+		inline void Reset();
+
+		// Private nested types.
+	private:
+		struct Operations
+		{
+			BasicType* (*get)(std::byte* storage);
+			void (*copy)(std::byte* target, const std::byte* source);
+			void (*move)(std::byte* target, std::byte* source) noexcept;
+			void (*destroy)(std::byte* storage) noexcept;
+		};
+
+		// Private constants.
+	private:
+		template<class ItemType>
+		static constexpr Operations kOperations{
+			[](std::byte* storage) -> BasicType* { return std::launder(reinterpret_cast<ItemType*>(storage)); },
+			[](std::byte* target, const std::byte* source) { ::new (target) ItemType(*std::launder(reinterpret_cast<const ItemType*>(source))); },
+			[](std::byte* target, std::byte* source) noexcept {
+				ItemType* item = std::launder(reinterpret_cast<ItemType*>(source));
+				::new (target) ItemType(std::move(*item));
+				item->~ItemType();
+			},
+			[](std::byte* storage) noexcept { std::launder(reinterpret_cast<ItemType*>(storage))->~ItemType(); },
+		};
+
+		// Private state.
+	private:
+		alignas(Align) std::byte mStorage[Size];
+		const Operations* mOperations = nullptr;
+	};
+
+	template<class BasicType, size_t Size, size_t Align>
+	inline InlineItem<BasicType, Size, Align>::InlineItem(const InlineItem& other)
+	{
+		if (other.HasValue())
+		{
+			other.mOperations->copy(mStorage, other.mStorage);
+			mOperations = other.mOperations;
+		}
+	}
+
+	template<class BasicType, size_t Size, size_t Align>
+	inline InlineItem<BasicType, Size, Align>::InlineItem(InlineItem&& other) noexcept
+	{
+		if (other.HasValue())
+		{
+			other.mOperations->move(mStorage, other.mStorage);
+			mOperations = std::exchange(other.mOperations, nullptr);
+		}
+	}
+
+	template<class BasicType, size_t Size, size_t Align>
+	template<class ItemType>
+	inline InlineItem<BasicType, Size, Align>::InlineItem(ItemType&& item) requires (kFits<std::remove_cvref_t<ItemType>>)
+		: InlineItem(std::in_place_type<std::remove_cvref_t<ItemType>>, std::forward<ItemType>(item))
+	{
+	}
+
+	template<class BasicType, size_t Size, size_t Align>
+	template<class ItemType, typename... Arguments>
+	inline InlineItem<BasicType, Size, Align>::InlineItem(std::in_place_type_t<ItemType>, Arguments&&... arguments) requires (kFits<ItemType>)
+	{
+		::new (mStorage) ItemType(std::forward<Arguments>(arguments)...);
+		mOperations = &kOperations<ItemType>;
+	}
+
+	template<class BasicType, size_t Size, size_t Align>
+	inline InlineItem<BasicType, Size, Align>& InlineItem<BasicType, Size, Align>::operator=(const InlineItem& other)
+	{
+		if (this != &other)
+		{
+			Reset();
+			if (other.HasValue())
+			{
+				other.mOperations->copy(mStorage, other.mStorage);
+				mOperations = other.mOperations;
+			}
+		}
+
+		return *this;
+	}
+
+	template<class BasicType, size_t Size, size_t Align>
+	inline InlineItem<BasicType, Size, Align>& InlineItem<BasicType, Size, Align>::operator=(InlineItem&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			if (other.HasValue())
+			{
+				other.mOperations->move(mStorage, other.mStorage);
+				mOperations = std::exchange(other.mOperations, nullptr);
+			}
+		}
+
+		return *this;
+	}
+
+	template<class BasicType, size_t Size, size_t Align>
+	inline void InlineItem<BasicType, Size, Align>::Reset()
+	{
+		if (HasValue())
+		{
+			std::exchange(mOperations, nullptr)->destroy(mStorage);
+		}
+	}
+} // Vessel
@@ -0,0 +1,504 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "BeltInterface.h"
+#include "SlotTypeTags.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace Vessel
+{
+	// Policy of choosing belts of a junction for items.
+	enum class JunctionPolicy : uint8_t
+	{
+		// Belts take turns, belts which can't take part are skipped.
+		RoundRobin,
+
+		// Belts are used in the order they were added, the next one only when previous ones can't take part.
+		Priority,
+
+		// Belts with a type take part only with items of that type, the rest take turns as in RoundRobin.
+		Filter,
+	};
+
+	/**
+	* Splitter moves items from the feeder end of one belt to receiver ends of many belts.
+	*
+	* Requirements:
+	* - Belts are owned outside and must outlive the splitter.
+	* - Filter policy needs Tagger, see Drum for its requirements.
+	*
+	* Behaviour:
+	* - Every tick moves up to its rate of items, free slots of outputs are read once per tick.
+	* - Items are pulled from the input at once and pushed into every output at once.
+	* - Item which no output can take stops the splitter till the next tick, items behind it wait.
+	* - Outputs take turns only with items which really moved, so items in transit don't skip turns.
+	* - Items refused by outputs go back to the input, inputs which can't take them back, like concurrent queues, move nothing.
+	*/
+	template<class BasicType, class Tagger = void>
+	class Splitter final
+	{
+		// Public nested types.
+	public:
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
+		using OutputId = size_t;
+
+		// Public constants.
+	public:
+		static constexpr bool kIsTyped = !std::is_void_v<Tagger>;
+
+		// Life circle.
+	public:
+		inline explicit Splitter(BeltInterface<BasicType>& input, JunctionPolicy policy = JunctionPolicy::RoundRobin, size_t itemsPerTick = 1u);
+
+		// Public interface.
+	public:
+		// Add the output belt which takes items of any type.
+		inline OutputId AddOutput(BeltInterface<BasicType>& output) { return EmplaceOutput(output, kFreeSlotTag); }
+
+		// Add the output belt which takes only items of the type under filter policy.
+		inline OutputId AddOutput(BeltInterface<BasicType>& output, TypeTag typeTag) requires (kIsTyped) { return EmplaceOutput(output, typeTag); }
+
+		// Move items to outputs, returns count of moved items.
+		inline size_t Tick();
+
+		// Get count of outputs.
+		inline size_t GetOutputCount() const { return mOutputs.size(); }
+
+		// Private nested types.
+	private:
+		struct Output
+		{
+			BeltInterface<BasicType>* belt;
+
+			// Type of items the output takes, kFreeSlotTag for any type.
+			TypeTag typeTag;
+
+			// Free slots left for this tick.
+			size_t freeCount;
+
+			// Items to push on this tick, kept to reuse the buffer.
+			std::vector<SlotPointer> items;
+
+			// Items of this tick the output took, the rest go back to the input.
+			size_t pushedCount;
+		};
+
+		// Private interface.
+	private:
+		// Add the output belt with the type filter.
+		inline OutputId EmplaceOutput(BeltInterface<BasicType>& output, TypeTag typeTag);
+
+		// Choose the output for the item of the type and take its free slot, returns nothing if no output can take it.
+		inline std::optional<size_t> ChooseOutput(TypeTag typeTag);
+
+		// Plan outputs for items from the feeder end, returns count of planned items.
+		inline size_t Plan(size_t count);
+
+		// Private state.
+	private:
+		BeltInterface<BasicType>& mInput;
+		std::vector<Output> mOutputs;
+		size_t mNextOutput = 0u;
+
+		// Items of the tick and their outputs, kept to reuse buffers.
+		std::vector<SlotPointer> mItems;
+		std::vector<size_t> mDestinations;
+
+		// Private properties.
+	private:
+		const JunctionPolicy mPolicy;
+		const size_t mItemsPerTick;
+	};
+
+	/**
+	* Merger moves items from feeder ends of many belts to the receiver end of one belt.
+	*
+	* Requirements:
+	* - Belts are owned outside and must outlive the merger.
+	* - Filter policy needs Tagger, see Drum for its requirements.
+	*
+	* Behaviour:
+	* - Every tick moves up to its rate of items, free slots of the output are read once per tick.
+	* - Items are pulled from every input at once and pushed into the output at once in the order of turns.
+	* - Under filter policy an input with a type passes items of that type, an item of other type stops the input.
+	* - Inputs take turns only with items which really moved, so inputs which gave fewer items don't skip turns.
+	* - Items refused by the output go back to their inputs, inputs which can't take them back, like concurrent queues, are skipped.
+	*/
+	template<class BasicType, class Tagger = void>
+	class Merger final
+	{
+		// Public nested types.
+	public:
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
+		using InputId = size_t;
+
+		// Public constants.
+	public:
+		static constexpr bool kIsTyped = !std::is_void_v<Tagger>;
+
+		// Life circle.
+	public:
+		inline explicit Merger(BeltInterface<BasicType>& output, JunctionPolicy policy = JunctionPolicy::RoundRobin, size_t itemsPerTick = 1u);
+
+		// Public interface.
+	public:
+		// Add the input belt which passes items of any type.
+		inline InputId AddInput(BeltInterface<BasicType>& input) { return EmplaceInput(input, kFreeSlotTag); }
+
+		// Add the input belt which passes only items of the type under filter policy.
+		inline InputId AddInput(BeltInterface<BasicType>& input, TypeTag typeTag) requires (kIsTyped) { return EmplaceInput(input, typeTag); }
+
+		// Move items from inputs, returns count of moved items.
+		inline size_t Tick();
+
+		// Get count of inputs.
+		inline size_t GetInputCount() const { return mInputs.size(); }
+
+		// Private nested types.
+	private:
+		struct Input
+		{
+			BeltInterface<BasicType>* belt;
+
+			// Type of items the input passes, kFreeSlotTag for any type.
+			TypeTag typeTag;
+
+			// Items left to take on this tick.
+			size_t availableCount;
+
+			// Items pulled on this tick and count of them already merged, kept to reuse the buffer.
+			std::vector<SlotPointer> items;
+			size_t mergedCount;
+		};
+
+		// Private interface.
+	private:
+		// Add the input belt with the type filter.
+		inline InputId EmplaceInput(BeltInterface<BasicType>& input, TypeTag typeTag);
+
+		// Choose the input for the next item and take its item, returns nothing if all inputs are exhausted.
+		inline std::optional<size_t> ChooseInput();
+
+		// Count items the input can pass on this tick.
+		inline size_t CountAvailable(const Input& input, size_t limit) const;
+
+		// Private state.
+	private:
+		BeltInterface<BasicType>& mOutput;
+		std::vector<Input> mInputs;
+		size_t mNextInput = 0u;
+
+		// Merged items of the tick and their inputs, kept to reuse buffers.
+		std::vector<SlotPointer> mItems;
+		std::vector<size_t> mSources;
+
+		// Private properties.
+	private:
+		const JunctionPolicy mPolicy;
+		const size_t mItemsPerTick;
+	};
+
+	template<class BasicType, class Tagger>
+	inline Splitter<BasicType, Tagger>::Splitter(BeltInterface<BasicType>& input, JunctionPolicy policy, size_t itemsPerTick)
+		: mInput{ input }
+		, mPolicy{ policy }
+		, mItemsPerTick{ itemsPerTick }
+	{
+		assert((kIsTyped || policy != JunctionPolicy::Filter) && "Filter policy needs Tagger.");
+	}
+
+	template<class BasicType, class Tagger>
+	inline Splitter<BasicType, Tagger>::OutputId Splitter<BasicType, Tagger>::EmplaceOutput(BeltInterface<BasicType>& output, TypeTag typeTag)
+	{
+		mOutputs.push_back({ &output, typeTag, 0u, {}, 0u });
+
+		return mOutputs.size() - 1u;
+	}
+
+	template<class BasicType, class Tagger>
+	inline size_t Splitter<BasicType, Tagger>::Tick()
+	{
+		if (!mInput.CanReturnFeederItems())
+		{
+			return 0u;
+		}
+
+		for (Output& output : mOutputs)
+		{
+			output.freeCount = output.belt->GetReceivableCount();
+		}
+
+		// Turns are planned from the current output, but they are taken only by moved items.
+		const size_t firstOutput = mNextOutput;
+		const size_t plannedCount = Plan(std::min(mItemsPerTick, mInput.GetItemCount()));
+
+		// Belts with items in transit may give fewer items than planned, they are the front ones.
+		mItems.resize(plannedCount);
+		const size_t pulledCount = mInput.PullFeederItems(mItems);
+
+		for (size_t index = 0u; index < pulledCount; ++index)
+		{
+			mOutputs[mDestinations[index]].items.push_back(mItems[index]);
+		}
+
+		size_t movedCount = 0u;
+		for (Output& output : mOutputs)
+		{
+			output.pushedCount = output.belt->PushReceiverItems(output.items);
+			movedCount += output.pushedCount;
+			output.items.clear();
+		}
+
+		// Outputs refuse items within their receivable count only if they are filled meanwhile, refused ones are gathered in pull order.
+		mNextOutput = firstOutput;
+		size_t refusedCount = 0u;
+		for (size_t index = 0u; index < pulledCount; ++index)
+		{
+			const size_t destination = mDestinations[index];
+			Output& output = mOutputs[destination];
+
+			if (output.pushedCount > 0u)
+			{
+				--output.pushedCount;
+				mNextOutput = destination + 1u < mOutputs.size() ? destination + 1u : 0u;
+			}
+			else
+			{
+				mItems[refusedCount++] = mItems[index];
+			}
+		}
+
+		if (refusedCount > 0u)
+		{
+			[[maybe_unused]] const size_t returnedCount = mInput.ReturnFeederItems(std::span<const SlotPointer>{ mItems.data(), refusedCount });
+			assert(returnedCount == refusedCount && "Items put back to the input are lost.");
+		}
+
+		return movedCount;
+	}
+
+	template<class BasicType, class Tagger>
+	inline std::optional<size_t> Splitter<BasicType, Tagger>::ChooseOutput(TypeTag typeTag)
+	{
+		const size_t outputCount = mOutputs.size();
+		size_t index = mPolicy == JunctionPolicy::Priority ? 0u : mNextOutput;
+
+		for (size_t step = 0u; step < outputCount; ++step, index = index + 1u < outputCount ? index + 1u : 0u)
+		{
+			Output& output = mOutputs[index];
+
+			const bool isTypeMatched = mPolicy != JunctionPolicy::Filter || output.typeTag == kFreeSlotTag || output.typeTag == typeTag;
+			if (output.freeCount > 0u && isTypeMatched)
+			{
+				--output.freeCount;
+				mNextOutput = index + 1u < outputCount ? index + 1u : 0u;
+				return index;
+			}
+		}
+
+		return {};
+	}
+
+	template<class BasicType, class Tagger>
+	inline size_t Splitter<BasicType, Tagger>::Plan(size_t count)
+	{
+		mDestinations.clear();
+
+		if (mPolicy != JunctionPolicy::Filter)
+		{
+			while (mDestinations.size() < count)
+			{
+				const std::optional<size_t> destination = ChooseOutput(kFreeSlotTag);
+				if (!destination.has_value())
+				{
+					break;
+				}
+
+				mDestinations.push_back(destination.value());
+			}
+
+			return mDestinations.size();
+		}
+
+		// Outputs depend on item types, so items are looked up before they are pulled.
+		bool isBlocked = false;
+		mInput.VisitSlots([&](std::span<const SlotPointer> slots) {
+			for (size_t index = 0u; index < slots.size() && !isBlocked && mDestinations.size() < count; ++index)
+			{
+				if (slots[index] == nullptr)
+				{
+					continue;
+				}
+
+				TypeTag typeTag = kFreeSlotTag;
+				if constexpr (kIsTyped)
+				{
+					typeTag = Tagger{}(*slots[index]);
+				}
+
+				const std::optional<size_t> destination = ChooseOutput(typeTag);
+				isBlocked = !destination.has_value();
+				if (!isBlocked)
+				{
+					mDestinations.push_back(destination.value());
+				}
+			}
+			});
+
+		return mDestinations.size();
+	}
+
+	template<class BasicType, class Tagger>
+	inline Merger<BasicType, Tagger>::Merger(BeltInterface<BasicType>& output, JunctionPolicy policy, size_t itemsPerTick)
+		: mOutput{ output }
+		, mPolicy{ policy }
+		, mItemsPerTick{ itemsPerTick }
+	{
+		assert((kIsTyped || policy != JunctionPolicy::Filter) && "Filter policy needs Tagger.");
+	}
+
+	template<class BasicType, class Tagger>
+	inline Merger<BasicType, Tagger>::InputId Merger<BasicType, Tagger>::EmplaceInput(BeltInterface<BasicType>& input, TypeTag typeTag)
+	{
+		mInputs.push_back({ &input, typeTag, 0u, {}, 0u });
+
+		return mInputs.size() - 1u;
+	}
+
+	template<class BasicType, class Tagger>
+	inline size_t Merger<BasicType, Tagger>::Tick()
+	{
+		const size_t count = std::min(mItemsPerTick, mOutput.GetReceivableCount());
+
+		for (Input& input : mInputs)
+		{
+			input.availableCount = input.belt->CanReturnFeederItems() ? CountAvailable(input, count) : 0u;
+			input.items.clear();
+			input.mergedCount = 0u;
+		}
+
+		// Plan turns first, then every input gives all its items at once, turns are taken only by moved items.
+		const size_t firstInput = mNextInput;
+		mSources.clear();
+		while (mSources.size() < count)
+		{
+			const std::optional<size_t> source = ChooseInput();
+			if (!source.has_value())
+			{
+				break;
+			}
+
+			mSources.push_back(source.value());
+			++mInputs[source.value()].mergedCount;
+		}
+
+		for (Input& input : mInputs)
+		{
+			input.items.resize(input.mergedCount);
+			input.items.resize(input.belt->PullFeederItems(input.items));
+			input.mergedCount = 0u;
+		}
+
+		// Inputs which gave fewer items than planned skip their late turns.
+		mItems.clear();
+		size_t mergedCount = 0u;
+		for (size_t source : mSources)
+		{
+			Input& input = mInputs[source];
+			if (input.mergedCount < input.items.size())
+			{
+				mItems.push_back(input.items[input.mergedCount++]);
+				mSources[mergedCount++] = source;
+			}
+		}
+
+		const size_t pushedCount = mOutput.PushReceiverItems(mItems);
+
+		// Output refuses items within its receivable count only if it's filled meanwhile, refused ones go back to their inputs in pull order.
+		if (pushedCount < mItems.size())
+		{
+			for (Input& input : mInputs)
+			{
+				input.items.clear();
+			}
+
+			for (size_t index = pushedCount; index < mItems.size(); ++index)
+			{
+				mInputs[mSources[index]].items.push_back(mItems[index]);
+			}
+
+			for (Input& input : mInputs)
+			{
+				[[maybe_unused]] const size_t returnedCount = input.belt->ReturnFeederItems(input.items);
+				assert(returnedCount == input.items.size() && "Items put back to the input are lost.");
+			}
+		}
+
+		mNextInput = firstInput;
+		if (pushedCount > 0u)
+		{
+			const size_t lastSource = mSources[pushedCount - 1u];
+			mNextInput = lastSource + 1u < mInputs.size() ? lastSource + 1u : 0u;
+		}
+
+		return pushedCount;
+	}
+
+	template<class BasicType, class Tagger>
+	inline std::optional<size_t> Merger<BasicType, Tagger>::ChooseInput()
+	{
+		const size_t inputCount = mInputs.size();
+		size_t index = mPolicy == JunctionPolicy::Priority ? 0u : mNextInput;
+
+		for (size_t step = 0u; step < inputCount; ++step, index = index + 1u < inputCount ? index + 1u : 0u)
+		{
+			Input& input = mInputs[index];
+
+			if (input.availableCount > 0u)
+			{
+				--input.availableCount;
+				mNextInput = index + 1u < inputCount ? index + 1u : 0u;
+				return index;
+			}
+		}
+
+		return {};
+	}
+
+	template<class BasicType, class Tagger>
+	inline size_t Merger<BasicType, Tagger>::CountAvailable(const Input& input, size_t limit) const
+	{
+		if (mPolicy != JunctionPolicy::Filter || input.typeTag == kFreeSlotTag)
+		{
+			return std::min(input.belt->GetItemCount(), limit);
+		}
+
+		// Leading items of the type pass, the first item of other type stops the input.
+		size_t count = 0u;
+		bool isBlocked = false;
+		input.belt->VisitSlots([&](std::span<const SlotPointer> slots) {
+			for (size_t index = 0u; index < slots.size() && !isBlocked && count < limit; ++index)
+			{
+				if (slots[index] == nullptr)
+				{
+					continue;
+				}
+
+				if constexpr (kIsTyped)
+				{
+					isBlocked = Tagger{}(*slots[index]) != input.typeTag;
+				}
+
+				count += isBlocked ? 0u : 1u;
+			}
+			});
+
+		return count;
+	}
+} // Vessel
@@ -0,0 +1,190 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "SlotStorage.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace Vessel
+{
+	/**
+	* OccupancyBitmap keeps one bit per belt slot, so the nearest occupied or free slot is found a word at a time.
+	* Count of occupied slots is maintained on every change.
+	* Words are stored inline when count of slots is known at compile time.
+	*/
+	template<size_t Size = kDynamicCapacity>
+	class OccupancyBitmap final
+	{
+		// Public nested types.
+	public:
+		using Word = uint64_t;
+
+		// Life circle.
+	public:
+		inline explicit OccupancyBitmap(size_t size = Size == kDynamicCapacity ? 0u : Size);
+
+		// Public interface.
+	public:
+		// Mark the slot as occupied or free.
+		inline void Set(size_t index, bool occupied);
+
+		// Mark slots in [begin, end) as occupied or free, a word at a time.
+		inline void SetRange(size_t begin, size_t end, bool occupied);
+
+		// Mark all slots as free.
+		inline void Reset();
+
+		// Replace all bits with the words, bits behind the last slot are dropped.
+		inline void Assign(std::span<const Word> words);
+
+		// Get words of the bitmap.
+		inline std::span<const Word> GetWords() const { return { mWords.data(), mWords.size() }; }
+
+		// Is the slot occupied.
+		inline bool Test(size_t index) const { return (mWords[index / kWordBits] >> (index % kWordBits)) & Word{ 1 }; }
+
+		// Find the first occupied or free slot at or after the index, wrapping around the end.
+		inline std::optional<size_t> FindNext(bool occupied, size_t index) const;
+
+		// Call the visitor with index of every occupied slot in ascending order.
+		template<typename Visitor>
+		inline void VisitOccupied(Visitor&& visitor) const;
+
+		// Get count of slots.
+		inline size_t GetSize() const { return mSize; }
+
+		// Get count of occupied slots.
+		inline size_t GetCount() const { return mCount; }
+
+		// Private interface.
+	private:
+		// Get mask of bits which belong to slots in the word.
+		inline Word GetValidMask(size_t wordIndex) const;
+
+		// Private constants.
+	private:
+		static constexpr size_t kWordBits = sizeof(Word) * 8u;
+		static constexpr size_t kWordCount = Size == kDynamicCapacity ? kDynamicCapacity : (Size + kWordBits - 1u) / kWordBits;
+
+		// Private state.
+	private:
+		SlotStorage<Word, kWordCount> mWords{};
+		size_t mSize = 0u;
+		size_t mCount = 0u;
+	};
+
+	template<size_t Size>
+	inline OccupancyBitmap<Size>::OccupancyBitmap(size_t size)
+		: mSize{ size }
+	{
+		if constexpr (Size == kDynamicCapacity)
+		{
+			mWords.resize((size + kWordBits - 1u) / kWordBits, Word{ 0 });
+		}
+	}
+
+	template<size_t Size>
+	inline void OccupancyBitmap<Size>::Set(size_t index, bool occupied)
+	{
+		const Word bit = Word{ 1 } << (index % kWordBits);
+		Word& word = mWords[index / kWordBits];
+
+		const bool wasOccupied = (word & bit) != Word{ 0 };
+		mCount = mCount + occupied - wasOccupied;
+
+		word = occupied ? (word | bit) : (word & ~bit);
+	}
+
+	template<size_t Size>
+	inline void OccupancyBitmap<Size>::SetRange(size_t begin, size_t end, bool occupied)
+	{
+		for (size_t index = begin; index < end;)
+		{
+			const size_t bitIndex = index % kWordBits;
+			const size_t bitCount = std::min(kWordBits - bitIndex, end - index);
+			const Word mask = (bitCount == kWordBits ? ~Word{ 0 } : (Word{ 1 } << bitCount) - 1u) << bitIndex;
+			Word& word = mWords[index / kWordBits];
+
+			const size_t wasCount = static_cast<size_t>(std::popcount(word & mask));
+			mCount = mCount - wasCount + (occupied ? bitCount : 0u);
+
+			word = occupied ? (word | mask) : (word & ~mask);
+			index += bitCount;
+		}
+	}
+
+	template<size_t Size>
+	inline void OccupancyBitmap<Size>::Reset()
+	{
+		std::fill(mWords.begin(), mWords.end(), Word{ 0 });
+		mCount = 0u;
+	}
+
+	template<size_t Size>
+	inline void OccupancyBitmap<Size>::Assign(std::span<const Word> words)
+	{
+		mCount = 0u;
+		for (size_t wordIndex = 0u; wordIndex < mWords.size(); ++wordIndex)
+		{
+			mWords[wordIndex] = wordIndex < words.size() ? words[wordIndex] & GetValidMask(wordIndex) : Word{ 0 };
+			mCount += static_cast<size_t>(std::popcount(mWords[wordIndex]));
+		}
+	}
+
+	template<size_t Size>
+	inline std::optional<size_t> OccupancyBitmap<Size>::FindNext(bool occupied, size_t index) const
+	{
+		if (mSize == 0u)
+		{
+			return {};
+		}
+
+		const size_t wordCount = mWords.size();
+		size_t wordIndex = index / kWordBits;
+		Word mask = ~Word{ 0 } << (index % kWordBits);
+
+		// One extra step revisits the bits before the index in the first word.
+		for (size_t step = 0u; step <= wordCount; ++step)
+		{
+			const Word word = (occupied ? mWords[wordIndex] : ~mWords[wordIndex]) & mask & GetValidMask(wordIndex);
+			if (word != Word{ 0 })
+			{
+				return wordIndex * kWordBits + static_cast<size_t>(std::countr_zero(word));
+			}
+
+			wordIndex = (wordIndex + 1u) % wordCount;
+			mask = ~Word{ 0 };
+		}
+
+		return {};
+	}
+
+	template<size_t Size>
+	template<typename Visitor>
+	inline void OccupancyBitmap<Size>::VisitOccupied(Visitor&& visitor) const
+	{
+		for (size_t wordIndex = 0u; wordIndex < mWords.size(); ++wordIndex)
+		{
+			for (Word word = mWords[wordIndex]; word != Word{ 0 }; word &= word - 1u)
+			{
+				visitor(wordIndex * kWordBits + static_cast<size_t>(std::countr_zero(word)));
+			}
+		}
+	}
+
+	template<size_t Size>
+	inline OccupancyBitmap<Size>::Word OccupancyBitmap<Size>::GetValidMask(size_t wordIndex) const
+	{
+		const size_t tailBits = mSize % kWordBits;
+		if (wordIndex + 1u < mWords.size() || tailBits == 0u)
+		{
+			return ~Word{ 0 };
+		}
+
+		return (Word{ 1 } << tailBits) - 1u;
+	}
+} // Vessel
@@ -0,0 +1,224 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "InlineItem.h"
+#include "OccupancyBitmap.h"
+#include "SlotStorage.h"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace Vessel
+{
+	/**
+	* OwningDrum is a revolving belt which owns its items, every slot stores the item by value.
+	*
+	* Behaviour:
+	* - Slots are InlineItem values, so scans of items stay within the slot array without chasing pointers.
+	* - Turns and exchanges work as in Drum, items are moved in and out of slots instead of referenced.
+	* - Capacity is set at runtime and slots are allocated on the heap by default.
+	* - With compile-time Capacity slots are stored inline, power of two capacities wrap indices with a mask.
+	*/
+	template<class BasicType, size_t Capacity = kDynamicCapacity, size_t ItemSize = 24u>
+	class OwningDrum final
+	{
+		// Public nested types.
+	public:
+		using Item = InlineItem<BasicType, ItemSize>;
+
+		// Public constants.
+	public:
+		static constexpr bool kIsDynamic = Capacity == kDynamicCapacity;
+
+		// Life circle.
+	public:
+		inline OwningDrum(size_t capacity = 1u, std::optional<size_t> receiverOffset = {}) requires (kIsDynamic);
+		inline explicit OwningDrum(std::optional<size_t> receiverOffset = {}) requires (!kIsDynamic);
+
+		// Public interface.
+	public:
+		// Exchange the item with the feeder slot of the belt.
+		inline Item ExchangeFeederSlot(Item item = {});
+
+		// Exchange the item with the receiver slot of the belt.
+		inline Item ExchangeReceiverSlot(Item item = {});
+
+		// Turn to the nearest item and take it, returns empty item if the drum is empty.
+		inline Item PullItem();
+
+		// Turn to the nearest free slot and put the item there, returns the item back if the drum is full.
+		inline Item PushItem(Item item);
+
+		// Move the belt to next slot.
+		inline void NextBeltSlot(size_t offset = 1u);
+
+		// Is here free slot on belt end.
+		inline bool IsEmptySlot(size_t offset = 0u) const { return !mOccupancy.Test(TranslateIndex(offset)); }
+
+		// Get distance from the offset to the nearest occupied slot, wrapping around the belt.
+		inline std::optional<size_t> FindOccupiedSlot(size_t offset = 0u) const { return FindSlot(offset, true); }
+
+		// Get distance from the offset to the nearest free slot, wrapping around the belt.
+		inline std::optional<size_t> FindEmptySlot(size_t offset = 0u) const { return FindSlot(offset, false); }
+
+		// Get the item of the slot, null for free slots.
+		inline const BasicType* GetSlotItem(size_t offset = 0u) const { return mSlots[TranslateIndex(offset)].Get(); }
+
+		// Call the visitor with every item in order from the feeder end.
+		template<typename Visitor>
+		inline void VisitItems(Visitor&& visitor) const;
+
+		// Get non-empty items count.
+		inline size_t GetItemCount() const { return mOccupancy.GetCount(); }
+
+		// Get slot capacity count.
+		inline size_t GetSlotCount() const { return mCapacity; }
+
+		// Get receiver slot offset for feeder.
+		inline size_t GetReceiverSlotOffset() const { return mReceiverOffset; }
+
+		// Private interface.
+	private:
+		// Exchange the item with the certain slot of the belt.
+		inline Item ExchangeSlotAtIndex(size_t index, Item item);
+
+		// Translate index to cyclic buffer.
+		inline size_t TranslateIndex(size_t offset) const { return WrapSlotIndex<Capacity>(mIndex + offset, mCapacity); }
+
+		// Get distance from the offset to the nearest slot with the occupancy.
+		inline std::optional<size_t> FindSlot(size_t offset, bool occupied) const;
+
+		// Private state.
+	private:
+		size_t mIndex = 0u;
+		SlotStorage<Item, Capacity> mSlots{};
+		OccupancyBitmap<Capacity> mOccupancy;
+
+		// Private properties.
+	private:
+		const size_t mCapacity = 1u;
+		const size_t mReceiverOffset = mCapacity;
+
+		// CT checks.
+	private:
+		static_assert(Capacity > 0u, "OwningDrum<T, N>: N must be greater than zero.");
+	};
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	inline OwningDrum<BasicType, Capacity, ItemSize>::OwningDrum(size_t capacity, std::optional<size_t> receiverOffset) requires (kIsDynamic)
+		: mOccupancy{ std::max(capacity, size_t{ 1 }) }
+		, mCapacity{ std::max(capacity, size_t{ 1 }) }
+		, mReceiverOffset{ std::min(receiverOffset.value_or(mCapacity - 1), mCapacity - 1) }
+	{
+		mSlots.resize(mCapacity);
+	}
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	inline OwningDrum<BasicType, Capacity, ItemSize>::OwningDrum(std::optional<size_t> receiverOffset) requires (!kIsDynamic)
+		: mCapacity{ Capacity }
+		, mReceiverOffset{ std::min(receiverOffset.value_or(Capacity - 1), Capacity - 1) }
+	{
+	}
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	inline OwningDrum<BasicType, Capacity, ItemSize>::Item OwningDrum<BasicType, Capacity, ItemSize>::ExchangeFeederSlot(Item item)
+	{
+		const bool pushEmpty = !item.HasValue();
+		Item result = ExchangeSlotAtIndex(mIndex, std::move(item));
+
+		if (result.HasValue() && pushEmpty)
+		{
+			NextBeltSlot();
+		}
+
+		return result;
+	}
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	inline OwningDrum<BasicType, Capacity, ItemSize>::Item OwningDrum<BasicType, Capacity, ItemSize>::ExchangeReceiverSlot(Item item)
+	{
+		const bool pushNonEmpty = item.HasValue();
+		Item result = ExchangeSlotAtIndex(TranslateIndex(mReceiverOffset), std::move(item));
+
+		if (!result.HasValue() && pushNonEmpty)
+		{
+			NextBeltSlot();
+		}
+
+		return result;
+	}
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	inline OwningDrum<BasicType, Capacity, ItemSize>::Item OwningDrum<BasicType, Capacity, ItemSize>::PullItem()
+	{
+		const std::optional<size_t> distance = FindOccupiedSlot();
+		if (!distance.has_value())
+		{
+			return {};
+		}
+
+		NextBeltSlot(distance.value());
+		return ExchangeFeederSlot();
+	}
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	inline OwningDrum<BasicType, Capacity, ItemSize>::Item OwningDrum<BasicType, Capacity, ItemSize>::PushItem(Item item)
+	{
+		const std::optional<size_t> distance = FindEmptySlot(mReceiverOffset);
+		if (!distance.has_value() || !item.HasValue())
+		{
+			return item;
+		}
+
+		NextBeltSlot(distance.value());
+		return ExchangeReceiverSlot(std::move(item));
+	}
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	inline void OwningDrum<BasicType, Capacity, ItemSize>::NextBeltSlot(size_t offset)
+	{
+		mIndex = TranslateIndex(offset);
+	}
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	template<typename Visitor>
+	inline void OwningDrum<BasicType, Capacity, ItemSize>::VisitItems(Visitor&& visitor) const
+	{
+		// Slots in front of the feeder and then the wrapped part, items lay right in the slots.
+		auto visitSlots = [&](size_t begin, size_t end) {
+			for (size_t index = begin; index < end; ++index)
+			{
+				if (mSlots[index].HasValue())
+				{
+					visitor(*mSlots[index]);
+				}
+			}
+			};
+
+		visitSlots(mIndex, mCapacity);
+		visitSlots(0u, mIndex);
+	}
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	inline OwningDrum<BasicType, Capacity, ItemSize>::Item OwningDrum<BasicType, Capacity, ItemSize>::ExchangeSlotAtIndex(size_t index, Item item)
+	{
+		Item result = std::exchange(mSlots[index], std::move(item));
+		mOccupancy.Set(index, mSlots[index].HasValue());
+
+		return result;
+	}
+
+	template<class BasicType, size_t Capacity, size_t ItemSize>
+	inline std::optional<size_t> OwningDrum<BasicType, Capacity, ItemSize>::FindSlot(size_t offset, bool occupied) const
+	{
+		const size_t startIndex = TranslateIndex(offset);
+		const std::optional<size_t> foundIndex = mOccupancy.FindNext(occupied, startIndex);
+		if (!foundIndex.has_value())
+		{
+			return {};
+		}
+
+		return WrapSlotIndex<Capacity>(foundIndex.value() + mCapacity - startIndex, mCapacity);
+	}
+} // Vessel
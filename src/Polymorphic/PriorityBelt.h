@@ -0,0 +1,358 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "BeltInterface.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Vessel
+{
+	/**
+	* PriorityBelt is a belt which always feeds its highest priority item first.
+	*
+	* Requirements:
+	* - Compare is a strict weak order of items, like for std::priority_queue, the item no other item is greater than goes first.
+	*
+	* Behaviour:
+	* - Items are kept in a d-ary heap of compact slots, Arity children of a node lay next to each other.
+	* - Push and pull cost O(log n) comparisons.
+	* - Items of equal priority are fed in the order they were pushed, items pushed back to the feeder end go in front of them.
+	* - Slots are visited and saved in the order the feeder would take items, sorted once after every change.
+	* - Receiver end only takes items in, items can't be taken back from it.
+	*/
+	template<class BasicType, class Compare = std::less<BasicType>, size_t Arity = 4u>
+	class PriorityBelt final : public BeltInterface<BasicType>
+	{
+		// Public nested types.
+	public:
+		using ReferenceWrapper = BeltInterface<BasicType>::ReferenceWrapper;
+		using OptionalRefWrapper = BeltInterface<BasicType>::OptionalRefWrapper;
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
+
+		// Life circle.
+	public:
+		inline PriorityBelt(size_t capacity = 1u, Compare compare = {});
+
+		// Public virtual interface substitution.
+	public:
+		// BeltInterface::SetSlotItems
+		inline void SetSlotItems(std::vector<OptionalRefWrapper> slotItems) override;
+
+		// BeltInterface::ExchangeFeederSlot
+		inline OptionalRefWrapper ExchangeFeederSlot(OptionalRefWrapper item = {}) override;
+
+		// BeltInterface::ExchangeReceiverSlot
+		inline OptionalRefWrapper ExchangeReceiverSlot(OptionalRefWrapper item = {}) override;
+
+		// BeltInterface::IsEmptySlot
+		inline bool IsEmptySlot(size_t offset = 0u) const override { return offset % mCapacity >= mHeap.size(); }
+
+		// BeltInterface::FindOccupiedSlot
+		inline std::optional<size_t> FindOccupiedSlot(size_t offset = 0u) const override;
+
+		// BeltInterface::FindEmptySlot
+		inline std::optional<size_t> FindEmptySlot(size_t offset = 0u) const override;
+
+		// BeltInterface::GetItemCount
+		inline size_t GetItemCount() const override { return mHeap.size(); }
+
+		// BeltInterface::GetSlotCount
+		inline size_t GetSlotCount() const override { return mCapacity; }
+
+		// BeltInterface::GetReceiverSlotOffset
+		inline size_t GetReceiverSlotOffset() const override { return mCapacity - 1u; }
+
+		// BeltInterface::PullFeederItems
+		inline size_t PullFeederItems(std::span<SlotPointer> items) override;
+
+		// BeltInterface::PushReceiverItems
+		inline size_t PushReceiverItems(std::span<const SlotPointer> items) override;
+
+		// Public interface.
+	public:
+		// Get the item the feeder takes next, null for empty belts.
+		inline SlotPointer GetTopItem() const { return mHeap.empty() ? nullptr : mHeap.front().item; }
+
+		// Inheritable virtual interface substitution.
+	protected:
+		// BeltInterface::VisitSlotRuns, items are sorted in feeder order by the first visit after a change.
+		inline void VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const override;
+
+		// Private nested types.
+	private:
+		// Heap node, order breaks ties of equal priority.
+		struct Entry
+		{
+			SlotPointer item;
+			uint64_t order;
+		};
+
+		// Private interface.
+	private:
+		// Does the left entry go to the feeder before the right one.
+		inline bool IsBefore(const Entry& left, const Entry& right) const;
+
+		// Add the entry and restore the heap.
+		inline void Push(Entry entry);
+
+		// Take the top entry and restore the heap.
+		inline SlotPointer Pop();
+
+		// Move the entry at the index up to its place.
+		inline void SiftUp(size_t index);
+
+		// Move the entry at the index down to its place.
+		inline void SiftDown(size_t index);
+
+		// Private constants.
+	private:
+		// Orders of items pushed to the receiver end grow up from the middle, orders of items pushed back to the feeder end grow down.
+		static constexpr uint64_t kMiddleOrder = uint64_t{ 1 } << 63u;
+
+		// Private state.
+	private:
+		std::vector<Entry> mHeap;
+		uint64_t mBackOrder = kMiddleOrder;
+		uint64_t mFrontOrder = kMiddleOrder;
+
+		// Items in feeder order shared by visits till the next change, concurrent visits sort them once under the lock.
+		mutable std::vector<Entry> mOrderedEntries;
+		mutable std::vector<SlotPointer> mOrderedItems;
+		mutable std::mutex mOrderMutex;
+		mutable bool mIsOrdered = false;
+
+		// Private properties.
+	private:
+		[[no_unique_address]] Compare mCompare;
+		const size_t mCapacity = 1u;
+
+		// CT checks.
+	private:
+		static_assert(Arity >= 2u, "PriorityBelt<T, C, D>: D must be at least two.");
+	};
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline PriorityBelt<BasicType, Compare, Arity>::PriorityBelt(size_t capacity, Compare compare)
+		: mCompare{ std::move(compare) }
+		, mCapacity{ std::max(capacity, size_t{ 1 }) }
+	{
+		mHeap.reserve(mCapacity);
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline void PriorityBelt<BasicType, Compare, Arity>::SetSlotItems(std::vector<OptionalRefWrapper> slotItems)
+	{
+		mHeap.clear();
+		mIsOrdered = false;
+		mBackOrder = kMiddleOrder;
+		mFrontOrder = kMiddleOrder;
+
+		// Items of equal priority keep the order they are given in.
+		for (const OptionalRefWrapper& item : slotItems)
+		{
+			if (item.has_value() && mHeap.size() < mCapacity)
+			{
+				mHeap.push_back({ BeltInterface<BasicType>::ToSlot(item), mBackOrder++ });
+			}
+		}
+
+		// Heap is built bottom up, leaves sift nowhere.
+		for (size_t index = mHeap.size(); index > 0u; --index)
+		{
+			SiftDown(index - 1u);
+		}
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline PriorityBelt<BasicType, Compare, Arity>::OptionalRefWrapper PriorityBelt<BasicType, Compare, Arity>::ExchangeFeederSlot(OptionalRefWrapper item)
+	{
+		if (!item.has_value())
+		{
+			return mHeap.empty() ? OptionalRefWrapper{} : BeltInterface<BasicType>::ToItem(Pop());
+		}
+
+		if (mHeap.size() < mCapacity)
+		{
+			Push({ BeltInterface<BasicType>::ToSlot(item), --mFrontOrder });
+			return {};
+		}
+
+		// Full belt gives its top item away for the new one.
+		mIsOrdered = false;
+		const SlotPointer result = mHeap.front().item;
+		mHeap.front() = { BeltInterface<BasicType>::ToSlot(item), --mFrontOrder };
+		SiftDown(0u);
+
+		return BeltInterface<BasicType>::ToItem(result);
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline PriorityBelt<BasicType, Compare, Arity>::OptionalRefWrapper PriorityBelt<BasicType, Compare, Arity>::ExchangeReceiverSlot(OptionalRefWrapper item)
+	{
+		if (!item.has_value() || mHeap.size() == mCapacity)
+		{
+			return item;
+		}
+
+		Push({ BeltInterface<BasicType>::ToSlot(item), mBackOrder++ });
+		return {};
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline std::optional<size_t> PriorityBelt<BasicType, Compare, Arity>::FindOccupiedSlot(size_t offset) const
+	{
+		if (mHeap.empty())
+		{
+			return {};
+		}
+
+		offset %= mCapacity;
+		return offset < mHeap.size() ? 0u : mCapacity - offset;
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline std::optional<size_t> PriorityBelt<BasicType, Compare, Arity>::FindEmptySlot(size_t offset) const
+	{
+		if (mHeap.size() == mCapacity)
+		{
+			return {};
+		}
+
+		offset %= mCapacity;
+		return offset >= mHeap.size() ? 0u : mHeap.size() - offset;
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline size_t PriorityBelt<BasicType, Compare, Arity>::PullFeederItems(std::span<SlotPointer> items)
+	{
+		const size_t pulledCount = std::min(items.size(), mHeap.size());
+		for (size_t index = 0u; index < pulledCount; ++index)
+		{
+			items[index] = Pop();
+		}
+
+		return pulledCount;
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline size_t PriorityBelt<BasicType, Compare, Arity>::PushReceiverItems(std::span<const SlotPointer> items)
+	{
+		const size_t pushedCount = std::min(items.size(), mCapacity - mHeap.size());
+		for (size_t index = 0u; index < pushedCount; ++index)
+		{
+			Push({ items[index], mBackOrder++ });
+		}
+
+		return pushedCount;
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline void PriorityBelt<BasicType, Compare, Arity>::VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const
+	{
+		// Visits of the unchanged belt reuse the order, so they neither sort nor copy.
+		{
+			std::lock_guard lock{ mOrderMutex };
+			if (!mIsOrdered)
+			{
+				mOrderedEntries.assign(mHeap.cbegin(), mHeap.cend());
+				std::sort(mOrderedEntries.begin(), mOrderedEntries.end(), [this](const Entry& left, const Entry& right) { return IsBefore(left, right); });
+
+				mOrderedItems.resize(mOrderedEntries.size());
+				std::transform(mOrderedEntries.cbegin(), mOrderedEntries.cend(), mOrderedItems.begin(), [](const Entry& entry) { return entry.item; });
+				mIsOrdered = true;
+			}
+		}
+
+		callback(context, { mOrderedItems.data(), mOrderedItems.size() });
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline bool PriorityBelt<BasicType, Compare, Arity>::IsBefore(const Entry& left, const Entry& right) const
+	{
+		if (mCompare(*right.item, *left.item))
+		{
+			return true;
+		}
+
+		return !mCompare(*left.item, *right.item) && left.order < right.order;
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline void PriorityBelt<BasicType, Compare, Arity>::Push(Entry entry)
+	{
+		mIsOrdered = false;
+		mHeap.push_back(entry);
+		SiftUp(mHeap.size() - 1u);
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline PriorityBelt<BasicType, Compare, Arity>::SlotPointer PriorityBelt<BasicType, Compare, Arity>::Pop()
+	{
+		mIsOrdered = false;
+		const SlotPointer result = mHeap.front().item;
+		mHeap.front() = mHeap.back();
+		mHeap.pop_back();
+
+		if (!mHeap.empty())
+		{
+			SiftDown(0u);
+		}
+
+		return result;
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline void PriorityBelt<BasicType, Compare, Arity>::SiftUp(size_t index)
+	{
+		const Entry entry = mHeap[index];
+		while (index > 0u)
+		{
+			const size_t parentIndex = (index - 1u) / Arity;
+			if (!IsBefore(entry, mHeap[parentIndex]))
+			{
+				break;
+			}
+
+			mHeap[index] = mHeap[parentIndex];
+			index = parentIndex;
+		}
+
+		mHeap[index] = entry;
+	}
+
+	template<class BasicType, class Compare, size_t Arity>
+	inline void PriorityBelt<BasicType, Compare, Arity>::SiftDown(size_t index)
+	{
+		const Entry entry = mHeap[index];
+		const size_t size = mHeap.size();
+
+		for (size_t firstIndex = index * Arity + 1u; firstIndex < size; firstIndex = index * Arity + 1u)
+		{
+			// Children lay next to each other, so the best one is found within a cache line or two.
+			size_t bestIndex = firstIndex;
+			const size_t lastIndex = std::min(firstIndex + Arity, size);
+			for (size_t childIndex = firstIndex + 1u; childIndex < lastIndex; ++childIndex)
+			{
+				if (IsBefore(mHeap[childIndex], mHeap[bestIndex]))
+				{
+					bestIndex = childIndex;
+				}
+			}
+
+			if (!IsBefore(mHeap[bestIndex], entry))
+			{
+				break;
+			}
+
+			mHeap[index] = mHeap[bestIndex];
+			index = bestIndex;
+		}
+
+		mHeap[index] = entry;
+	}
+} // Vessel
@@ -2,36 +2,65 @@
 #pragma once
 
 #include "BeltInterface.h"
+#include "OccupancyBitmap.h"
 
-#include <numeric>
-#include <deque>
-#include <ranges>
+#include "SlotStorage.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
 
 namespace Vessel
 {
-	template<class BasicType>
+	/**
+	* Queue is a belt where items are packed from the feeder end and pushed from both ends.
+	*
+	* Behaviour:
+	* - Slots form a ring buffer, the front of the queue moves around it.
+	* - Capacity is set at runtime and slots are allocated on the heap by default.
+	* - With compile-time Capacity slots are stored inline, power of two capacities wrap indices with a mask.
+	*/
+	template<class BasicType, size_t Capacity = kDynamicCapacity>
 	class Queue final : public BeltInterface<BasicType>
 	{
 		// Public nested types.
 	public:
 		using ReferenceWrapper = BeltInterface<BasicType>::ReferenceWrapper;
 		using OptionalRefWrapper = BeltInterface<BasicType>::OptionalRefWrapper;
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
+
+		// Public constants.
+	public:
+		static constexpr bool kIsDynamic = Capacity == kDynamicCapacity;
 
 		// Life circle.
 	public:
-		inline Queue(size_t capacity = 1u);
+		inline Queue(size_t capacity = 1u) requires (kIsDynamic);
+		inline Queue() requires (!kIsDynamic);
 
 		// Public virtual interface substitution.
 	public:
+		// BeltInterface::SetSlotItems
+		inline void SetSlotItems(std::vector<OptionalRefWrapper> slotItems) override;
+
 		// BeltInterface::ExchangeFeederSlot
 		inline OptionalRefWrapper ExchangeFeederSlot(OptionalRefWrapper item = {}) override;
 
 		// BeltInterface::ExchangeReceiverSlot
 		inline OptionalRefWrapper ExchangeReceiverSlot(OptionalRefWrapper item = {}) override;
 
+		// BeltInterface::NextBeltSlot, the queue can't turn, so it only drops free slots in front of the feeder.
+		inline void NextBeltSlot(size_t offset = 1u) override;
+
 		// BeltInterface::IsEmptySlot
 		inline bool IsEmptySlot(size_t offset = 0u) const override;
 
+		// BeltInterface::FindOccupiedSlot
+		inline std::optional<size_t> FindOccupiedSlot(size_t offset = 0u) const override { return FindSlot(offset, true); }
+
+		// BeltInterface::FindEmptySlot
+		inline std::optional<size_t> FindEmptySlot(size_t offset = 0u) const override { return FindSlot(offset, false); }
+
 		// BeltInterface::GetItemCount
 		inline size_t GetItemCount() const override;
 
@@ -41,89 +70,298 @@ namespace Vessel
 		// BeltInterface::GetReceiverSlotOffset
 		inline size_t GetReceiverSlotOffset() const override { return mCapacity - 1; }
 
-		// BeltInterface::GetSlotItems
-		inline std::vector<OptionalRefWrapper> GetSlotItems() const override;
+		// BeltInterface::GetReceivableCount, free slots between items can't be reached by the receiver end.
+		inline size_t GetReceivableCount() const override;
+
+		// BeltInterface::PullFeederItems
+		inline size_t PullFeederItems(std::span<SlotPointer> items) override;
+
+		// BeltInterface::PushReceiverItems
+		inline size_t PushReceiverItems(std::span<const SlotPointer> items) override;
+
+		// BeltInterface::ReturnFeederItems, items take slots in front of the first one while the queue isn't full.
+		inline size_t ReturnFeederItems(std::span<const SlotPointer> items) override;
+
+		// Inheritable virtual interface substitution.
+	protected:
+		// BeltInterface::VisitSlotRuns, slots of the queue up to the end of the ring and then the wrapped part.
+		inline void VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const override;
+
+		// BeltInterface::GetSlotLayout
+		inline std::optional<typename BeltInterface<BasicType>::SlotLayout> GetSlotLayout() const override;
+
+		// BeltInterface::SetSlotLayout
+		inline bool SetSlotLayout(size_t feederIndex, std::span<const uint64_t> occupancyWords, std::span<const SlotPointer> items) override;
+
+		// Private interface.
+	private:
+		// Translate queue offset to the ring slot.
+		inline size_t TranslateIndex(size_t offset) const { return WrapSlotIndex<Capacity>(mFrontIndex + offset, mCapacity); }
+
+		// Access slot at the queue offset.
+		inline SlotPointer& GetSlot(size_t offset) { return mRing[TranslateIndex(offset)]; }
+		inline SlotPointer GetSlot(size_t offset) const { return mRing[TranslateIndex(offset)]; }
+
+		// Get distance from the offset to the nearest slot with the occupancy.
+		inline std::optional<size_t> FindSlot(size_t offset, bool occupied) const;
+
+		// Count non-empty slots one by one to verify the maintained count in builds with VESSEL_CHECK_BELTS.
+		inline size_t CountItems() const;
 
 		// Private state.
 	private:
-		std::deque<OptionalRefWrapper> mBelt;
+		SlotStorage<SlotPointer, Capacity> mRing{};
+		OccupancyBitmap<Capacity> mOccupancy;
+		size_t mFrontIndex = 0u;
+		size_t mSize = 0u;
 
 		// Private properties.
 	private:
 		const size_t mCapacity = 1u;
+
+		// CT checks.
+	private:
+		static_assert(Capacity > 0u, "Queue<T, N>: N must be greater than zero.");
 	};
 
-	template<class BasicType>
-	inline Queue<BasicType>::Queue(size_t capacity)
-		: mCapacity{ capacity }
+	template<class BasicType, size_t Capacity>
+	inline Queue<BasicType, Capacity>::Queue(size_t capacity) requires (kIsDynamic)
+		: mOccupancy{ std::max(capacity, size_t{ 1 }) }
+		, mCapacity{ std::max(capacity, size_t{ 1 }) }
+	{
+		mRing.resize(mCapacity);
+	}
+
+	template<class BasicType, size_t Capacity>
+	inline Queue<BasicType, Capacity>::Queue() requires (!kIsDynamic)
+		: mCapacity{ Capacity }
 	{
 	}
 
-	template<class BasicType>
-	inline Queue<BasicType>::OptionalRefWrapper Queue<BasicType>::ExchangeFeederSlot(OptionalRefWrapper item)
+	template<class BasicType, size_t Capacity>
+	inline Queue<BasicType, Capacity>::OptionalRefWrapper Queue<BasicType, Capacity>::ExchangeFeederSlot(OptionalRefWrapper item)
 	{
-		const bool hasFreeSlots = mBelt.size() < mCapacity;
+		const bool hasFreeSlots = mSize < mCapacity;
 		if (item.has_value() && hasFreeSlots)
 		{
-			mBelt.push_front(item);
+			mFrontIndex = TranslateIndex(mCapacity - 1u);
+			mRing[mFrontIndex] = BeltInterface<BasicType>::ToSlot(item);
+			mOccupancy.Set(mFrontIndex, true);
+			++mSize;
 			return {};
 		}
 
-		mBelt.front().swap(item);
+		const SlotPointer result = std::exchange(mRing[mFrontIndex], BeltInterface<BasicType>::ToSlot(item));
+		mOccupancy.Set(mFrontIndex, mRing[mFrontIndex] != nullptr);
 
-		if (!mBelt.front().has_value())
+		if (mSize > 0u && mRing[mFrontIndex] == nullptr)
 		{
-			mBelt.pop_front();
+			mFrontIndex = TranslateIndex(1u);
+			--mSize;
 		}
 
-		return item;
+		return BeltInterface<BasicType>::ToItem(result);
 	}
 
-	template<class BasicType>
-	inline Queue<BasicType>::OptionalRefWrapper Queue<BasicType>::ExchangeReceiverSlot(OptionalRefWrapper item)
+	template<class BasicType, size_t Capacity>
+	inline Queue<BasicType, Capacity>::OptionalRefWrapper Queue<BasicType, Capacity>::ExchangeReceiverSlot(OptionalRefWrapper item)
 	{
-		const bool hasFreeSlots = mBelt.size() < mCapacity;
+		const bool hasFreeSlots = mSize < mCapacity;
 		if (item.has_value() && hasFreeSlots)
 		{
-			mBelt.push_back(item);
+			GetSlot(mSize) = BeltInterface<BasicType>::ToSlot(item);
+			mOccupancy.Set(TranslateIndex(mSize), true);
+			++mSize;
 			return {};
 		}
 
-		mBelt.back().swap(item);
+		if (mSize == 0u)
+		{
+			return item;
+		}
+
+		const SlotPointer result = std::exchange(GetSlot(mSize - 1u), BeltInterface<BasicType>::ToSlot(item));
+		mOccupancy.Set(TranslateIndex(mSize - 1u), GetSlot(mSize - 1u) != nullptr);
 
-		return item;
+		return BeltInterface<BasicType>::ToItem(result);
 	}
 
-	template<class BasicType>
-	inline bool Queue<BasicType>::IsEmptySlot(size_t offset) const
+	template<class BasicType, size_t Capacity>
+	inline void Queue<BasicType, Capacity>::NextBeltSlot(size_t offset)
 	{
-		return !mBelt[offset % mCapacity].has_value();
+		for (; offset > 0u && mSize > 0u && mRing[mFrontIndex] == nullptr; --offset)
+		{
+			mFrontIndex = TranslateIndex(1u);
+			--mSize;
+		}
 	}
 
-	template<class BasicType>
-	inline size_t Queue<BasicType>::GetItemCount() const
+	template<class BasicType, size_t Capacity>
+	inline bool Queue<BasicType, Capacity>::IsEmptySlot(size_t offset) const
 	{
-		return std::accumulate(mBelt.cbegin(), mBelt.cend(), 0u, [](size_t sum, OptionalRefWrapper wrapper) -> size_t
-			{
-				if (!wrapper.has_value())
-				{
-					return sum;
-				}
+		return !mOccupancy.Test(TranslateIndex(offset));
+	}
 
-				return sum + 1u;
-			});
+	template<class BasicType, size_t Capacity>
+	inline void Queue<BasicType, Capacity>::SetSlotItems(std::vector<OptionalRefWrapper> slotItems)
+	{
+		std::fill(mRing.begin(), mRing.end(), nullptr);
+		mOccupancy.Reset();
+		mFrontIndex = 0u;
+
+		// Free slots behind the last item are not a part of the queue.
+		size_t size = std::min(slotItems.size(), mCapacity);
+		while (size > 0u && !slotItems[size - 1u].has_value())
+		{
+			--size;
+		}
+
+		for (size_t index = 0u; index < size; ++index)
+		{
+			mRing[index] = BeltInterface<BasicType>::ToSlot(slotItems[index]);
+			mOccupancy.Set(index, slotItems[index].has_value());
+		}
+
+		mSize = size;
 	}
 
-	template<class BasicType>
-	inline std::vector<typename Queue<BasicType>::OptionalRefWrapper> Queue<BasicType>::GetSlotItems() const
+	template<class BasicType, size_t Capacity>
+	inline size_t Queue<BasicType, Capacity>::PullFeederItems(std::span<SlotPointer> items)
 	{
-		std::vector<OptionalRefWrapper> result(mCapacity);
+		size_t pulledCount = 0u;
+		while (pulledCount < items.size() && mOccupancy.GetCount() > 0u)
+		{
+			// Free slots in front of the first item are dropped, just like before single pulls.
+			const size_t runBegin = mOccupancy.FindNext(true, mFrontIndex).value();
+			mSize -= WrapSlotIndex<Capacity>(runBegin + mCapacity - mFrontIndex, mCapacity);
+
+			// Take the run of items up to the first free slot or the end of the ring.
+			const std::optional<size_t> freeIndex = mOccupancy.FindNext(false, runBegin);
+			const size_t freeEnd = freeIndex.has_value() && freeIndex.value() > runBegin ? freeIndex.value() : mCapacity;
+			const size_t runEnd = std::min({ freeEnd, runBegin + mSize, runBegin + items.size() - pulledCount });
+
+			std::copy(mRing.begin() + runBegin, mRing.begin() + runEnd, items.begin() + pulledCount);
+			std::fill(mRing.begin() + runBegin, mRing.begin() + runEnd, nullptr);
+			mOccupancy.SetRange(runBegin, runEnd, false);
+
+			pulledCount += runEnd - runBegin;
+			mSize -= runEnd - runBegin;
+			mFrontIndex = WrapSlotIndex<Capacity>(runEnd, mCapacity);
+		}
+
+		return pulledCount;
+	}
 
-		for (size_t index = 0u; index < mBelt.size(); ++index)
+	template<class BasicType, size_t Capacity>
+	inline size_t Queue<BasicType, Capacity>::PushReceiverItems(std::span<const SlotPointer> items)
+	{
+		size_t pushedCount = 0u;
+		while (pushedCount < items.size() && mSize < mCapacity)
+		{
+			// Append the run behind the last slot up to the end of the ring.
+			const size_t runBegin = TranslateIndex(mSize);
+			const size_t runEnd = runBegin + std::min({ items.size() - pushedCount, mCapacity - mSize, mCapacity - runBegin });
+
+			std::copy(items.begin() + pushedCount, items.begin() + pushedCount + (runEnd - runBegin), mRing.begin() + runBegin);
+			mOccupancy.SetRange(runBegin, runEnd, true);
+
+			pushedCount += runEnd - runBegin;
+			mSize += runEnd - runBegin;
+		}
+
+		// Full queue may still have free slots inside, those are reached item by item.
+		return pushedCount + BeltInterface<BasicType>::PushReceiverItems(items.subspan(pushedCount));
+	}
+
+	template<class BasicType, size_t Capacity>
+	inline size_t Queue<BasicType, Capacity>::ReturnFeederItems(std::span<const SlotPointer> items)
+	{
+		size_t returnedCount = 0u;
+		for (; returnedCount < items.size() && mSize < mCapacity; ++returnedCount)
+		{
+			mFrontIndex = TranslateIndex(mCapacity - 1u);
+			mRing[mFrontIndex] = items[items.size() - 1u - returnedCount];
+			mOccupancy.Set(mFrontIndex, true);
+			++mSize;
+		}
+
+		return returnedCount;
+	}
+
+	template<class BasicType, size_t Capacity>
+	inline size_t Queue<BasicType, Capacity>::GetItemCount() const
+	{
+		if constexpr (kCheckBelts)
+		{
+			assert(mOccupancy.GetCount() == CountItems() && "Item count is out of sync with slots.");
+		}
+
+		return mOccupancy.GetCount();
+	}
+
+	template<class BasicType, size_t Capacity>
+	inline size_t Queue<BasicType, Capacity>::GetReceivableCount() const
+	{
+		// Pushes into the full queue drop free slots in front of the first item, just like pulls do.
+		const size_t frontFreeCount = mOccupancy.GetCount() > 0u ? FindSlot(0u, true).value() : mSize;
+
+		return mCapacity - mSize + frontFreeCount;
+	}
+
+	template<class BasicType, size_t Capacity>
+	inline size_t Queue<BasicType, Capacity>::CountItems() const
+	{
+		return static_cast<size_t>(std::count_if(mRing.cbegin(), mRing.cend(), [](SlotPointer slot) { return slot != nullptr; }));
+	}
+
+	template<class BasicType, size_t Capacity>
+	inline std::optional<size_t> Queue<BasicType, Capacity>::FindSlot(size_t offset, bool occupied) const
+	{
+		const size_t startIndex = TranslateIndex(offset);
+		const std::optional<size_t> foundIndex = mOccupancy.FindNext(occupied, startIndex);
+		if (!foundIndex.has_value())
+		{
+			return {};
+		}
+
+		return WrapSlotIndex<Capacity>(foundIndex.value() + mCapacity - startIndex, mCapacity);
+	}
+
+	template<class BasicType, size_t Capacity>
+	inline void Queue<BasicType, Capacity>::VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const
+	{
+		const SlotPointer* slots = mRing.data();
+		const size_t backIndex = mFrontIndex + mSize;
+
+		callback(context, { slots + mFrontIndex, std::min(backIndex, mCapacity) - mFrontIndex });
+		if (backIndex > mCapacity)
 		{
-			result[index] = mBelt[index];
+			callback(context, { slots, backIndex - mCapacity });
 		}
+	}
+
+	template<class BasicType, size_t Capacity>
+	inline std::optional<typename BeltInterface<BasicType>::SlotLayout> Queue<BasicType, Capacity>::GetSlotLayout() const
+	{
+		return typename BeltInterface<BasicType>::SlotLayout{ { mRing.data(), mCapacity }, mFrontIndex };
+	}
+
+	template<class BasicType, size_t Capacity>
+	inline bool Queue<BasicType, Capacity>::SetSlotLayout(size_t feederIndex, std::span<const uint64_t> occupancyWords, std::span<const SlotPointer> items)
+	{
+		mFrontIndex = feederIndex;
+		std::fill(mRing.begin(), mRing.end(), nullptr);
+		mOccupancy.Assign(occupancyWords);
+		assert(mOccupancy.GetCount() == items.size() && "Count of items doesn't match the occupancy.");
+
+		// Free slots behind the last item are not a part of the queue.
+		size_t itemIndex = 0u;
+		mSize = 0u;
+		mOccupancy.VisitOccupied([&](size_t index) {
+			mRing[index] = items[itemIndex++];
+			mSize = std::max(mSize, WrapSlotIndex<Capacity>(index + mCapacity - mFrontIndex, mCapacity) + 1u);
+			});
 
-		return result;
+		return true;
 	}
 } // Vessel
\ No newline at end of file
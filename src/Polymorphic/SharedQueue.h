@@ -0,0 +1,252 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "BeltInterface.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+namespace Vessel
+{
+	/**
+	* SharedQueue is a bounded lock-free belt which any count of producer and consumer threads may share.
+	*
+	* Behaviour:
+	* - Every slot carries a sequence number which tells whose turn it is, producers and consumers claim positions with one CAS.
+	* - Capacity is rounded up to a power of two.
+	* - The consumer end can't take items back, exchanging an item with the feeder returns it untouched.
+	* - Bulk exchanges refuse the queue as a feeder, since items their receiver refuses couldn't go back, so consumers pull items one by one.
+	* - Counts and slot items are snapshots, they're exact only while no thread is exchanging items.
+	*/
+	template<class BasicType>
+	class SharedQueue final : public BeltInterface<BasicType>
+	{
+		// Public nested types.
+	public:
+		using ReferenceWrapper = BeltInterface<BasicType>::ReferenceWrapper;
+		using OptionalRefWrapper = BeltInterface<BasicType>::OptionalRefWrapper;
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
+
+		// Life circle.
+	public:
+		inline SharedQueue(size_t capacity = 1u);
+
+		// Public virtual interface substitution.
+	public:
+		// BeltInterface::ExchangeFeederSlot
+		inline OptionalRefWrapper ExchangeFeederSlot(OptionalRefWrapper item = {}) override;
+
+		// BeltInterface::ExchangeReceiverSlot
+		inline OptionalRefWrapper ExchangeReceiverSlot(OptionalRefWrapper item = {}) override;
+
+		// BeltInterface::IsEmptySlot
+		inline bool IsEmptySlot(size_t offset = 0u) const override { return offset >= GetItemCount(); }
+
+		// BeltInterface::FindOccupiedSlot
+		inline std::optional<size_t> FindOccupiedSlot(size_t offset = 0u) const override;
+
+		// BeltInterface::FindEmptySlot
+		inline std::optional<size_t> FindEmptySlot(size_t offset = 0u) const override;
+
+		// BeltInterface::GetItemCount
+		inline size_t GetItemCount() const override;
+
+		// BeltInterface::GetSlotCount
+		inline size_t GetSlotCount() const override { return mCapacity; }
+
+		// BeltInterface::GetReceiverSlotOffset
+		inline size_t GetReceiverSlotOffset() const override { return mCapacity - 1u; }
+
+		// BeltInterface::CanReturnFeederItems
+		inline bool CanReturnFeederItems() const override { return false; }
+
+		// Inheritable virtual interface substitution.
+	protected:
+		// BeltInterface::VisitSlotRuns, cells are atomic, so runs are snapshots taken into a small buffer on the stack.
+		inline void VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const override;
+
+		// Private nested types.
+	private:
+		struct Cell
+		{
+			// Position which may use the cell next, equals to position when free and to position + 1 when occupied.
+			std::atomic<size_t> sequence;
+			std::atomic<SlotPointer> item;
+		};
+
+		// Private constants.
+	private:
+		static constexpr size_t kCacheLineSize = 64u;
+		static constexpr size_t kSnapshotSize = 64u;
+
+		// Private state.
+	private:
+		alignas(kCacheLineSize) std::atomic<size_t> mEnqueuePosition{ 0u };
+		alignas(kCacheLineSize) std::atomic<size_t> mDequeuePosition{ 0u };
+
+		// Private properties.
+	private:
+		alignas(kCacheLineSize) const size_t mCapacity = 1u;
+		const size_t mMask = 0u;
+		std::unique_ptr<Cell[]> mCells;
+	};
+
+	template<class BasicType>
+	inline SharedQueue<BasicType>::SharedQueue(size_t capacity)
+		: mCapacity{ std::bit_ceil(std::max(capacity, size_t{ 1 })) }
+		, mMask{ mCapacity - 1u }
+		, mCells{ std::make_unique<Cell[]>(mCapacity) }
+	{
+		for (size_t index = 0u; index < mCapacity; ++index)
+		{
+			mCells[index].sequence.store(index, std::memory_order_relaxed);
+			mCells[index].item.store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	template<class BasicType>
+	inline SharedQueue<BasicType>::OptionalRefWrapper SharedQueue<BasicType>::ExchangeFeederSlot(OptionalRefWrapper item)
+	{
+		if (item.has_value())
+		{
+			return item;
+		}
+
+		size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+		Cell* cell = nullptr;
+
+		while (true)
+		{
+			cell = &mCells[position & mMask];
+			const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1u);
+
+			if (difference == 0)
+			{
+				if (mDequeuePosition.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				return {};
+			}
+			else
+			{
+				position = mDequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		const SlotPointer result = cell->item.load(std::memory_order_relaxed);
+		cell->sequence.store(position + mCapacity, std::memory_order_release);
+
+		return BeltInterface<BasicType>::ToItem(result);
+	}
+
+	template<class BasicType>
+	inline SharedQueue<BasicType>::OptionalRefWrapper SharedQueue<BasicType>::ExchangeReceiverSlot(OptionalRefWrapper item)
+	{
+		if (!item.has_value())
+		{
+			return {};
+		}
+
+		size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+		Cell* cell = nullptr;
+
+		while (true)
+		{
+			cell = &mCells[position & mMask];
+			const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+			if (difference == 0)
+			{
+				if (mEnqueuePosition.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (difference < 0)
+			{
+				return item;
+			}
+			else
+			{
+				position = mEnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->item.store(BeltInterface<BasicType>::ToSlot(item), std::memory_order_relaxed);
+		cell->sequence.store(position + 1u, std::memory_order_release);
+
+		return {};
+	}
+
+	template<class BasicType>
+	inline std::optional<size_t> SharedQueue<BasicType>::FindOccupiedSlot(size_t offset) const
+	{
+		const size_t count = GetItemCount();
+		if (count == 0u)
+		{
+			return {};
+		}
+
+		// Items are always packed at the feeder end.
+		offset &= mMask;
+		return offset < count ? 0u : mCapacity - offset;
+	}
+
+	template<class BasicType>
+	inline std::optional<size_t> SharedQueue<BasicType>::FindEmptySlot(size_t offset) const
+	{
+		const size_t count = GetItemCount();
+		if (count == mCapacity)
+		{
+			return {};
+		}
+
+		offset &= mMask;
+		return offset < count ? count - offset : 0u;
+	}
+
+	template<class BasicType>
+	inline size_t SharedQueue<BasicType>::GetItemCount() const
+	{
+		// Dequeue position is read first, so the enqueue position can't be behind it.
+		const size_t dequeuePosition = mDequeuePosition.load(std::memory_order_acquire);
+		const size_t enqueuePosition = mEnqueuePosition.load(std::memory_order_acquire);
+
+		return std::min(enqueuePosition - dequeuePosition, mCapacity);
+	}
+
+	template<class BasicType>
+	inline void SharedQueue<BasicType>::VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const
+	{
+		std::array<SlotPointer, kSnapshotSize> snapshot;
+
+		const size_t dequeuePosition = mDequeuePosition.load(std::memory_order_acquire);
+		const size_t count = GetItemCount();
+
+		for (size_t runIndex = 0u; runIndex < count; runIndex += kSnapshotSize)
+		{
+			const size_t runSize = std::min(count - runIndex, kSnapshotSize);
+			for (size_t index = 0u; index < runSize; ++index)
+			{
+				const size_t position = dequeuePosition + runIndex + index;
+				const Cell& cell = mCells[position & mMask];
+
+				// Cells which are being written or were already taken look free.
+				const bool isReady = cell.sequence.load(std::memory_order_acquire) == position + 1u;
+				snapshot[index] = isReady ? cell.item.load(std::memory_order_relaxed) : nullptr;
+			}
+
+			callback(context, { snapshot.data(), runSize });
+		}
+	}
+} // Vessel
@@ -0,0 +1,37 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace Vessel
+{
+	// Capacity of belts which is known only at runtime.
+	inline constexpr size_t kDynamicCapacity = std::numeric_limits<size_t>::max();
+
+	// Storage of belt slots, inline when capacity is known at compile time.
+	template<typename Slot, size_t Capacity>
+	using SlotStorage = std::conditional_t<Capacity == kDynamicCapacity, std::vector<Slot>, std::array<Slot, Capacity>>;
+
+	// Wrap index around belt capacity, masked when capacity is a power of two known at compile time.
+	template<size_t Capacity>
+	inline constexpr size_t WrapSlotIndex(size_t index, size_t capacity)
+	{
+		if constexpr (Capacity == kDynamicCapacity)
+		{
+			return index % capacity;
+		}
+		else if constexpr (std::has_single_bit(Capacity))
+		{
+			return index & (Capacity - 1u);
+		}
+		else
+		{
+			return index % Capacity;
+		}
+	}
+} // Vessel
@@ -0,0 +1,198 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "SlotStorage.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <utility>
+
+namespace Vessel
+{
+	// Small type tag of a belt item.
+	using TypeTag = uint8_t;
+
+	// Tag of free slots, never returned by taggers.
+	inline constexpr TypeTag kFreeSlotTag = std::numeric_limits<TypeTag>::max();
+
+	template<size_t Size, size_t TypeCount>
+	class SlotTypeTags;
+
+	// Tags storage of belts with the tagger, resolved only for belts which have one.
+	template<size_t Size, class Tagger>
+	struct SlotTypeTagsOf
+	{
+		using type = SlotTypeTags<Size, Tagger::kTypeCount>;
+	};
+
+	/**
+	* SlotTypeTags keeps one byte type tag per belt slot, so slots of a type are found and counted eight at a time.
+	*
+	* Behaviour:
+	* - Count of slots of every type is maintained on every change.
+	* - Tags are scanned as 64-bit words, padding at the end holds free tags which never match a type.
+	* - Tags are stored inline when count of slots is known at compile time.
+	*/
+	template<size_t Size, size_t TypeCount>
+	class SlotTypeTags final
+	{
+		// Public nested types.
+	public:
+		using Word = uint64_t;
+
+		// Life circle.
+	public:
+		inline explicit SlotTypeTags(size_t size = Size == kDynamicCapacity ? 0u : Size);
+
+		// Public interface.
+	public:
+		// Set tag of the slot, free slots take kFreeSlotTag.
+		inline void Set(size_t index, TypeTag tag);
+
+		// Get tag of the slot.
+		inline TypeTag Get(size_t index) const { return mTags[index]; }
+
+		// Find the first slot of the type at or after the index, wrapping around the end, tags out of types find nothing.
+		inline std::optional<size_t> FindNext(TypeTag tag, size_t index) const;
+
+		// Get maintained count of slots of the type, tags out of types have none.
+		inline size_t GetCount(TypeTag tag) const { return tag < TypeCount ? mCounts[tag] : 0u; }
+
+		// Count slots of the type by scanning all tags, tags out of types have none.
+		inline size_t CountTags(TypeTag tag) const;
+
+		// Private interface.
+	private:
+		// Load eight tags starting from the word.
+		inline Word LoadWord(size_t wordIndex) const;
+
+		// Get word with the high bit set in every byte equal to the tag.
+		static inline Word MatchBytes(Word word, TypeTag tag);
+
+		// Private constants.
+	private:
+		static constexpr size_t kWordBytes = sizeof(Word);
+		static constexpr Word kLowBytes = std::numeric_limits<Word>::max() / 0xFFu;
+		static constexpr Word kHighBits = kLowBytes * 0x80u;
+		static constexpr size_t kPaddedSize = Size == kDynamicCapacity ? kDynamicCapacity : (Size + kWordBytes - 1u) / kWordBytes * kWordBytes;
+
+		// Private state.
+	private:
+		SlotStorage<TypeTag, kPaddedSize> mTags{};
+		std::array<size_t, TypeCount> mCounts{};
+
+		// CT checks.
+	private:
+		static_assert(TypeCount > 0u && TypeCount <= kFreeSlotTag, "SlotTypeTags: type count must fit below the free slot tag.");
+	};
+
+	template<size_t Size, size_t TypeCount>
+	inline SlotTypeTags<Size, TypeCount>::SlotTypeTags(size_t size)
+	{
+		if constexpr (Size == kDynamicCapacity)
+		{
+			mTags.resize((size + kWordBytes - 1u) / kWordBytes * kWordBytes);
+		}
+
+		std::fill(mTags.begin(), mTags.end(), kFreeSlotTag);
+	}
+
+	template<size_t Size, size_t TypeCount>
+	inline void SlotTypeTags<Size, TypeCount>::Set(size_t index, TypeTag tag)
+	{
+		assert((tag < TypeCount || tag == kFreeSlotTag) && "Type tag is out of range.");
+
+		const TypeTag previousTag = std::exchange(mTags[index], tag);
+		if (previousTag != kFreeSlotTag)
+		{
+			--mCounts[previousTag];
+		}
+		if (tag != kFreeSlotTag)
+		{
+			++mCounts[tag];
+		}
+	}
+
+	template<size_t Size, size_t TypeCount>
+	inline std::optional<size_t> SlotTypeTags<Size, TypeCount>::FindNext(TypeTag tag, size_t index) const
+	{
+		const size_t wordCount = mTags.size() / kWordBytes;
+		if (wordCount == 0u || GetCount(tag) == 0u)
+		{
+			return {};
+		}
+
+		size_t wordIndex = index / kWordBytes;
+		Word mask = ~Word{ 0 } << (index % kWordBytes * 8u);
+
+		// One extra step revisits the tags before the index in the first word.
+		for (size_t step = 0u; step <= wordCount; ++step)
+		{
+			const Word matches = MatchBytes(LoadWord(wordIndex), tag) & mask;
+			if (matches != Word{ 0 })
+			{
+				return wordIndex * kWordBytes + static_cast<size_t>(std::countr_zero(matches)) / 8u;
+			}
+
+			wordIndex = wordIndex + 1u == wordCount ? 0u : wordIndex + 1u;
+			mask = ~Word{ 0 };
+		}
+
+		return {};
+	}
+
+	template<size_t Size, size_t TypeCount>
+	inline size_t SlotTypeTags<Size, TypeCount>::CountTags(TypeTag tag) const
+	{
+		if (tag >= TypeCount)
+		{
+			return 0u;
+		}
+
+		const size_t wordCount = mTags.size() / kWordBytes;
+
+		size_t count = 0u;
+		for (size_t wordIndex = 0u; wordIndex < wordCount; ++wordIndex)
+		{
+			count += static_cast<size_t>(std::popcount(MatchBytes(LoadWord(wordIndex), tag)));
+		}
+
+		return count;
+	}
+
+	template<size_t Size, size_t TypeCount>
+	inline SlotTypeTags<Size, TypeCount>::Word SlotTypeTags<Size, TypeCount>::LoadWord(size_t wordIndex) const
+	{
+		const TypeTag* tags = mTags.data() + wordIndex * kWordBytes;
+
+		Word word = 0u;
+		if constexpr (std::endian::native == std::endian::little)
+		{
+			std::memcpy(&word, tags, kWordBytes);
+		}
+		else
+		{
+			// First slot goes to the lowest byte, so matches are found from the lowest bit.
+			for (size_t byteIndex = 0u; byteIndex < kWordBytes; ++byteIndex)
+			{
+				word |= Word{ tags[byteIndex] } << (byteIndex * 8u);
+			}
+		}
+
+		return word;
+	}
+
+	template<size_t Size, size_t TypeCount>
+	inline SlotTypeTags<Size, TypeCount>::Word SlotTypeTags<Size, TypeCount>::MatchBytes(Word word, TypeTag tag)
+	{
+		// Matching bytes turn to zero, then zero bytes are detected exactly without borrows between them.
+		const Word difference = word ^ (kLowBytes * tag);
+		return ~(((difference & ~kHighBits) + ~kHighBits) | difference | ~kHighBits);
+	}
+} // Vessel
@@ -0,0 +1,364 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "BeltInterface.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace Vessel
+{
+	/**
+	* SupplyChain is a network of linked belts which advances as a whole on every tick.
+	*
+	* Requirements:
+	* - Belts are owned outside and must outlive the chain.
+	*
+	* Behaviour:
+	* - Links are scheduled in reverse topological order, so every item moves over a single link per tick.
+	* - Belts linked in a cycle are scheduled after the rest of their chain in the order they were linked.
+	* - Every link moves up to its rate of items per tick in one bulk exchange.
+	* - Independent chains share no belts, so they can be spread across threads.
+	* - Worker threads are started by the first tick which needs them and sleep between ticks till the chain is destroyed.
+	*/
+	template<class BasicType>
+	class SupplyChain final
+	{
+		// Public nested types.
+	public:
+		using BeltId = size_t;
+
+		// Life circle.
+	public:
+		inline SupplyChain() = default;
+		inline SupplyChain(const SupplyChain&) = delete;
+		inline SupplyChain& operator=(const SupplyChain&) = delete;
+		inline ~SupplyChain();
+
+		// Public interface.
+	public:
+		// Add the belt to the chain.
+		inline BeltId AddBelt(BeltInterface<BasicType>& belt);
+
+		// Link feeder end of one belt to receiver end of another one, both must be added to the chain.
+		inline void Link(BeltId feederId, BeltId receiverId, size_t itemsPerTick = 1u);
+
+		// Advance the whole network on up to the count of threads including the calling one, returns count of moved items.
+		inline size_t Tick(size_t threadCount = 1u);
+
+		// Get count of belts.
+		inline size_t GetBeltCount() const { return mBelts.size(); }
+
+		// Get count of independent chains, may rebuild the schedule, so don't call it concurrently with other calls.
+		inline size_t GetChainCount() const;
+
+		// Private nested types.
+	private:
+		struct Connection
+		{
+			BeltId feederId;
+			BeltId receiverId;
+			size_t itemsPerTick;
+		};
+
+		// Private interface.
+	private:
+		// Order links of every independent chain.
+		inline void Schedule() const;
+
+		// Advance links of the chain.
+		inline size_t TickChain(size_t chainIndex);
+
+		// Move items over the link.
+		inline size_t TickConnection(const Connection& link);
+
+		// Take chains of the tick one by one, so long chains don't stall the others.
+		inline void Work();
+
+		// Wait for ticks and work on them till the chain is destroyed.
+		inline void RunWorker(size_t workerIndex, size_t generation);
+
+		// Private state.
+	private:
+		std::vector<BeltInterface<BasicType>*> mBelts;
+		std::vector<Connection> mLinks;
+
+		// Scheduled link indices, grouped by independent chains, a cache rebuilt lazily after belts or links change.
+		mutable std::vector<size_t> mSchedule;
+		mutable std::vector<size_t> mChainOffsets;
+		mutable bool mIsScheduled = false;
+
+		// Worker threads kept between ticks, every tick wakes them up with a new generation.
+		std::vector<std::thread> mWorkers;
+		std::mutex mWorkMutex;
+		std::condition_variable mWorkStarted;
+		std::condition_variable mWorkFinished;
+		size_t mWorkGeneration = 0u;
+		size_t mActiveWorkerCount = 0u;
+		size_t mBusyWorkerCount = 0u;
+		bool mIsStopping = false;
+
+		// Chains of the current tick, shared by workers.
+		size_t mTickChainCount = 0u;
+		std::atomic<size_t> mNextChainIndex = 0u;
+		std::atomic<size_t> mMovedCount = 0u;
+	};
+
+	template<class BasicType>
+	inline SupplyChain<BasicType>::~SupplyChain()
+	{
+		{
+			const std::lock_guard lock{ mWorkMutex };
+			mIsStopping = true;
+		}
+		mWorkStarted.notify_all();
+
+		for (std::thread& worker : mWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	template<class BasicType>
+	inline SupplyChain<BasicType>::BeltId SupplyChain<BasicType>::AddBelt(BeltInterface<BasicType>& belt)
+	{
+		mBelts.push_back(&belt);
+		mIsScheduled = false;
+
+		return mBelts.size() - 1u;
+	}
+
+	template<class BasicType>
+	inline void SupplyChain<BasicType>::Link(BeltId feederId, BeltId receiverId, size_t itemsPerTick)
+	{
+		assert(feederId < mBelts.size() && receiverId < mBelts.size() && "Linked belt isn't added to the chain.");
+
+		mLinks.push_back({ feederId, receiverId, itemsPerTick });
+		mIsScheduled = false;
+	}
+
+	template<class BasicType>
+	inline size_t SupplyChain<BasicType>::Tick(size_t threadCount)
+	{
+		const ScopedTraceZone zone{ "SupplyChain::Tick" };
+
+		if (!mIsScheduled)
+		{
+			Schedule();
+		}
+
+		const size_t chainCount = mChainOffsets.size() - 1u;
+		threadCount = std::min(threadCount, chainCount);
+
+		if (threadCount <= 1u)
+		{
+			size_t movedCount = 0u;
+			for (size_t chainIndex = 0u; chainIndex < chainCount; ++chainIndex)
+			{
+				movedCount += TickChain(chainIndex);
+			}
+
+			return movedCount;
+		}
+
+		// New workers wait for the next generation, the calling thread is a worker too.
+		while (mWorkers.size() + 1u < threadCount)
+		{
+			mWorkers.emplace_back(&SupplyChain::RunWorker, this, mWorkers.size(), mWorkGeneration);
+		}
+
+		mTickChainCount = chainCount;
+		mNextChainIndex.store(0u, std::memory_order_relaxed);
+		mMovedCount.store(0u, std::memory_order_relaxed);
+
+		{
+			const std::lock_guard lock{ mWorkMutex };
+			mActiveWorkerCount = threadCount - 1u;
+			mBusyWorkerCount = threadCount - 1u;
+			++mWorkGeneration;
+		}
+		mWorkStarted.notify_all();
+
+		Work();
+
+		std::unique_lock lock{ mWorkMutex };
+		mWorkFinished.wait(lock, [this]() { return mBusyWorkerCount == 0u; });
+
+		return mMovedCount.load(std::memory_order_relaxed);
+	}
+
+	template<class BasicType>
+	inline size_t SupplyChain<BasicType>::GetChainCount() const
+	{
+		if (!mIsScheduled)
+		{
+			Schedule();
+		}
+
+		return mChainOffsets.size() - 1u;
+	}
+
+	template<class BasicType>
+	inline void SupplyChain<BasicType>::Schedule() const
+	{
+		const size_t beltCount = mBelts.size();
+
+		// Join linked belts into independent chains.
+		std::vector<size_t> roots(beltCount);
+		std::iota(roots.begin(), roots.end(), size_t{ 0 });
+
+		auto findRoot = [&roots](size_t beltId) {
+			while (roots[beltId] != beltId)
+			{
+				roots[beltId] = roots[roots[beltId]];
+				beltId = roots[beltId];
+			}
+			return beltId;
+			};
+
+		for (const Connection& link : mLinks)
+		{
+			roots[findRoot(link.feederId)] = findRoot(link.receiverId);
+		}
+
+		// Order belts from sinks to sources, so downstream links free slots before upstream ones fill them.
+		std::vector<size_t> outgoingCounts(beltCount, 0u);
+		std::vector<std::vector<size_t>> incomingLinks(beltCount);
+		for (size_t linkIndex = 0u; linkIndex < mLinks.size(); ++linkIndex)
+		{
+			++outgoingCounts[mLinks[linkIndex].feederId];
+			incomingLinks[mLinks[linkIndex].receiverId].push_back(linkIndex);
+		}
+
+		std::vector<size_t> beltOrder;
+		beltOrder.reserve(beltCount);
+		for (size_t beltId = 0u; beltId < beltCount; ++beltId)
+		{
+			if (outgoingCounts[beltId] == 0u)
+			{
+				beltOrder.push_back(beltId);
+			}
+		}
+
+		std::vector<size_t> linkRanks(mLinks.size(), mLinks.size());
+		size_t nextRank = 0u;
+		for (size_t orderIndex = 0u; orderIndex < beltOrder.size(); ++orderIndex)
+		{
+			for (size_t linkIndex : incomingLinks[beltOrder[orderIndex]])
+			{
+				linkRanks[linkIndex] = nextRank++;
+
+				const BeltId feederId = mLinks[linkIndex].feederId;
+				if (--outgoingCounts[feederId] == 0u)
+				{
+					beltOrder.push_back(feederId);
+				}
+			}
+		}
+
+		// Links left unranked are on cycles, they keep order of linking.
+		for (size_t& rank : linkRanks)
+		{
+			if (rank == mLinks.size())
+			{
+				rank = nextRank++;
+			}
+		}
+
+		// Group links by chains, keeping the rank order inside every chain.
+		std::vector<size_t> chainIndices(beltCount, beltCount);
+		size_t chainCount = 0u;
+		for (size_t beltId = 0u; beltId < beltCount; ++beltId)
+		{
+			const size_t root = findRoot(beltId);
+			if (chainIndices[root] == beltCount)
+			{
+				chainIndices[root] = chainCount++;
+			}
+		}
+
+		mSchedule.resize(mLinks.size());
+		std::iota(mSchedule.begin(), mSchedule.end(), size_t{ 0 });
+		std::sort(mSchedule.begin(), mSchedule.end(), [&](size_t left, size_t right) {
+			const size_t leftChain = chainIndices[findRoot(mLinks[left].feederId)];
+			const size_t rightChain = chainIndices[findRoot(mLinks[right].feederId)];
+			return leftChain != rightChain ? leftChain < rightChain : linkRanks[left] < linkRanks[right];
+			});
+
+		mChainOffsets.assign(chainCount + 1u, 0u);
+		for (const Connection& link : mLinks)
+		{
+			++mChainOffsets[chainIndices[findRoot(link.feederId)] + 1u];
+		}
+		std::partial_sum(mChainOffsets.begin(), mChainOffsets.end(), mChainOffsets.begin());
+
+		mIsScheduled = true;
+	}
+
+	template<class BasicType>
+	inline size_t SupplyChain<BasicType>::TickChain(size_t chainIndex)
+	{
+		size_t movedCount = 0u;
+		for (size_t scheduleIndex = mChainOffsets[chainIndex]; scheduleIndex < mChainOffsets[chainIndex + 1u]; ++scheduleIndex)
+		{
+			movedCount += TickConnection(mLinks[mSchedule[scheduleIndex]]);
+		}
+
+		return movedCount;
+	}
+
+	template<class BasicType>
+	inline size_t SupplyChain<BasicType>::TickConnection(const Connection& link)
+	{
+		return Exchanger<BasicType>::ExchangeN(*mBelts[link.receiverId], *mBelts[link.feederId], link.itemsPerTick);
+	}
+
+	template<class BasicType>
+	inline void SupplyChain<BasicType>::Work()
+	{
+		const ScopedTraceZone zone{ "SupplyChain::Work" };
+
+		size_t movedCount = 0u;
+		for (size_t chainIndex = mNextChainIndex.fetch_add(1u); chainIndex < mTickChainCount; chainIndex = mNextChainIndex.fetch_add(1u))
+		{
+			movedCount += TickChain(chainIndex);
+		}
+		mMovedCount.fetch_add(movedCount);
+	}
+
+	template<class BasicType>
+	inline void SupplyChain<BasicType>::RunWorker(size_t workerIndex, size_t generation)
+	{
+		std::unique_lock lock{ mWorkMutex };
+		while (true)
+		{
+			mWorkStarted.wait(lock, [&]() { return mIsStopping || mWorkGeneration != generation; });
+			if (mIsStopping)
+			{
+				return;
+			}
+
+			// Ticks on fewer threads leave extra workers asleep.
+			generation = mWorkGeneration;
+			if (workerIndex >= mActiveWorkerCount)
+			{
+				continue;
+			}
+
+			lock.unlock();
+			Work();
+			lock.lock();
+
+			if (--mBusyWorkerCount == 0u)
+			{
+				mWorkFinished.notify_one();
+			}
+		}
+	}
+} // Vessel
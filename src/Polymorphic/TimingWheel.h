@@ -0,0 +1,151 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Vessel
+{
+	/**
+	* TimingWheel is a hierarchical timer wheel which fires scheduled payloads on their ticks.
+	*
+	* Behaviour:
+	* - Every level has 64 buckets, a bucket of level L spans 64^L ticks.
+	* - Events are placed by the highest bit their tick differs from the current one, so far events sit on upper levels.
+	* - Buckets of upper levels are cascaded down when the current tick reaches them, every event is moved at most once per level.
+	* - Events behind the last level wait in an overflow bucket, which is cascaded when the last level wraps.
+	* - Advance costs a constant count of checks plus the count of fired and cascaded events.
+	*/
+	template<typename Payload, size_t LevelCount = 4u>
+	class TimingWheel final
+	{
+		// Public nested types.
+	public:
+		using Tick = uint64_t;
+
+		// Public interface.
+	public:
+		// Schedule the payload to fire on the tick, ticks which already passed fire on the next advance.
+		inline void Schedule(Tick tick, Payload payload);
+
+		// Move to the next tick and call the handler with every payload due on it.
+		template<typename Handler>
+		inline void Advance(Handler&& handler);
+
+		// Get the current tick.
+		inline Tick GetTick() const { return mTick; }
+
+		// Get count of scheduled events.
+		inline size_t GetEventCount() const { return mEventCount; }
+
+		// Private nested types.
+	private:
+		struct Event
+		{
+			Tick tick;
+			Payload payload;
+		};
+
+		using Bucket = std::vector<Event>;
+
+		// Private interface.
+	private:
+		// Put the event into the bucket of its tick, the tick must not be in the past.
+		inline void Place(Event event);
+
+		// Place events of the bucket again relative to the current tick.
+		inline void Cascade(Bucket& bucket);
+
+		// Get the digit of the tick on the level.
+		static inline size_t GetDigit(Tick tick, size_t level) { return static_cast<size_t>(tick >> (level * kLevelBits)) & kDigitMask; }
+
+		// Private constants.
+	private:
+		static constexpr size_t kLevelBits = 6u;
+		static constexpr size_t kBucketCount = size_t{ 1 } << kLevelBits;
+		static constexpr size_t kDigitMask = kBucketCount - 1u;
+
+		// Private state.
+	private:
+		std::array<std::array<Bucket, kBucketCount>, LevelCount> mLevels{};
+		Bucket mOverflow;
+
+		// Events taken out of a bucket while they are fired or cascaded, kept to reuse the buffer.
+		Bucket mScratch;
+
+		Tick mTick = 0u;
+		size_t mEventCount = 0u;
+
+		// CT checks.
+	private:
+		static_assert(LevelCount > 0u && LevelCount * kLevelBits < sizeof(Tick) * 8u, "TimingWheel<T, N>: N levels must fit into the tick.");
+	};
+
+	template<typename Payload, size_t LevelCount>
+	inline void TimingWheel<Payload, LevelCount>::Schedule(Tick tick, Payload payload)
+	{
+		Place({ std::max(tick, mTick + 1u), std::move(payload) });
+		++mEventCount;
+	}
+
+	template<typename Payload, size_t LevelCount>
+	template<typename Handler>
+	inline void TimingWheel<Payload, LevelCount>::Advance(Handler&& handler)
+	{
+		++mTick;
+
+		// Digits of upper levels change only when all lower ones wrap to zero, top levels go first so events fall through.
+		if (mTick % (Tick{ 1 } << (LevelCount * kLevelBits)) == 0u)
+		{
+			Cascade(mOverflow);
+		}
+
+		for (size_t level = LevelCount - 1u; level > 0u; --level)
+		{
+			if (mTick % (Tick{ 1 } << (level * kLevelBits)) == 0u)
+			{
+				Cascade(mLevels[level][GetDigit(mTick, level)]);
+			}
+		}
+
+		// Handler may schedule more events, none of them lands into the fired bucket.
+		std::swap(mScratch, mLevels[0][GetDigit(mTick, 0u)]);
+		mEventCount -= mScratch.size();
+		for (Event& event : mScratch)
+		{
+			handler(std::move(event.payload));
+		}
+		mScratch.clear();
+	}
+
+	template<typename Payload, size_t LevelCount>
+	inline void TimingWheel<Payload, LevelCount>::Place(Event event)
+	{
+		const Tick difference = event.tick ^ mTick;
+		const size_t level = difference == 0u ? 0u : (static_cast<size_t>(std::bit_width(difference)) - 1u) / kLevelBits;
+
+		if (level >= LevelCount)
+		{
+			mOverflow.push_back(std::move(event));
+			return;
+		}
+
+		mLevels[level][GetDigit(event.tick, level)].push_back(std::move(event));
+	}
+
+	template<typename Payload, size_t LevelCount>
+	inline void TimingWheel<Payload, LevelCount>::Cascade(Bucket& bucket)
+	{
+		std::swap(mScratch, bucket);
+		for (Event& event : mScratch)
+		{
+			Place(std::move(event));
+		}
+		mScratch.clear();
+	}
+} // Vessel
@@ -0,0 +1,378 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "BeltInterface.h"
+#include "TimingWheel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace Vessel
+{
+	template<class BasicType>
+	class TransitBelt;
+
+	/**
+	* TransitClock is a shared time of transit belts, it delivers items on the ticks they arrive.
+	*
+	* Requirements:
+	* - Belts are owned outside and must outlive the clock.
+	*
+	* Behaviour:
+	* - Arrivals are scheduled in a timing wheel, belts without arriving items cost nothing on a tick.
+	* - Items pushed into a belt on the same tick arrive with one event.
+	*/
+	template<class BasicType>
+	class TransitClock final
+	{
+		// Public nested types.
+	public:
+		using TickIndex = TimingWheel<TransitBelt<BasicType>*>::Tick;
+
+		// Public interface.
+	public:
+		// Advance the clock, returns count of arrived items.
+		inline size_t Tick() { return Tick([](TransitBelt<BasicType>&) {}); }
+
+		// Advance the clock and call the visitor with every belt which got arrived items, returns count of arrived items.
+		template<typename Visitor>
+		inline size_t Tick(Visitor&& visitor);
+
+		// Get the current tick.
+		inline TickIndex GetTick() const { return mWheel.GetTick(); }
+
+		// Get count of scheduled arrivals.
+		inline size_t GetArrivalCount() const { return mWheel.GetEventCount(); }
+
+		// Private interface.
+	private:
+		// Schedule arrival of belt items on the tick.
+		inline void Schedule(TransitBelt<BasicType>& belt, TickIndex tick) { mWheel.Schedule(tick, &belt); }
+
+		// Private state.
+	private:
+		TimingWheel<TransitBelt<BasicType>*> mWheel;
+
+		// Private friend types.
+	private:
+		friend TransitBelt<BasicType>;
+	};
+
+	/**
+	* TransitBelt is a belt where items take a fixed count of ticks to travel from the receiver end to the feeder end.
+	*
+	* Behaviour:
+	* - Items are kept in order from the feeder end, arrived ones in front of the ones in transit.
+	* - Items in transit take their slots, but the feeder can take only arrived items.
+	* - The belt never turns, items are moved by the clock, so NextBeltSlot does nothing.
+	* - Receiver end only takes items in, items can't be taken back from it.
+	* - Items pushed back to the feeder end or loaded with SetSlotItems are arrived at once.
+	*/
+	template<class BasicType>
+	class TransitBelt final : public BeltInterface<BasicType>
+	{
+		// Public nested types.
+	public:
+		using ReferenceWrapper = BeltInterface<BasicType>::ReferenceWrapper;
+		using OptionalRefWrapper = BeltInterface<BasicType>::OptionalRefWrapper;
+		using SlotPointer = BeltInterface<BasicType>::SlotPointer;
+		using TickIndex = TransitClock<BasicType>::TickIndex;
+
+		// Life circle.
+	public:
+		inline TransitBelt(TransitClock<BasicType>& clock, size_t capacity = 1u, size_t travelTicks = 1u);
+
+		// Public virtual interface substitution.
+	public:
+		// BeltInterface::SetSlotItems
+		inline void SetSlotItems(std::vector<OptionalRefWrapper> slotItems) override;
+
+		// BeltInterface::ExchangeFeederSlot
+		inline OptionalRefWrapper ExchangeFeederSlot(OptionalRefWrapper item = {}) override;
+
+		// BeltInterface::ExchangeReceiverSlot
+		inline OptionalRefWrapper ExchangeReceiverSlot(OptionalRefWrapper item = {}) override;
+
+		// BeltInterface::IsEmptySlot
+		inline bool IsEmptySlot(size_t offset = 0u) const override { return offset % mCapacity >= mSize; }
+
+		// BeltInterface::FindOccupiedSlot
+		inline std::optional<size_t> FindOccupiedSlot(size_t offset = 0u) const override;
+
+		// BeltInterface::FindEmptySlot
+		inline std::optional<size_t> FindEmptySlot(size_t offset = 0u) const override;
+
+		// BeltInterface::GetItemCount
+		inline size_t GetItemCount() const override { return mSize; }
+
+		// BeltInterface::GetSlotCount
+		inline size_t GetSlotCount() const override { return mCapacity; }
+
+		// BeltInterface::GetReceiverSlotOffset
+		inline size_t GetReceiverSlotOffset() const override { return mCapacity - 1u; }
+
+		// BeltInterface::PullFeederItems
+		inline size_t PullFeederItems(std::span<SlotPointer> items) override;
+
+		// BeltInterface::PushReceiverItems
+		inline size_t PushReceiverItems(std::span<const SlotPointer> items) override;
+
+		// Public interface.
+	public:
+		// Get count of items which reached the feeder end.
+		inline size_t GetArrivedCount() const { return mArrivedCount; }
+
+		// Get count of ticks items travel along the belt.
+		inline size_t GetTravelTicks() const { return mTravelTicks; }
+
+		// Inheritable virtual interface substitution.
+	protected:
+		// BeltInterface::VisitSlotRuns, slots of the belt up to the end of the ring and then the wrapped part.
+		inline void VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const override;
+
+		// Private interface.
+	private:
+		// Translate belt offset to the ring slot.
+		inline size_t TranslateIndex(size_t offset) const { return (mFrontIndex + offset) % mCapacity; }
+
+		// Append items to the back of the belt and schedule their arrival.
+		inline void Append(std::span<const SlotPointer> items);
+
+		// Mark items due on the tick as arrived, returns count of arrived items.
+		inline size_t Arrive(TickIndex tick);
+
+		// Take items from the front of the belt.
+		inline void PopFront(size_t count);
+
+		// Private state.
+	private:
+		std::vector<SlotPointer> mRing;
+
+		// Tick of arrival of every ring slot.
+		std::vector<TickIndex> mArrivalTicks;
+
+		size_t mFrontIndex = 0u;
+		size_t mSize = 0u;
+		size_t mArrivedCount = 0u;
+
+		// Last tick arrival was scheduled on, later pushes on the same tick share it.
+		TickIndex mScheduledTick = 0u;
+
+		// Private properties.
+	private:
+		TransitClock<BasicType>& mClock;
+		const size_t mCapacity = 1u;
+		const size_t mTravelTicks = 1u;
+
+		// Private friend types.
+	private:
+		friend TransitClock<BasicType>;
+	};
+
+	template<class BasicType>
+	template<typename Visitor>
+	inline size_t TransitClock<BasicType>::Tick(Visitor&& visitor)
+	{
+		size_t arrivedCount = 0u;
+		mWheel.Advance([&](TransitBelt<BasicType>* belt) {
+			const size_t beltArrivedCount = belt->Arrive(mWheel.GetTick());
+			if (beltArrivedCount > 0u)
+			{
+				arrivedCount += beltArrivedCount;
+				visitor(*belt);
+			}
+			});
+
+		return arrivedCount;
+	}
+
+	template<class BasicType>
+	inline TransitBelt<BasicType>::TransitBelt(TransitClock<BasicType>& clock, size_t capacity, size_t travelTicks)
+		: mClock{ clock }
+		, mCapacity{ std::max(capacity, size_t{ 1 }) }
+		, mTravelTicks{ travelTicks }
+	{
+		mRing.resize(mCapacity);
+		mArrivalTicks.resize(mCapacity);
+	}
+
+	template<class BasicType>
+	inline void TransitBelt<BasicType>::SetSlotItems(std::vector<OptionalRefWrapper> slotItems)
+	{
+		// Free slots are not kept inside the belt, items are packed to the feeder end.
+		mFrontIndex = 0u;
+		mSize = 0u;
+		for (const OptionalRefWrapper& item : slotItems)
+		{
+			if (item.has_value() && mSize < mCapacity)
+			{
+				mRing[mSize] = BeltInterface<BasicType>::ToSlot(item);
+				mArrivalTicks[mSize] = mClock.GetTick();
+				++mSize;
+			}
+		}
+
+		std::fill(mRing.begin() + mSize, mRing.end(), nullptr);
+		mArrivedCount = mSize;
+	}
+
+	template<class BasicType>
+	inline TransitBelt<BasicType>::OptionalRefWrapper TransitBelt<BasicType>::ExchangeFeederSlot(OptionalRefWrapper item)
+	{
+		if (!item.has_value())
+		{
+			if (mArrivedCount == 0u)
+			{
+				return {};
+			}
+
+			const SlotPointer result = mRing[mFrontIndex];
+			PopFront(1u);
+			return BeltInterface<BasicType>::ToItem(result);
+		}
+
+		if (mSize < mCapacity)
+		{
+			mFrontIndex = TranslateIndex(mCapacity - 1u);
+			mRing[mFrontIndex] = BeltInterface<BasicType>::ToSlot(item);
+			mArrivalTicks[mFrontIndex] = mClock.GetTick();
+			++mSize;
+			++mArrivedCount;
+			return {};
+		}
+
+		if (mArrivedCount == 0u)
+		{
+			return item;
+		}
+
+		return BeltInterface<BasicType>::ToItem(std::exchange(mRing[mFrontIndex], BeltInterface<BasicType>::ToSlot(item)));
+	}
+
+	template<class BasicType>
+	inline TransitBelt<BasicType>::OptionalRefWrapper TransitBelt<BasicType>::ExchangeReceiverSlot(OptionalRefWrapper item)
+	{
+		if (!item.has_value() || mSize == mCapacity)
+		{
+			return item;
+		}
+
+		const SlotPointer slot = BeltInterface<BasicType>::ToSlot(item);
+		Append({ &slot, 1u });
+		return {};
+	}
+
+	template<class BasicType>
+	inline std::optional<size_t> TransitBelt<BasicType>::FindOccupiedSlot(size_t offset) const
+	{
+		if (mSize == 0u)
+		{
+			return {};
+		}
+
+		offset %= mCapacity;
+		return offset < mSize ? 0u : mCapacity - offset;
+	}
+
+	template<class BasicType>
+	inline std::optional<size_t> TransitBelt<BasicType>::FindEmptySlot(size_t offset) const
+	{
+		if (mSize == mCapacity)
+		{
+			return {};
+		}
+
+		offset %= mCapacity;
+		return offset >= mSize ? 0u : mSize - offset;
+	}
+
+	template<class BasicType>
+	inline size_t TransitBelt<BasicType>::PullFeederItems(std::span<SlotPointer> items)
+	{
+		const size_t pulledCount = std::min(items.size(), mArrivedCount);
+		const size_t firstCount = std::min(pulledCount, mCapacity - mFrontIndex);
+
+		std::copy_n(mRing.begin() + mFrontIndex, firstCount, items.begin());
+		std::copy_n(mRing.begin(), pulledCount - firstCount, items.begin() + firstCount);
+		PopFront(pulledCount);
+
+		return pulledCount;
+	}
+
+	template<class BasicType>
+	inline size_t TransitBelt<BasicType>::PushReceiverItems(std::span<const SlotPointer> items)
+	{
+		const size_t pushedCount = std::min(items.size(), mCapacity - mSize);
+		Append(items.first(pushedCount));
+
+		return pushedCount;
+	}
+
+	template<class BasicType>
+	inline void TransitBelt<BasicType>::VisitSlotRuns(void* context, BeltInterface<BasicType>::SlotRunCallback callback) const
+	{
+		const SlotPointer* slots = mRing.data();
+		const size_t backIndex = mFrontIndex + mSize;
+
+		callback(context, { slots + mFrontIndex, std::min(backIndex, mCapacity) - mFrontIndex });
+		if (backIndex > mCapacity)
+		{
+			callback(context, { slots, backIndex - mCapacity });
+		}
+	}
+
+	template<class BasicType>
+	inline void TransitBelt<BasicType>::Append(std::span<const SlotPointer> items)
+	{
+		assert(mSize + items.size() <= mCapacity && "Items don't fit the belt.");
+
+		const TickIndex arrivalTick = mClock.GetTick() + mTravelTicks;
+		for (SlotPointer item : items)
+		{
+			const size_t index = TranslateIndex(mSize++);
+			mRing[index] = item;
+			mArrivalTicks[index] = arrivalTick;
+		}
+
+		// Nothing travels on belts without travel time.
+		if (mTravelTicks == 0u)
+		{
+			mArrivedCount = mSize;
+			return;
+		}
+
+		if (!items.empty() && mScheduledTick != arrivalTick)
+		{
+			mScheduledTick = arrivalTick;
+			mClock.Schedule(*this, arrivalTick);
+		}
+	}
+
+	template<class BasicType>
+	inline size_t TransitBelt<BasicType>::Arrive(TickIndex tick)
+	{
+		// Items arrive in order, stale events of reloaded belts find nothing.
+		const size_t arrivedCount = mArrivedCount;
+		while (mArrivedCount < mSize && mArrivalTicks[TranslateIndex(mArrivedCount)] <= tick)
+		{
+			++mArrivedCount;
+		}
+
+		return mArrivedCount - arrivedCount;
+	}
+
+	template<class BasicType>
+	inline void TransitBelt<BasicType>::PopFront(size_t count)
+	{
+		for (size_t offset = 0u; offset < count; ++offset)
+		{
+			mRing[TranslateIndex(offset)] = nullptr;
+		}
+
+		mFrontIndex = TranslateIndex(count);
+		mSize -= count;
+		mArrivedCount -= count;
+	}
+} // Vessel
@@ -0,0 +1,51 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Vessel
+{
+	// Are trace zones compiled in, enabled by defining VESSEL_TRACE for the whole build.
+#if defined(VESSEL_TRACE)
+	inline constexpr bool kTraceEnabled = true;
+#else
+	inline constexpr bool kTraceEnabled = false;
+#endif
+
+	/**
+	* TraceZone records the time from its construction to its destruction under the given name.
+	*
+	* Requirements:
+	* - TraceRecorder.h must be included where zones are used, builds with VESSEL_TRACE include it here.
+	*/
+	class TraceZone final
+	{
+		// Life circle.
+	public:
+		inline explicit TraceZone(const char* name);
+		inline ~TraceZone();
+
+		TraceZone(const TraceZone&) = delete;
+		TraceZone& operator=(const TraceZone&) = delete;
+
+		// Private state.
+	private:
+		const char* mName;
+		uint64_t mBeginNs;
+	};
+
+	// Empty zone of builds with disabled tracing, it compiles to nothing.
+	struct NoTraceZone final
+	{
+		constexpr explicit NoTraceZone(const char*) noexcept {}
+	};
+
+	// Zone to put at entry points, 'const ScopedTraceZone zone{ "Class::Method" };'.
+	using ScopedTraceZone = std::conditional_t<kTraceEnabled, TraceZone, NoTraceZone>;
+} // Vessel
+
+// Recorder is pulled into hot headers only when zones record something.
+#if defined(VESSEL_TRACE)
+#include "TraceRecorder.h"
+#endif
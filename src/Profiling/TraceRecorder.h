@@ -0,0 +1,222 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Vessel
+{
+	/**
+	* TraceRecorder keeps the latest finished trace zones of every thread and exports them as Chrome trace JSON.
+	*
+	* Requirements:
+	* - Zone names must live as long as the recorder, string literals are meant.
+	*
+	* Behaviour:
+	* - Every thread records into its own ring buffer without any lock, the oldest zones are overwritten.
+	* - Rings outlive their threads, so zones of finished workers are exported too.
+	* - Export writes complete events which open in Perfetto or chrome://tracing as a timeline per thread.
+	*
+	* Threading:
+	* - Export and Clear must run while traced threads are idle, e.g. between ticks, otherwise zones being written may be torn.
+	*/
+	class TraceRecorder final
+	{
+		// Public nested types.
+	public:
+		struct Zone
+		{
+			const char* name;
+			uint64_t beginNs;
+			uint64_t endNs;
+		};
+
+		// Public constants.
+	public:
+		// Count of latest zones kept per thread.
+		static constexpr size_t kRingSize = size_t{ 1 } << 16;
+
+		// Public static interface.
+	public:
+		// Get nanoseconds of the monotonic clock.
+		static uint64_t Now();
+
+		// Append the finished zone to the calling thread ring.
+		static void Record(const char* name, uint64_t beginNs, uint64_t endNs);
+
+		// Get count of zones kept in all rings.
+		static size_t GetZoneCount();
+
+		// Write zones of all threads to the file in Chrome trace format, returns false if the file can't be written.
+		static bool ExportChromeTrace(const std::filesystem::path& path);
+
+		// Forget zones of all threads.
+		static void Clear();
+
+		// Private nested types.
+	private:
+		struct ThreadRing
+		{
+			std::unique_ptr<Zone[]> zones = std::make_unique<Zone[]>(kRingSize);
+			std::atomic<uint64_t> writeCount = 0u;
+			uint32_t threadId = 0u;
+		};
+
+		struct Registry
+		{
+			std::mutex mutex;
+			std::vector<std::shared_ptr<ThreadRing>> rings;
+		};
+
+		// Private static interface.
+	private:
+		static Registry& GetRegistry();
+		static ThreadRing& GetThreadRing();
+
+		// Write the name as JSON string.
+		static void WriteName(std::ofstream& stream, const char* name);
+	};
+
+	inline TraceZone::TraceZone(const char* name)
+		: mName{ name }
+		, mBeginNs{ TraceRecorder::Now() }
+	{
+	}
+
+	inline TraceZone::~TraceZone()
+	{
+		TraceRecorder::Record(mName, mBeginNs, TraceRecorder::Now());
+	}
+
+	inline uint64_t TraceRecorder::Now()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	inline void TraceRecorder::Record(const char* name, uint64_t beginNs, uint64_t endNs)
+	{
+		ThreadRing& ring = GetThreadRing();
+		const uint64_t writeCount = ring.writeCount.load(std::memory_order_relaxed);
+
+		ring.zones[writeCount & (kRingSize - 1u)] = { name, beginNs, endNs };
+		ring.writeCount.store(writeCount + 1u, std::memory_order_release);
+	}
+
+	inline size_t TraceRecorder::GetZoneCount()
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard lock{ registry.mutex };
+
+		size_t count = 0u;
+		for (const std::shared_ptr<ThreadRing>& ring : registry.rings)
+		{
+			count += static_cast<size_t>(std::min<uint64_t>(ring->writeCount.load(std::memory_order_acquire), kRingSize));
+		}
+		return count;
+	}
+
+	inline bool TraceRecorder::ExportChromeTrace(const std::filesystem::path& path)
+	{
+		std::ofstream stream{ path, std::ios::trunc };
+		if (!stream)
+		{
+			return false;
+		}
+
+		Registry& registry = GetRegistry();
+		std::lock_guard lock{ registry.mutex };
+
+		// Timeline starts at the earliest kept zone, so timestamps stay short.
+		uint64_t originNs = std::numeric_limits<uint64_t>::max();
+		for (const std::shared_ptr<ThreadRing>& ring : registry.rings)
+		{
+			const uint64_t writeCount = ring->writeCount.load(std::memory_order_acquire);
+			for (uint64_t index = writeCount - std::min<uint64_t>(writeCount, kRingSize); index < writeCount; ++index)
+			{
+				originNs = std::min(originNs, ring->zones[index & (kRingSize - 1u)].beginNs);
+			}
+		}
+
+		stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		stream.setf(std::ios::fixed);
+		stream.precision(3);
+
+		bool isFirst = true;
+		for (const std::shared_ptr<ThreadRing>& ring : registry.rings)
+		{
+			const uint64_t writeCount = ring->writeCount.load(std::memory_order_acquire);
+			for (uint64_t index = writeCount - std::min<uint64_t>(writeCount, kRingSize); index < writeCount; ++index)
+			{
+				const Zone& zone = ring->zones[index & (kRingSize - 1u)];
+
+				stream << (isFirst ? "\n" : ",\n") << "{\"name\":";
+				WriteName(stream, zone.name);
+				stream << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->threadId
+					<< ",\"ts\":" << static_cast<double>(zone.beginNs - originNs) / 1000.0
+					<< ",\"dur\":" << static_cast<double>(zone.endNs - zone.beginNs) / 1000.0 << "}";
+				isFirst = false;
+			}
+		}
+
+		stream << "\n]}\n";
+		return static_cast<bool>(stream);
+	}
+
+	inline void TraceRecorder::Clear()
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard lock{ registry.mutex };
+
+		for (const std::shared_ptr<ThreadRing>& ring : registry.rings)
+		{
+			ring->writeCount.store(0u, std::memory_order_relaxed);
+		}
+	}
+
+	inline TraceRecorder::Registry& TraceRecorder::GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	inline TraceRecorder::ThreadRing& TraceRecorder::GetThreadRing()
+	{
+		// Ring is shared with the registry, so export still sees it after the thread is gone.
+		thread_local std::shared_ptr<ThreadRing> ring = [] {
+			Registry& registry = GetRegistry();
+			std::lock_guard lock{ registry.mutex };
+
+			std::shared_ptr<ThreadRing> result = std::make_shared<ThreadRing>();
+			result->threadId = static_cast<uint32_t>(registry.rings.size()) + 1u;
+			registry.rings.push_back(result);
+			return result;
+			}();
+
+		return *ring;
+	}
+
+	inline void TraceRecorder::WriteName(std::ofstream& stream, const char* name)
+	{
+		stream << '"';
+		for (; *name != '\0'; ++name)
+		{
+			if (*name == '"' || *name == '\\')
+			{
+				stream << '\\';
+			}
+			stream << *name;
+		}
+		stream << '"';
+	}
+} // Vessel
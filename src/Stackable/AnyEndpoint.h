@@ -0,0 +1,133 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "Endpoint.h"
+
+#include <type_traits>
+
+namespace Vessel
+{
+	/**
+	* AnyProvider is a non-owning type-erased provider for heterogeneous collections of flow endpoints.
+	*
+	* Calls go through a static table of function pointers, so prefer concrete types on hot paths.
+	*/
+	template<typename Model>
+	class AnyProvider final : public Provider<Model, AnyProvider<Model>>
+	{
+		// Public nested types.
+	public:
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+
+		// Life circle.
+	public:
+		template<typename ProviderType>
+			requires ProviderImplementation<ProviderType, Model> && (!std::is_same_v<ProviderType, AnyProvider>)
+		inline AnyProvider(ProviderType& provider) noexcept;
+
+		// Public static interface substitution.
+	public:
+		// Provider::GetProvidableId
+		inline ResourceId GetResourceId() const { return mTable->getResourceId(mObject); }
+
+		// Provider::GetAvailableUnits
+		inline Units GetAvailableUnits() const { return mTable->getAvailableUnits(mObject); }
+
+		// Provider::DecreaseUnits
+		inline void DecreaseUnits(Units units) { mTable->decreaseUnits(mObject, units); }
+
+		// Private nested types.
+	private:
+		struct Table
+		{
+			ResourceId(*getResourceId)(const void*);
+			Units(*getAvailableUnits)(const void*);
+			void(*decreaseUnits)(void*, Units);
+		};
+
+		template<typename ProviderType>
+		static constexpr Table kTable
+		{
+			[](const void* object) -> ResourceId { return static_cast<const ProviderType*>(object)->GetResourceId(); },
+			[](const void* object) -> Units { return static_cast<const ProviderType*>(object)->GetAvailableUnits(); },
+			[](void* object, Units units) { static_cast<ProviderType*>(object)->DecreaseUnits(units); },
+		};
+
+		// Private state.
+	private:
+		void* mObject;
+		const Table* mTable;
+	};
+
+	/**
+	* AnyConsumer is a non-owning type-erased consumer for heterogeneous collections of flow endpoints.
+	*
+	* Calls go through a static table of function pointers, so prefer concrete types on hot paths.
+	*/
+	template<typename Model>
+	class AnyConsumer final : public Consumer<Model, AnyConsumer<Model>>
+	{
+		// Public nested types.
+	public:
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+
+		// Life circle.
+	public:
+		template<typename ConsumerType>
+			requires ConsumerImplementation<ConsumerType, Model> && (!std::is_same_v<ConsumerType, AnyConsumer>)
+		inline AnyConsumer(ConsumerType& consumer) noexcept;
+
+		// Public static interface substitution.
+	public:
+		// Consumer::GetConsumableId
+		inline ResourceId GetResourceId() const { return mTable->getResourceId(mObject); }
+
+		// Consumer::GetRequestUnits
+		inline Units GetRequestUnits() const { return mTable->getRequestUnits(mObject); }
+
+		// Consumer::IncreaseUnits
+		inline void IncreaseUnits(Units units) { mTable->increaseUnits(mObject, units); }
+
+		// Private nested types.
+	private:
+		struct Table
+		{
+			ResourceId(*getResourceId)(const void*);
+			Units(*getRequestUnits)(const void*);
+			void(*increaseUnits)(void*, Units);
+		};
+
+		template<typename ConsumerType>
+		static constexpr Table kTable
+		{
+			[](const void* object) -> ResourceId { return static_cast<const ConsumerType*>(object)->GetResourceId(); },
+			[](const void* object) -> Units { return static_cast<const ConsumerType*>(object)->GetRequestUnits(); },
+			[](void* object, Units units) { static_cast<ConsumerType*>(object)->IncreaseUnits(units); },
+		};
+
+		// Private state.
+	private:
+		void* mObject;
+		const Table* mTable;
+	};
+
+	template<typename Model>
+	template<typename ProviderType>
+		requires ProviderImplementation<ProviderType, Model> && (!std::is_same_v<ProviderType, AnyProvider<Model>>)
+	inline AnyProvider<Model>::AnyProvider(ProviderType& provider) noexcept
+		: mObject{ &provider }
+		, mTable{ &kTable<ProviderType> }
+	{
+	}
+
+	template<typename Model>
+	template<typename ConsumerType>
+		requires ConsumerImplementation<ConsumerType, Model> && (!std::is_same_v<ConsumerType, AnyConsumer<Model>>)
+	inline AnyConsumer<Model>::AnyConsumer(ConsumerType& consumer) noexcept
+		: mObject{ &consumer }
+		, mTable{ &kTable<ConsumerType> }
+	{
+	}
+} // Vessel
@@ -4,14 +4,22 @@
 #include <algorithm>
 
 #include "ResourceModel.h"
+#include "Endpoint.h"
 
 namespace Vessel
 {
+	template<typename Model>
+	class Transfer;
+
 	/**
-	* 
+	* Container is a buffer of a single resource, which can take part in flows as provider and consumer.
+	*
+	* Literal containers have unlimited capacity, so they only carry resource into packages.
 	*/
 	template<typename Model>
 	struct Container final
+		: public Provider<Model, Container<Model>>
+		, public Consumer<Model, Container<Model>>
 	{
 		// Public nested types.
 	public:
@@ -26,6 +34,9 @@ namespace Vessel
 		// Construct with explicit ResourceId and Units.
 		inline Container(ResourceId id, Units amount) noexcept;
 
+		// Construct with explicit ResourceId, Units and capacity.
+		inline Container(ResourceId id, Units amount, Units capacity) noexcept;
+
 		// Delete copy constructor.
 		inline Container(const Container&) = delete;
 
@@ -47,6 +58,23 @@ namespace Vessel
 		inline operator std::pair<ResourceId, Units>() const { return Extract(); }
 		inline operator std::pair<const ResourceId, Units>() const { return Extract(); }
 
+		// Public static interface substitution.
+	public:
+		// Provider::GetProvidableId, Consumer::GetConsumableId
+		inline ResourceId GetResourceId() const { return mId; }
+
+		// Provider::GetAvailableUnits
+		inline Units GetAvailableUnits() const { return mAmount; }
+
+		// Consumer::GetRequestUnits
+		inline Units GetRequestUnits() const { return static_cast<Units>(mCapacity - mAmount); }
+
+		// Consumer::IncreaseUnits
+		inline void IncreaseUnits(Units units) { mAmount = std::min(static_cast<Units>(mAmount + units), mCapacity); }
+
+		// Provider::DecreaseUnits
+		inline void DecreaseUnits(Units units) { mAmount = std::max(static_cast<Units>(mAmount - units), Model::kZeroUnits); }
+
 		// Private friends.
 	private:
 		friend Transfer<Model>;
@@ -64,6 +92,7 @@ namespace Vessel
 	private:
 		ResourceId mId;
 		Units mAmount;
+		Units mCapacity = Model::kMaxCapacity;
 	};
 
 	template<typename Model>
@@ -80,11 +109,20 @@ namespace Vessel
 	{
 	}
 
+	template<typename Model>
+	inline Container<Model>::Container(ResourceId id, Units amount, Units capacity) noexcept
+		: mId{ id }
+		, mAmount{ std::min(amount, capacity) }
+		, mCapacity{ capacity }
+	{
+	}
+
 	template<typename Model>
 	inline Container<Model>::Container(Container&& other) noexcept
 	{
 		mId = std::exchange(other.mId, mId);
 		mAmount = std::exchange(other.mAmount, mAmount);
+		mCapacity = std::exchange(other.mCapacity, mCapacity);
 	}
 
 	template<typename Model>
@@ -92,6 +130,7 @@ namespace Vessel
 	{
 		mId = std::exchange(other.mId, mId);
 		mAmount = std::exchange(other.mAmount, mAmount);
+		mCapacity = std::exchange(other.mCapacity, mCapacity);
 
 		return *this;
 	}
@@ -0,0 +1,85 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "ResourceModel.h"
+
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace Vessel
+{
+	template<typename Model>
+	struct Container;
+
+	/**
+	* ContainerBatch keeps many containers as separate arrays of ids and amounts to fill a package in one pass.
+	*
+	* Behaviour:
+	* - Amounts of the same resource are summed and clamped by capacity once per resource.
+	*/
+	template<typename Model>
+	class ContainerBatch final
+	{
+		// Public nested types.
+	public:
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+
+		// Public interface.
+	public:
+		// Reserve space for containers.
+		inline void Reserve(size_t count);
+
+		// Add resource amount to the batch.
+		inline void Add(ResourceId id, Units amount);
+
+		// Add container to the batch.
+		inline void Add(Container<Model>&& container);
+
+		// Remove all containers.
+		inline void Clear();
+
+		// Get count of containers.
+		inline size_t GetSize() const { return mIds.size(); }
+
+		// Get ids of containers.
+		inline std::span<const ResourceId> GetIds() const { return mIds; }
+
+		// Get amounts of containers.
+		inline std::span<const Units> GetAmounts() const { return mAmounts; }
+
+		// Private state.
+	private:
+		std::vector<ResourceId> mIds;
+		std::vector<Units> mAmounts;
+	};
+
+	template<typename Model>
+	inline void ContainerBatch<Model>::Reserve(size_t count)
+	{
+		mIds.reserve(count);
+		mAmounts.reserve(count);
+	}
+
+	template<typename Model>
+	inline void ContainerBatch<Model>::Add(ResourceId id, Units amount)
+	{
+		mIds.push_back(id);
+		mAmounts.push_back(amount);
+	}
+
+	template<typename Model>
+	inline void ContainerBatch<Model>::Add(Container<Model>&& container)
+	{
+		auto [id, amount] = static_cast<std::pair<ResourceId, Units>>(container);
+		Add(id, amount);
+	}
+
+	template<typename Model>
+	inline void ContainerBatch<Model>::Clear()
+	{
+		mIds.clear();
+		mAmounts.clear();
+	}
+} // Vessel
@@ -0,0 +1,135 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "ResourceModel.h"
+
+#include <concepts>
+#include <type_traits>
+
+namespace Vessel
+{
+	template<typename Model, typename Derived>
+	class Provider;
+
+	template<typename Model, typename Derived>
+	class Consumer;
+
+	namespace
+	{
+		// Is the hook declared by the type itself, forwarder inherited from the base would call itself forever.
+		template<typename Hook, typename BaseHook>
+		constexpr bool IsOwnHook = !std::is_same_v<Hook, BaseHook>;
+	}
+
+	// Type which implements provider side of a flow.
+	template<typename T, typename Model>
+	concept ProviderImplementation = requires(T & provider, const T & constProvider, typename Model::Units units)
+	{
+		{ constProvider.GetResourceId() } -> std::same_as<typename Model::ResourceId>;
+		{ constProvider.GetAvailableUnits() } -> std::convertible_to<typename Model::Units>;
+		provider.DecreaseUnits(units);
+		requires IsOwnHook<decltype(&T::GetAvailableUnits), decltype(&Provider<Model, T>::GetAvailableUnits)>;
+		requires IsOwnHook<decltype(&T::DecreaseUnits), decltype(&Provider<Model, T>::DecreaseUnits)>;
+	};
+
+	// Type which implements consumer side of a flow.
+	template<typename T, typename Model>
+	concept ConsumerImplementation = requires(T & consumer, const T & constConsumer, typename Model::Units units)
+	{
+		{ constConsumer.GetResourceId() } -> std::same_as<typename Model::ResourceId>;
+		{ constConsumer.GetRequestUnits() } -> std::convertible_to<typename Model::Units>;
+		consumer.IncreaseUnits(units);
+		requires IsOwnHook<decltype(&T::GetRequestUnits), decltype(&Consumer<Model, T>::GetRequestUnits)>;
+		requires IsOwnHook<decltype(&T::IncreaseUnits), decltype(&Consumer<Model, T>::IncreaseUnits)>;
+	};
+
+	/**
+	* Provider is a static polymorphic base of everything that can supply units into a flow.
+	*
+	* Requirements:
+	* - Derived must implement GetResourceId, GetAvailableUnits and DecreaseUnits, missing hooks fail to compile instead of recursing.
+	*
+	* Calls are resolved at compile time and are inlined into Vessel<Model>::Transfer.
+	*/
+	template<typename Model, typename Derived>
+	class Provider
+	{
+		// Public nested types.
+	public:
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+
+		// Public interface.
+	public:
+		// Get id of provided resource.
+		inline ResourceId GetProvidableId() const { return Self().GetResourceId(); }
+
+		// Get units which can be provided.
+		inline Units GetAvailableUnits() const
+		{
+			static_assert(IsOwnHook<decltype(&Derived::GetAvailableUnits), decltype(&Provider::GetAvailableUnits)>, "Provider<M, D>: D must implement GetAvailableUnits.");
+			return Self().GetAvailableUnits();
+		}
+
+		// Reduce provided units.
+		inline void DecreaseUnits(Units units)
+		{
+			static_assert(IsOwnHook<decltype(&Derived::DecreaseUnits), decltype(&Provider::DecreaseUnits)>, "Provider<M, D>: D must implement DecreaseUnits.");
+			Self().DecreaseUnits(units);
+		}
+
+		// Access derived type.
+		inline Derived& Self() { return static_cast<Derived&>(*this); }
+		inline const Derived& Self() const { return static_cast<const Derived&>(*this); }
+
+		// Life circle.
+	protected:
+		Provider() = default;
+		~Provider() = default;
+	};
+
+	/**
+	* Consumer is a static polymorphic base of everything that can receive units from a flow.
+	*
+	* Requirements:
+	* - Derived must implement GetResourceId, GetRequestUnits and IncreaseUnits, missing hooks fail to compile instead of recursing.
+	*
+	* Calls are resolved at compile time and are inlined into Vessel<Model>::Transfer.
+	*/
+	template<typename Model, typename Derived>
+	class Consumer
+	{
+		// Public nested types.
+	public:
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+
+		// Public interface.
+	public:
+		// Get id of consumed resource.
+		inline ResourceId GetConsumableId() const { return Self().GetResourceId(); }
+
+		// Get units which can be consumed.
+		inline Units GetRequestUnits() const
+		{
+			static_assert(IsOwnHook<decltype(&Derived::GetRequestUnits), decltype(&Consumer::GetRequestUnits)>, "Consumer<M, D>: D must implement GetRequestUnits.");
+			return Self().GetRequestUnits();
+		}
+
+		// Receive consumed units.
+		inline void IncreaseUnits(Units units)
+		{
+			static_assert(IsOwnHook<decltype(&Derived::IncreaseUnits), decltype(&Consumer::IncreaseUnits)>, "Consumer<M, D>: D must implement IncreaseUnits.");
+			Self().IncreaseUnits(units);
+		}
+
+		// Access derived type.
+		inline Derived& Self() { return static_cast<Derived&>(*this); }
+		inline const Derived& Self() const { return static_cast<const Derived&>(*this); }
+
+		// Life circle.
+	protected:
+		Consumer() = default;
+		~Consumer() = default;
+	};
+} // Vessel
@@ -0,0 +1,54 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include <array>
+#include <type_traits>
+
+namespace Vessel
+{
+	/**
+	* EnumArray is a fixed array indexed by enum values, that replaces hash tables keyed by enum.
+	*
+	* Requirements:
+	* - Enum must be an enum with the last 'Count' value.
+	*/
+	template<typename Enum, typename Value>
+	class EnumArray final
+	{
+		// Public nested types.
+	public:
+		using Storage = std::array<Value, static_cast<size_t>(Enum::Count)>;
+		using Iterator = Storage::iterator;
+		using ConstIterator = Storage::const_iterator;
+
+		// Public constants.
+	public:
+		static constexpr size_t kSize = static_cast<size_t>(Enum::Count);
+
+		// Public interface.
+	public:
+		// Access value by enum.
+		inline constexpr Value& operator[](Enum id) { return mValues[static_cast<size_t>(id)]; }
+		inline constexpr const Value& operator[](Enum id) const { return mValues[static_cast<size_t>(id)]; }
+
+		// Set all values.
+		inline constexpr void Fill(const Value& value) { mValues.fill(value); }
+
+		// Iterate values in enum order.
+		inline constexpr Iterator begin() { return mValues.begin(); }
+		inline constexpr Iterator end() { return mValues.end(); }
+		inline constexpr ConstIterator begin() const { return mValues.cbegin(); }
+		inline constexpr ConstIterator end() const { return mValues.cend(); }
+
+		// Compare values.
+		inline constexpr bool operator==(const EnumArray& other) const = default;
+
+		// CT checks.
+	private:
+		static_assert(std::is_enum_v<Enum>, "EnumArray<E, V>: E must be an enum type.");
+
+		// Private state.
+	private:
+		Storage mValues{};
+	};
+} // Vessel
@@ -2,6 +2,10 @@
 #pragma once
 
 #include "ResourceModel.h"
+#include "Endpoint.h"
+
+#include <algorithm>
+#include <limits>
 
 namespace Vessel
 {
@@ -11,12 +15,6 @@ namespace Vessel
 		Changed = true,
 	};
 
-	template<typename ResourceModel>
-	class ProvideLimiter;
-
-	template<typename ResourceModel>
-	class ConsumeLimiter;
-
 	template<typename ResourceModel>
 	class Vessel final
 	{
@@ -27,29 +25,20 @@ namespace Vessel
 
 		// Public static interface.
 	public:
-		// Supply the consumer requested needs from the provider.
-		static Transferesult Transfer(Provider<ResourceModel>& provider, Consumer<ResourceModel>& consumer);
-
-		// Private friend.
-	private:
-		friend ProvideLimiter<ResourceModel>;
-		friend ConsumeLimiter<ResourceModel>;
+		// Supply the consumer requested needs from the provider, fully inlined for concrete endpoint types.
+		template<typename ProviderType, typename ConsumerType>
+			requires ProviderImplementation<ProviderType, ResourceModel> && ConsumerImplementation<ConsumerType, ResourceModel>
+		static Transferesult Transfer(Provider<ResourceModel, ProviderType>& provider, Consumer<ResourceModel, ConsumerType>& consumer);
 
 		// Private constants.
 	public:
 		static constexpr Units kZeroUnits = static_cast<Units>(0);
-
-		// Private static interface.
-	private:
-		// Increase resource.
-		static void IncreaseUnits(Consumer<ResourceModel>& consumer, Consumer<ResourceModel>::Units& supply);
-
-		// Reduce resource.
-		static void ReduceUnits(Provider<ResourceModel>& provider, Provider<ResourceModel>::Units& request);
 	};
 
 	template<typename ResourceModel>
-	inline Transferesult Vessel<ResourceModel>::Transfer(Provider<ResourceModel>& provider, Consumer<ResourceModel>& consumer)
+	template<typename ProviderType, typename ConsumerType>
+		requires ProviderImplementation<ProviderType, ResourceModel> && ConsumerImplementation<ConsumerType, ResourceModel>
+	inline Transferesult Vessel<ResourceModel>::Transfer(Provider<ResourceModel, ProviderType>& provider, Consumer<ResourceModel, ConsumerType>& consumer)
 	{
 		constexpr Units kEpsilonUnits = std::numeric_limits<Units>::epsilon();
 
@@ -62,39 +51,27 @@ namespace Vessel
 		const Units supplyUnits = provider.GetAvailableUnits();
 
 		const Units compromise = std::clamp(demandUnits, kZeroUnits, supplyUnits);
-		if (compromise < kEpsilonUnits)
+		if (compromise <= kZeroUnits || compromise < kEpsilonUnits)
 		{
 			return Transferesult::Unchanged;
 		}
 
 		consumer.IncreaseUnits(compromise);
-		provider.ReduceUnits(compromise);
+		provider.DecreaseUnits(compromise);
 
 		return Transferesult::Changed;
 	}
 
-	template<typename ResourceModel>
-	inline void Vessel<ResourceModel>::IncreaseUnits(Consumer<ResourceModel>& consumer, Consumer<ResourceModel>::Units& supply)
-	{
-		consumer.IncreaseUnits(supply);
-	}
-
-	template<typename ResourceModel>
-	inline void Vessel<ResourceModel>::ReduceUnits(Provider<ResourceModel>& provider, Provider<ResourceModel>::Units& request)
-	{
-		provider.ReduceUnits(request);
-	}
-
-	template<typename ResourceModel>
-	Consumer<ResourceModel>& operator<<(Consumer<ResourceModel>& consumer, Provider<ResourceModel>& provider)
+	template<typename ResourceModel, typename ConsumerType, typename ProviderType>
+	Consumer<ResourceModel, ConsumerType>& operator<<(Consumer<ResourceModel, ConsumerType>& consumer, Provider<ResourceModel, ProviderType>& provider)
 	{
 		Vessel<ResourceModel>::Transfer(provider, consumer);
 
 		return consumer;
 	}
 
-	template<typename ResourceModel>
-	Provider<ResourceModel>& operator>>(Provider<ResourceModel>& provider, Consumer<ResourceModel>& consumer)
+	template<typename ResourceModel, typename ProviderType, typename ConsumerType>
+	Provider<ResourceModel, ProviderType>& operator>>(Provider<ResourceModel, ProviderType>& provider, Consumer<ResourceModel, ConsumerType>& consumer)
 	{
 		Vessel<ResourceModel>::Transfer(provider, consumer);
 
@@ -1,19 +1,22 @@
 // (c) 2024 Acid7Beast. Use with wisdom.
 #pragma once
 
-#include "Transfer.h"
+#include "Container.h"
+#include "Endpoint.h"
+
+#include <algorithm>
 
 namespace Vessel
 {
-	template<typename Model>
-	struct Container;
-
 	template <typename Model>
 	class Limiter final
+		: public Provider<Model, Limiter<Model>>
+		, public Consumer<Model, Limiter<Model>>
 	{
 		// Public nested types.
 	public:
 		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
 
 		struct State
 		{
@@ -34,21 +37,22 @@ namespace Vessel
 		// Set bandwidth for any cases.
 		inline void SetUnitsBandwidth(float newValue = 1.f) { mState.bandwidth = newValue; }
 
-		// Public virtual interface substitution.
+		// Public static interface substitution.
 	public:
+		// Provider::GetProvidableId, Consumer::GetConsumableId
+		inline ResourceId GetResourceId() const { return mState.container.GetResourceId(); }
+
 		// Consumer::GetRequestedUnits
-		inline Units GetRequestUnits(Model model = {}) const override;
+		inline Units GetRequestUnits() const;
 
 		// Provider::GetAvailableUnits
-		inline Units GetAvailableUnits(Model model = {}) const override;
+		inline Units GetAvailableUnits() const;
 
-		// Private virtual interface substitution.
-	private:
 		// Consumer::IncreaseUnits
-		inline void IncreaseUnits(Units resourceRequest) override { Transfer<Model>::IncreaseUnits(mState.container, resourceRequest); }
+		inline void IncreaseUnits(Units resourceRequest) { mState.container.IncreaseUnits(resourceRequest); }
 
-		// Consumer::DecreaseUnits
-		inline void DecreaseUnits(Units resourceRequest) override { Transfer<Model>::DecreaseUnits(mState.container, resourceRequest); }
+		// Provider::DecreaseUnits
+		inline void DecreaseUnits(Units resourceRequest) { mState.container.DecreaseUnits(resourceRequest); }
 
 		// Private state.
 	private:
@@ -57,12 +61,12 @@ namespace Vessel
 
 	template<typename Model>
 	inline Limiter<Model>::Limiter(Container<Model>& container, Limiter::Units buffer, float bandwidth)
-		: mState{ bandwidth, buffer, container }
+		: mState{ buffer, bandwidth, container }
 	{
 	}
 
 	template<typename Model>
-	inline Limiter<Model>::Units Limiter<Model>::GetRequestUnits(Model model) const
+	inline Limiter<Model>::Units Limiter<Model>::GetRequestUnits() const
 	{
 		const Units possibleUnits = static_cast<Units>(mState.buffer * mState.bandwidth);
 		const Units availableUnits = mState.container.GetRequestUnits();
@@ -71,7 +75,7 @@ namespace Vessel
 	}
 	
 	template<typename Model>
-	inline Limiter<Model>::Units Limiter<Model>::GetAvailableUnits(Model model) const
+	inline Limiter<Model>::Units Limiter<Model>::GetAvailableUnits() const
 	{
 		const Units possibleUnits = static_cast<Units>(mState.buffer * mState.bandwidth);
 		const Units availableUnits = mState.container.GetAvailableUnits();
@@ -3,12 +3,29 @@
 
 #include "ResourceModel.h"
 #include "Transfer.h"
+#include "Watermark.h"
+#include "TransferLog.h"
+#include "EnumArray.h"
+#include "Relocation.h"
+#include "../Profiling/Trace.h"
 
 #include <unordered_map>
 #include <array>
+#include <memory>
+#include <ranges>
+#include <iterator>
 
 namespace Vessel
 {
+	// Range of (ResourceId, Units) pairs, that can be loaded into a package.
+	template<typename Range, typename ResourceId, typename Units>
+	concept ResourceStateRange = std::ranges::input_range<Range>
+		&& requires(std::ranges::range_reference_t<Range> state)
+	{
+		{ state.first } -> std::convertible_to<ResourceId>;
+		{ state.second } -> std::convertible_to<Units>;
+	};
+
 	/**
 	* Package represents a container of resources that can be Transferd between other packages.
 	*
@@ -21,11 +38,19 @@ namespace Vessel
 	* - ResourceId - type of resource enum identifier in the package.
 	* - Transfer - type of Transfer for this package.
 	* - ResourceTable - type of table that defines the current amount for each resource.
+	* - ResourceArray - type of enum-indexed array that defines the current amount for each resource without hashing.
+	* - WatermarkCallback - type of callback fired when amount of resource crosses a watermark.
 	*
 	* Constants:
 	* - kResourceCount - constant that defines how many resources can be managed by this package.
 	* - kAvailableBytes - constant that defines available bytes for storing amount of resources in cache line, excluding reference to capacity table.
 	* - kUseSBO - constant that defines whether to use small buffer optimization (SBO) for this package.
+	* - kTriviallyRelocatable - constant that defines whether package can be relocated with memcpy.
+	*
+	* Relocation:
+	* - By default moving a package steals resources as many as fit to capacities.
+	* - Model with 'static constexpr bool RelocatePackages = true;' in its tag truly moves packages instead,
+	*   so vectors of packages grow and sort without transfers.
 	*/
 	template<typename Model>
 	class Package final
@@ -39,6 +64,8 @@ namespace Vessel
 
 		template<size_t Count> using ArrayType = std::array<Units, Count>;
 		using ResourceTable = std::unordered_map<ResourceId, Units>;
+		using ResourceArray = EnumArray<ResourceId, Units>;
+		using WatermarkCallback = WatermarkTable<Model>::Callback;
 
 		// Public life cycle.
 	public:
@@ -51,10 +78,10 @@ namespace Vessel
 		// Stole resources from another package as many as fit to capacities.
 		inline Package& operator=(Package& other) noexcept;
 
-		// Copy table of capacities and stole resources from other package on constructing.
+		// Copy table of capacities and stole resources from other package on constructing, or relocate it.
 		inline Package(Package&& other) noexcept;
 
-		// Stole resources from other package on assignment as many as fit to capacities.
+		// Stole resources from other package on assignment as many as fit to capacities, or relocate it.
 		inline Package& operator=(Package&& other) noexcept;
 
 		// Destroy containers using SBO optimization.
@@ -65,9 +92,23 @@ namespace Vessel
 		// Deserialize state of this resource package for a save.
 		inline void LoadState(const ResourceTable& containerStates);
 
+		// Deserialize state of this resource package from enum-indexed array without hashing.
+		inline void LoadState(const ResourceArray& containerStates);
+
+		// Deserialize state of this resource package from any range of (ResourceId, Units) pairs, the last pair of resource wins.
+		template<typename Range> requires ResourceStateRange<Range, ResourceId, Units>
+		inline void LoadState(const Range& containerStates);
+
 		// Serialize state of this resource package from a save. 
 		inline void SaveState(ResourceTable& containerStates) const;
 
+		// Serialize state of this resource package into enum-indexed array, unmanaged resources are zeroed.
+		inline void SaveState(ResourceArray& containerStates) const;
+
+		// Serialize state of this resource package as (ResourceId, Units) pairs, returns iterator past the last written pair.
+		template<std::output_iterator<std::pair<ResourceId, Units>> Iterator>
+		inline Iterator SaveState(Iterator containerStates) const;
+
 		// Reset state of this resource package to default values.
 		inline void ResetState();
 
@@ -80,18 +121,44 @@ namespace Vessel
 		// Get list of managed resources.
 		inline std::vector<ResourceId> GetManagedResourceIds() const;
 
+		// Exchange whole state and capacities with another package without transfers.
+		inline void Swap(Package& other) noexcept;
+
+		// Fire callback when amount of resource falls below the threshold.
+		inline void AddLowWatermark(ResourceId resourceId, Units threshold, WatermarkCallback callback) requires Model::kWatchWatermarks;
+
+		// Fire callback when amount of resource rises above the threshold.
+		inline void AddHighWatermark(ResourceId resourceId, Units threshold, WatermarkCallback callback) requires Model::kWatchWatermarks;
+
+		// Remove all watermarks of resource.
+		inline void RemoveWatermarks(ResourceId resourceId) requires Model::kWatchWatermarks;
+
+		// Track the package in transfer log, the id is the index of package in replayed snapshot.
+		inline void SetLogId(uint32_t logId) requires Model::kLogTransfers { mLogId = logId; }
+
+		// Get id of the package in transfer log.
+		inline uint32_t GetLogId() const requires Model::kLogTransfers { return mLogId; }
+
 		// Fried classes.
 	public:
 		friend class Transfer;
+		friend class TransferReplay<Model>;
 
 		// Private constants.
 	private:
-		// Available bytes for storing amount of resources in cache line, excluding reference to capacity table.
-		static constexpr size_t kAvailableBytes = 64 - sizeof(void*);
+		// Available bytes for storing amount of resources in cache line, excluding reference to capacity table and watermarks.
+		static constexpr size_t kAvailableBytes = 64 - sizeof(void*)
+			- (Model::kWatchWatermarks ? sizeof(void*) : 0u)
+			- (Model::kLogTransfers ? sizeof(uint32_t) : 0u);
 
 		// Use small buffer optimization (SBO) if resource count is smaller than ResourceTable.
 		static constexpr bool kUseSBO = (Model::kResourceCount <= (kAvailableBytes / sizeof(Units)));
 
+		// Public constants.
+	public:
+		// Relocating package on SBO path is a plain copy of its bytes.
+		static constexpr bool kTriviallyRelocatable = Model::kRelocatePackages && kUseSBO;
+
 		// CT checks.
 	private:
 		static_assert(IsSpecializationOf<Model, ResourceModel>::value, "Package<T>: Model must be specialization of ResourceModel<Tag>.");
@@ -108,6 +175,17 @@ namespace Vessel
 		// Decrease amount of units in the package.
 		inline void DecreaseUnits(ResourceId resourceId, Units amount);
 
+		// Fire crossed watermarks, compiled out if model doesn't watch them.
+		inline void NotifyWatermarks(ResourceId resourceId, Units before, Units after) const;
+
+		// Take whole state of other package, leaving it empty.
+		inline void Relocate(Package& other) noexcept;
+
+		// Private nested types.
+	private:
+		using WatermarkState = std::conditional_t<Model::kWatchWatermarks, std::unique_ptr<WatermarkTable<Model>>, NoWatermarks>;
+		using LogIdState = std::conditional_t<Model::kLogTransfers, uint32_t, NoLogId>;
+
 		// Private state.
 	private:
 		union {
@@ -115,14 +193,30 @@ namespace Vessel
 			ResourceTable mMap;
 		};
 
+		// Watchers stay with the package they were registered on and are moved only by relocation.
+		VESSEL_NO_UNIQUE_ADDRESS WatermarkState mWatermarks;
+
+		// Log id isn't copied, every package has to be tracked explicitly, it is moved only by relocation.
+		VESSEL_NO_UNIQUE_ADDRESS LogIdState mLogId = LogIdState{ TransferLog<Model>::kUntrackedId };
+
 		// Private properties.
 	private:
-		const ResourceTable& mContainerProperties;
+		const ResourceTable* mContainerProperties;
 	};
 
+	template<typename Model>
+	struct IsTriviallyRelocatable<Package<Model>> : std::bool_constant<Package<Model>::kTriviallyRelocatable> {};
+
+	// Swap packages without transfers.
+	template<typename Model>
+	inline void swap(Package<Model>& left, Package<Model>& right) noexcept
+	{
+		left.Swap(right);
+	}
+
 	template<typename Model>
 	inline Package<Model>::Package(const Package<Model>::ResourceTable& containerProperties)
-		: mContainerProperties{ containerProperties }
+		: mContainerProperties{ &containerProperties }
 	{
 		if constexpr (kUseSBO)
 		{
@@ -176,21 +270,39 @@ namespace Vessel
 
 		if constexpr (Model::kCheckResourceFlow)
 		{
-			for (const auto& [resourceId, capacity] : mContainerProperties)
+			for (const auto& [resourceId, capacity] : *mContainerProperties)
 			{
 				assert(capacity > Model::kZeroUnits, "Capacity must be greater than zero.");
 				assert(capacity <= Model::kMaxCapacity, "Capacity must be less than or equal to maximum capacity.");
 			}
 		}
 
-		ResetState();
-		Transfer::Exchange(other, *this);
+		if constexpr (Model::kRelocatePackages)
+		{
+			Relocate(other);
+		}
+		else
+		{
+			ResetState();
+			Transfer::Exchange(other, *this);
+		}
 	}
 
 	template<typename Model>
 	inline Package<Model>& Package<Model>::operator=(Package&& other) noexcept
 	{
-		Transfer::Exchange(other, *this);
+		if constexpr (Model::kRelocatePackages)
+		{
+			if (this != &other)
+			{
+				mContainerProperties = other.mContainerProperties;
+				Relocate(other);
+			}
+		}
+		else
+		{
+			Transfer::Exchange(other, *this);
+		}
 
 		return *this;
 	}
@@ -211,7 +323,7 @@ namespace Vessel
 		{
 			bool check = Model::kCheckResourceFlow;
 			std::cout << check;
-			for (auto& [resourceId, _] : mContainerProperties)
+			for (auto& [resourceId, _] : *mContainerProperties)
 			{
 				Units amount = AccessResource(resourceId);
 				assert(amount == Model::kZeroUnits, "Resource wasn't utilized.");
@@ -222,10 +334,12 @@ namespace Vessel
 	template<typename Model>
 	inline void Package<Model>::LoadState(const Package<Model>::ResourceTable& containerStates)
 	{
+		const ScopedTraceZone zone{ "Package::LoadState" };
+
 		ResetState();
 
 		// Load new state.
-		for (auto& [resourceId, capacity] : mContainerProperties)
+		for (auto& [resourceId, capacity] : *mContainerProperties)
 		{
 			Units& amount = AccessResource(resourceId);
 			amount = std::min(amount, capacity);
@@ -241,12 +355,63 @@ namespace Vessel
 	template<typename Model>
 	inline void Package<Model>::SaveState(Package<Model>::ResourceTable& containerStates) const
 	{
-		for (auto [resourceId, _] : mContainerProperties)
+		for (auto [resourceId, _] : *mContainerProperties)
 		{
 			containerStates.emplace(resourceId, AccessResource(resourceId));
 		}
 	}
 
+	template<typename Model>
+	inline void Package<Model>::LoadState(const Package<Model>::ResourceArray& containerStates)
+	{
+		const ScopedTraceZone zone{ "Package::LoadState" };
+
+		ResetState();
+
+		for (auto& [resourceId, capacity] : *mContainerProperties)
+		{
+			AccessResource(resourceId) = std::min(containerStates[resourceId], capacity);
+		}
+	}
+
+	template<typename Model>
+	template<typename Range> requires ResourceStateRange<Range, typename Model::ResourceId, typename Model::Units>
+	inline void Package<Model>::LoadState(const Range& containerStates)
+	{
+		ResourceArray states;
+
+		for (const auto& state : containerStates)
+		{
+			states[static_cast<ResourceId>(state.first)] = static_cast<Units>(state.second);
+		}
+
+		LoadState(states);
+	}
+
+	template<typename Model>
+	inline void Package<Model>::SaveState(Package<Model>::ResourceArray& containerStates) const
+	{
+		containerStates.Fill(Model::kZeroUnits);
+
+		for (auto& [resourceId, _] : *mContainerProperties)
+		{
+			containerStates[resourceId] = AccessResource(resourceId);
+		}
+	}
+
+	template<typename Model>
+	template<std::output_iterator<std::pair<typename Model::ResourceId, typename Model::Units>> Iterator>
+	inline Iterator Package<Model>::SaveState(Iterator containerStates) const
+	{
+		for (auto& [resourceId, _] : *mContainerProperties)
+		{
+			*containerStates = std::pair<ResourceId, Units>{ resourceId, AccessResource(resourceId) };
+			++containerStates;
+		}
+
+		return containerStates;
+	}
+
 	template<typename Model>
 	inline void Package<Model>::ResetState()
 	{
@@ -256,15 +421,19 @@ namespace Vessel
 		}
 		else
 		{
-			mMap.clear();
+			// Entries of managed resources are kept, so only the first reset allocates and later loads reuse the nodes.
+			for (const auto& [resourceId, _] : *mContainerProperties)
+			{
+				mMap[resourceId] = Model::kZeroUnits;
+			}
 		}
 	}
 
 	template<typename Model>
 	inline Package<Model>::Units Package<Model>::GetRequestedUnits(ResourceId resourceId) const
 	{
-		auto iterProperties = mContainerProperties.find(resourceId);
-		if (iterProperties == mContainerProperties.end())
+		auto iterProperties = mContainerProperties->find(resourceId);
+		if (iterProperties == mContainerProperties->end())
 		{
 			return Model::kZeroUnits;
 		}
@@ -278,8 +447,8 @@ namespace Vessel
 	template<typename Model>
 	inline Package<Model>::Units Package<Model>::GetAvailableUnits(ResourceId resourceId) const
 	{
-		auto iterProperties = mContainerProperties.find(resourceId);
-		if (iterProperties == mContainerProperties.end())
+		auto iterProperties = mContainerProperties->find(resourceId);
+		if (iterProperties == mContainerProperties->end())
 		{
 			return Model::kZeroUnits;
 		}
@@ -291,11 +460,11 @@ namespace Vessel
 	inline std::vector<typename Package<Model>::ResourceId> Package<Model>::GetManagedResourceIds() const
 	{
 		std::vector<ResourceId> result;
-		result.reserve(mContainerProperties.size());
+		result.reserve(mContainerProperties->size());
 
 		std::transform(
-			mContainerProperties.cbegin(),
-			mContainerProperties.cend(),
+			mContainerProperties->cbegin(),
+			mContainerProperties->cend(),
 			std::back_inserter(result),
 			[](const auto& pair) -> ResourceId {
 				return pair.first;
@@ -305,6 +474,81 @@ namespace Vessel
 		return result;
 	}
 
+	template<typename Model>
+	inline void Package<Model>::AddLowWatermark(ResourceId resourceId, Units threshold, WatermarkCallback callback) requires Model::kWatchWatermarks
+	{
+		if (!mWatermarks)
+		{
+			mWatermarks = std::make_unique<WatermarkTable<Model>>();
+		}
+
+		mWatermarks->Add(resourceId, WatermarkEdge::Low, threshold, std::move(callback));
+	}
+
+	template<typename Model>
+	inline void Package<Model>::AddHighWatermark(ResourceId resourceId, Units threshold, WatermarkCallback callback) requires Model::kWatchWatermarks
+	{
+		if (!mWatermarks)
+		{
+			mWatermarks = std::make_unique<WatermarkTable<Model>>();
+		}
+
+		mWatermarks->Add(resourceId, WatermarkEdge::High, threshold, std::move(callback));
+	}
+
+	template<typename Model>
+	inline void Package<Model>::RemoveWatermarks(ResourceId resourceId) requires Model::kWatchWatermarks
+	{
+		if (!mWatermarks)
+		{
+			return;
+		}
+
+		mWatermarks->Remove(resourceId);
+		if (mWatermarks->IsEmpty())
+		{
+			mWatermarks.reset();
+		}
+	}
+
+	template<typename Model>
+	inline void Package<Model>::Swap(Package& other) noexcept
+	{
+		using std::swap;
+
+		if constexpr (kUseSBO)
+		{
+			swap(mArray, other.mArray);
+		}
+		else
+		{
+			swap(mMap, other.mMap);
+		}
+
+		swap(mWatermarks, other.mWatermarks);
+		swap(mLogId, other.mLogId);
+		swap(mContainerProperties, other.mContainerProperties);
+	}
+
+	template<typename Model>
+	inline void Package<Model>::Relocate(Package& other) noexcept
+	{
+		if constexpr (kUseSBO)
+		{
+			mArray = other.mArray;
+			other.ResetState();
+		}
+		else
+		{
+			// Missing entries read as zero, so the source is emptied without allocating new nodes.
+			mMap = std::move(other.mMap);
+			other.mMap.clear();
+		}
+
+		mWatermarks = std::move(other.mWatermarks);
+		mLogId = std::exchange(other.mLogId, LogIdState{ TransferLog<Model>::kUntrackedId });
+	}
+
 	template<typename Model>
 	inline Package<Model>::Units& Package<Model>::AccessResource(ResourceId id)
 	{
@@ -340,25 +584,43 @@ namespace Vessel
 	template<typename Model>
 	inline void Package<Model>::IncreaseUnits(ResourceId resourceId, Units amount)
 	{
-		auto iterProperties = mContainerProperties.find(resourceId);
-		if (iterProperties == mContainerProperties.end())
+		auto iterProperties = mContainerProperties->find(resourceId);
+		if (iterProperties == mContainerProperties->end())
 		{
 			return;
 		}
 
 		Units& currentAmount = AccessResource(resourceId);
+		const Units previousAmount = currentAmount;
 		currentAmount = std::min(currentAmount + amount, iterProperties->second);
+
+		NotifyWatermarks(resourceId, previousAmount, currentAmount);
 	}
 
 	template<typename Model>
 	inline void Package<Model>::DecreaseUnits(ResourceId resourceId, Units amount)
 	{
-		if (!mContainerProperties.contains(resourceId))
+		if (!mContainerProperties->contains(resourceId))
 		{
 			return;
 		}
 
 		Units& currentAmount = AccessResource(resourceId);
+		const Units previousAmount = currentAmount;
 		currentAmount = std::max(currentAmount - amount, Model::kZeroUnits);
+
+		NotifyWatermarks(resourceId, previousAmount, currentAmount);
+	}
+
+	template<typename Model>
+	inline void Package<Model>::NotifyWatermarks(ResourceId resourceId, Units before, Units after) const
+	{
+		if constexpr (Model::kWatchWatermarks)
+		{
+			if (mWatermarks) [[unlikely]]
+			{
+				mWatermarks->Notify(resourceId, before, after);
+			}
+		}
 	}
 } // Vessel
\ No newline at end of file
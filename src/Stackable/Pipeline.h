@@ -0,0 +1,125 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "ResourceModel.h"
+#include "Endpoint.h"
+
+#include <algorithm>
+#include <concepts>
+
+namespace Vessel
+{
+	// Flow stage which limits units passing through it.
+	template<typename T>
+	concept FlowStage = requires(const T & stage)
+	{
+		typename T::Model;
+		{ stage.GetLimit() } -> std::convertible_to<typename T::Model::Units>;
+	};
+
+	/**
+	* LimitStage caps units passing through it by a buffer scaled by bandwidth, the compile-time form of Filter and Limiter.
+	*/
+	template<typename ResourceModel>
+	struct LimitStage final
+	{
+		using Model = ResourceModel;
+		using Units = Model::Units;
+
+		Units buffer;
+		float bandwidth = 1.f;
+
+		// Get units which can pass the stage.
+		inline constexpr Units GetLimit() const { return static_cast<Units>(buffer * bandwidth); }
+	};
+
+	/**
+	* StageChain is a fused sequence of stages, it keeps only the tightest limit.
+	*/
+	template<typename ResourceModel>
+	struct StageChain final
+	{
+		using Model = ResourceModel;
+		using Units = Model::Units;
+
+		Units limit;
+
+		// Get units which can pass the whole chain.
+		inline constexpr Units GetLimit() const { return limit; }
+	};
+
+	/**
+	* Pipeline is a fused chain of stages in front of a flow endpoint.
+	*
+	* Behaviour:
+	* - Stages are folded into a single limit when the pipeline is composed.
+	* - Every query is one comparison against the endpoint, without intermediate references.
+	*
+	* Usage:
+	* - 'LimitStage<Model>{ 30 } | LimitStage<Model>{ 50, 0.5f } | container'.
+	*/
+	template<typename Model, typename Target>
+	class Pipeline final
+		: public Provider<Model, Pipeline<Model, Target>>
+		, public Consumer<Model, Pipeline<Model, Target>>
+	{
+		// Public nested types.
+	public:
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+
+		// Life circle.
+	public:
+		inline constexpr Pipeline(Units limit, Target& target) noexcept;
+
+		// Public interface.
+	public:
+		// Get units which can pass all stages.
+		inline constexpr Units GetLimit() const { return mLimit; }
+
+		// Public static interface substitution.
+	public:
+		// Provider::GetProvidableId, Consumer::GetConsumableId
+		inline ResourceId GetResourceId() const { return mTarget.GetResourceId(); }
+
+		// Provider::GetAvailableUnits
+		inline Units GetAvailableUnits() const { return std::min(mTarget.GetAvailableUnits(), mLimit); }
+
+		// Consumer::GetRequestUnits
+		inline Units GetRequestUnits() const { return std::min(mTarget.GetRequestUnits(), mLimit); }
+
+		// Consumer::IncreaseUnits
+		inline void IncreaseUnits(Units units) { mTarget.IncreaseUnits(units); }
+
+		// Provider::DecreaseUnits
+		inline void DecreaseUnits(Units units) { mTarget.DecreaseUnits(units); }
+
+		// Private state.
+	private:
+		Target& mTarget;
+		Units mLimit;
+	};
+
+	template<typename Model, typename Target>
+	inline constexpr Pipeline<Model, Target>::Pipeline(Units limit, Target& target) noexcept
+		: mTarget{ target }
+		, mLimit{ limit }
+	{
+	}
+
+	// Fuse two stages into one.
+	template<FlowStage Left, FlowStage Right>
+		requires std::same_as<typename Left::Model, typename Right::Model>
+	inline constexpr StageChain<typename Left::Model> operator|(const Left& left, const Right& right)
+	{
+		return { std::min(left.GetLimit(), right.GetLimit()) };
+	}
+
+	// Put fused stages in front of an endpoint.
+	template<FlowStage Stage, typename Target>
+		requires ProviderImplementation<Target, typename Stage::Model> || ConsumerImplementation<Target, typename Stage::Model>
+	inline constexpr Pipeline<typename Stage::Model, Target> operator|(const Stage& stage, Target& target)
+	{
+		return { stage.GetLimit(), target };
+	}
+} // Vessel
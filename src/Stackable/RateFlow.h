@@ -0,0 +1,168 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "ResourceModel.h"
+#include "Transfer.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Vessel
+{
+	template<typename Model>
+	class Package;
+
+	/**
+	* RateFlow is a continuous flow of a resource between two packages, like a pipe or a conveyor.
+	*/
+	template<typename Model>
+	struct RateFlow final
+	{
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+
+		Package<Model>* provider;
+		Package<Model>* consumer;
+		ResourceId resourceId;
+
+		// Units per second.
+		float rate;
+	};
+
+	/**
+	* RateFlowBatch integrates many rate flows at once, replacing per-edge transfers with manual chunk sizes.
+	*
+	* Behaviour:
+	* - Flows are kept as separate arrays of endpoints, resources and rates.
+	* - Integration computes budgets of all flows in one vectorizable pass, then applies them flow by flow.
+	* - Every budget is clamped by its own exchange in flow order, so flows sharing a package never create units.
+	* - Fractions of budgets which don't fit integer units are carried to the next step, so slow flows still move.
+	* - Stiff chains can be split into sub-steps, so units travel along several flows within one tick.
+	*/
+	template<typename Model>
+	class RateFlowBatch final
+	{
+		// Public nested types.
+	public:
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+
+		// Public interface.
+	public:
+		// Reserve space for flows.
+		inline void Reserve(size_t count);
+
+		// Add flow, returns its index.
+		inline size_t Add(const RateFlow<Model>& flow);
+
+		// Change units per second of the flow, negative rates are treated as closed.
+		inline void SetRate(size_t index, float rate) { mRates[index] = std::max(rate, 0.f); }
+
+		// Get units per second of the flow.
+		inline float GetRate(size_t index) const { return mRates[index]; }
+
+		// Get units moved by the flow during the last integration.
+		inline Units GetMovedUnits(size_t index) const { return mMoved[index]; }
+
+		// Get count of flows.
+		inline size_t GetSize() const { return mRates.size(); }
+
+		// Remove all flows.
+		inline void Clear();
+
+		// Move resources of all flows for elapsed seconds, split into equal sub-steps.
+		inline void Integrate(float deltaSeconds, size_t subSteps = 1u);
+
+		// Private interface.
+	private:
+		inline void Step(float deltaSeconds);
+
+		// Private state.
+	private:
+		std::vector<Package<Model>*> mProviders;
+		std::vector<Package<Model>*> mConsumers;
+		std::vector<ResourceId> mResourceIds;
+		std::vector<float> mRates;
+
+		// Scratch arrays reused between steps.
+		std::vector<Units> mBudgets;
+		std::vector<Units> mMoved;
+
+		// Fractions of budgets truncated by integer units, carried across steps.
+		std::vector<float> mCarries;
+	};
+
+	template<typename Model>
+	inline void RateFlowBatch<Model>::Reserve(size_t count)
+	{
+		mProviders.reserve(count);
+		mConsumers.reserve(count);
+		mResourceIds.reserve(count);
+		mRates.reserve(count);
+	}
+
+	template<typename Model>
+	inline size_t RateFlowBatch<Model>::Add(const RateFlow<Model>& flow)
+	{
+		mProviders.push_back(flow.provider);
+		mConsumers.push_back(flow.consumer);
+		mResourceIds.push_back(flow.resourceId);
+		mRates.push_back(std::max(flow.rate, 0.f));
+
+		mBudgets.resize(mRates.size());
+		mMoved.resize(mRates.size());
+		mCarries.resize(mRates.size());
+
+		return mRates.size() - 1u;
+	}
+
+	template<typename Model>
+	inline void RateFlowBatch<Model>::Clear()
+	{
+		mProviders.clear();
+		mConsumers.clear();
+		mResourceIds.clear();
+		mRates.clear();
+		mBudgets.clear();
+		mMoved.clear();
+		mCarries.clear();
+	}
+
+	template<typename Model>
+	inline void RateFlowBatch<Model>::Integrate(float deltaSeconds, size_t subSteps)
+	{
+		std::fill(mMoved.begin(), mMoved.end(), Model::kZeroUnits);
+
+		subSteps = std::max(subSteps, size_t{ 1 });
+		const float stepSeconds = deltaSeconds / static_cast<float>(subSteps);
+
+		for (size_t step = 0u; step < subSteps; ++step)
+		{
+			Step(stepSeconds);
+		}
+	}
+
+	template<typename Model>
+	inline void RateFlowBatch<Model>::Step(float deltaSeconds)
+	{
+		const size_t count = mRates.size();
+
+		// Budgets of all flows in one branchless pass over plain arrays, so compiler vectorizes it.
+		const float* rates = mRates.data();
+		float* carries = mCarries.data();
+		Units* budgets = mBudgets.data();
+
+		for (size_t index = 0u; index < count; ++index)
+		{
+			const float budget = rates[index] * deltaSeconds + carries[index];
+			budgets[index] = static_cast<Units>(budget);
+			carries[index] = budget - static_cast<float>(budgets[index]);
+		}
+
+		// Clamp is a scalar exchange per flow in order, so flows sharing a package see each other.
+		for (size_t index = 0u; index < count; ++index)
+		{
+			mMoved[index] += Transfer<Model>::Exchange(*mProviders[index], *mConsumers[index], mResourceIds[index], budgets[index]);
+		}
+	}
+} // Vessel
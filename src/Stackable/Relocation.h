@@ -0,0 +1,52 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace Vessel
+{
+	/**
+	* IsTriviallyRelocatable tells that moving an object to a new address and forgetting the old one
+	* is the same as copying its bytes.
+	*
+	* Types opt-in by specializing the trait, trivially copyable types are relocatable by default.
+	*/
+	template<typename T>
+	struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+	template<typename T>
+	constexpr bool IsTriviallyRelocatableValue = IsTriviallyRelocatable<T>::value;
+
+	/**
+	* Relocate objects of range to uninitialized destination, ending lifetime of the source objects.
+	*
+	* Requirements:
+	* - Source and destination ranges must not overlap.
+	* - Source objects must not be used or destroyed after relocation.
+	*
+	* Returns end of the destination range.
+	*/
+	template<typename T>
+	inline T* Relocate(T* first, T* last, T* destination) noexcept
+	{
+		const size_t count = static_cast<size_t>(last - first);
+
+		if constexpr (IsTriviallyRelocatableValue<T>)
+		{
+			std::memcpy(static_cast<void*>(destination), static_cast<const void*>(first), count * sizeof(T));
+		}
+		else
+		{
+			for (size_t index = 0u; index < count; ++index)
+			{
+				std::construct_at(destination + index, std::move(first[index]));
+				std::destroy_at(first + index);
+			}
+		}
+
+		return destination + count;
+	}
+} // Vessel
@@ -4,6 +4,13 @@
 #include <type_traits>
 #include <limits>
 
+// Empty members take no room, MSVC ignores the standard attribute and has its own spelling.
+#if defined(_MSC_VER)
+#define VESSEL_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define VESSEL_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
 namespace Vessel
 {
 	namespace
@@ -37,6 +44,33 @@ namespace Vessel
 			std::is_same_v<decltype(T::CheckResourceFlow), const bool>&&
 			T::CheckResourceFlow
 			>> : std::true_type {};
+
+		template <typename T, typename = void>
+		struct HasWatchWatermarks : std::false_type {};
+
+		template <typename T>
+		struct HasWatchWatermarks<T, std::enable_if_t<
+			std::is_same_v<decltype(T::WatchWatermarks), const bool>&&
+			T::WatchWatermarks
+			>> : std::true_type {};
+
+		template <typename T, typename = void>
+		struct HasLogTransfers : std::false_type {};
+
+		template <typename T>
+		struct HasLogTransfers<T, std::enable_if_t<
+			std::is_same_v<decltype(T::LogTransfers), const bool>&&
+			T::LogTransfers
+			>> : std::true_type {};
+
+		template <typename T, typename = void>
+		struct HasRelocatePackages : std::false_type {};
+
+		template <typename T>
+		struct HasRelocatePackages<T, std::enable_if_t<
+			std::is_same_v<decltype(T::RelocatePackages), const bool>&&
+			T::RelocatePackages
+			>> : std::true_type {};
 	}
 
 	template <class Tag>
@@ -61,6 +95,15 @@ namespace Vessel
 		// Should debugger check resource utilization?
 		static constexpr bool kCheckResourceFlow = HasCheckResourceFlow<Tag>::value;
 
+		// Should packages support low/high watermark watchers?
+		static constexpr bool kWatchWatermarks = HasWatchWatermarks<Tag>::value;
+
+		// Should transfers be recorded into the binary transfer log?
+		static constexpr bool kLogTransfers = HasLogTransfers<Tag>::value;
+
+		// Should packages be truly moved instead of stealing resources on move?
+		static constexpr bool kRelocatePackages = HasRelocatePackages<Tag>::value;
+
 		// CT checks.
 	private:
 		static_assert(std::is_enum_v<ResourceId>,
@@ -2,9 +2,16 @@
 #pragma once
 
 #include "ResourceModel.h"
+#include "TransferLog.h"
+#include "ContainerBatch.h"
+#include "EnumArray.h"
+#include "../Profiling/Trace.h"
 
 #include <optional>
 #include <algorithm>
+#include <array>
+#include <tuple>
+#include <type_traits>
 
 namespace Vessel
 {
@@ -27,7 +34,14 @@ namespace Vessel
 		// Public static interface.
 	public:
 		static void Exchange(Package<Model>& providerPackage, Package<Model>& consumerPackage);
+		static Units Exchange(Package<Model>& providerPackage, Package<Model>& consumerPackage, Model::ResourceId resourceId, Units limit);
 		static void Fill(Package<Model>& package, Container<Model>&& container);
+		static void Fill(Package<Model>& package, const ContainerBatch<Model>& batch);
+		static void Fill(Package<Model>& package, std::span<const typename Model::ResourceId> ids, std::span<const Units> amounts);
+
+		// Fill all containers in one pass, like a batch which size is known at compile time.
+		template<typename... Containers> requires (sizeof...(Containers) > 1u && (std::is_same_v<std::remove_cvref_t<Containers>, Container<Model>> && ...))
+		static void Fill(Package<Model>& package, Containers&&... containers);
 
 		// Private constants.
 	public:
@@ -37,11 +51,16 @@ namespace Vessel
 	private:
 		// Supply the consumer requested needs from the provider.
 		static std::optional<Units> TransferUnits(Model::Units provider, Model::Units consumer);
+
+		// Record the transfer if model logs transfers, compiled out otherwise.
+		static void Record(uint32_t providerId, const Package<Model>& consumerPackage, Model::ResourceId resourceId, Units amount);
 	};
 
 	template<typename Model>
 	void Transfer<Model>::Exchange(Package<Model>& providerPackage, Package<Model>& consumerPackage)
 	{
+		const ScopedTraceZone zone{ "Transfer::Exchange" };
+
 		for (typename Model::ResourceId resourceId : consumerPackage.GetManagedResourceIds())
 		{
 			typename Model::Units availableUnits = providerPackage.GetAvailableUnits(resourceId);
@@ -55,14 +74,104 @@ namespace Vessel
 
 			providerPackage.DecreaseUnits(resourceId, compromise.value_or(Model::kZeroUnits));
 			consumerPackage.IncreaseUnits(resourceId, compromise.value_or(Model::kZeroUnits));
+
+			if constexpr (Model::kLogTransfers)
+			{
+				Record(providerPackage.mLogId, consumerPackage, resourceId, compromise.value_or(Model::kZeroUnits));
+			}
 		}
 	}
 
+	template<typename Model>
+	inline typename Model::Units Transfer<Model>::Exchange(Package<Model>& providerPackage, Package<Model>& consumerPackage, Model::ResourceId resourceId, Units limit)
+	{
+		const ScopedTraceZone zone{ "Transfer::Exchange" };
+
+		const Units availableUnits = std::clamp(limit, kZeroUnits, providerPackage.GetAvailableUnits(resourceId));
+		const Units requiredUnits = consumerPackage.GetRequestedUnits(resourceId);
+
+		std::optional<Units> compromise = TransferUnits(availableUnits, requiredUnits);
+		if (!compromise.has_value())
+		{
+			return kZeroUnits;
+		}
+
+		providerPackage.DecreaseUnits(resourceId, compromise.value());
+		consumerPackage.IncreaseUnits(resourceId, compromise.value());
+
+		if constexpr (Model::kLogTransfers)
+		{
+			Record(providerPackage.mLogId, consumerPackage, resourceId, compromise.value());
+		}
+
+		return compromise.value();
+	}
+
 	template<typename Model>
 	inline void Transfer<Model>::Fill(Package<Model>& package, Container<Model>&& container)
 	{
 		auto [id, amount] = std::move(std::move(container).Extract());
 		package.IncreaseUnits(id, amount);
+
+		if constexpr (Model::kLogTransfers)
+		{
+			Record(TransferLog<Model>::kFillProviderId, package, id, amount);
+		}
+	}
+
+	template<typename Model>
+	inline void Transfer<Model>::Fill(Package<Model>& package, const ContainerBatch<Model>& batch)
+	{
+		Fill(package, batch.GetIds(), batch.GetAmounts());
+	}
+
+	template<typename Model>
+	inline void Transfer<Model>::Fill(Package<Model>& package, std::span<const typename Model::ResourceId> ids, std::span<const Units> amounts)
+	{
+		const ScopedTraceZone zone{ "Transfer::Fill" };
+
+		EnumArray<typename Model::ResourceId, Units> sums;
+		EnumArray<typename Model::ResourceId, bool> touched;
+
+		// Group by resource, so capacity is looked up and clamped once per resource.
+		for (size_t index = 0u; index < ids.size(); ++index)
+		{
+			sums[ids[index]] = static_cast<Units>(sums[ids[index]] + amounts[index]);
+			touched[ids[index]] = true;
+		}
+
+		for (size_t index = 0u; index < Model::kResourceCount; ++index)
+		{
+			const auto id = static_cast<typename Model::ResourceId>(index);
+			if (!touched[id])
+			{
+				continue;
+			}
+
+			package.IncreaseUnits(id, sums[id]);
+
+			if constexpr (Model::kLogTransfers)
+			{
+				Record(TransferLog<Model>::kFillProviderId, package, id, sums[id]);
+			}
+		}
+	}
+
+	template<typename Model>
+	template<typename... Containers> requires (sizeof...(Containers) > 1u && (std::is_same_v<std::remove_cvref_t<Containers>, Container<Model>> && ...))
+	inline void Transfer<Model>::Fill(Package<Model>& package, Containers&&... containers)
+	{
+		std::array<typename Model::ResourceId, sizeof...(Containers)> ids;
+		std::array<Units, sizeof...(Containers)> amounts;
+
+		size_t index = 0u;
+		const auto unpack = [&ids, &amounts, &index](const Container<Model>& container) {
+			std::tie(ids[index], amounts[index]) = static_cast<std::pair<typename Model::ResourceId, Units>>(container);
+			++index;
+			};
+		(unpack(containers), ...);
+
+		Fill(package, std::span<const typename Model::ResourceId>{ ids }, std::span<const Units>{ amounts });
 	}
 
 	template<typename Model>
@@ -79,12 +188,37 @@ namespace Vessel
 		return compromise;
 	}
 
-	template <typename Model>
+	template<typename Model>
+	inline void Transfer<Model>::Record(uint32_t providerId, const Package<Model>& consumerPackage, Model::ResourceId resourceId, Units amount)
+	{
+		// Untracked side stays in the record as a marker, so tracked packages replay into the same state.
+		const uint32_t consumerId = consumerPackage.mLogId;
+		const bool isOuterProvider = providerId == TransferLog<Model>::kUntrackedId || providerId == TransferLog<Model>::kFillProviderId;
+		if (isOuterProvider && consumerId == TransferLog<Model>::kUntrackedId)
+		{
+			return;
+		}
+
+		if (!TransferLog<Model>::IsOpen())
+		{
+			return;
+		}
+
+		TransferLog<Model>::Append({ providerId, consumerId, resourceId, amount });
+	}
+
+	template<typename Model>
 	Package<Model>& operator<<(Package<Model>& package, Container<Model>&& container) {
 		Transfer<Model>::Fill(package, std::move(container));
 		return package;
 	}
 
+	template <typename Model>
+	Package<Model>& operator<<(Package<Model>& package, const ContainerBatch<Model>& batch) {
+		Transfer<Model>::Fill(package, batch);
+		return package;
+	}
+
 	template<typename Model>
 	Package<Model>& operator>>(Package<Model>& providerPackage, Package<Model>& consumerPackage)
 	{
@@ -0,0 +1,431 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "ResourceModel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Vessel
+{
+	template<typename Model>
+	class Package;
+
+	/**
+	* TransferLog records every Transfer::Exchange and Transfer::Fill of tracked packages as compact binary records.
+	*
+	* Requirements:
+	* - Model must opt-in with 'static constexpr bool LogTransfers = true;' in its tag.
+	* - Package must be tracked with Package::SetLogId.
+	* - Transfer with an untracked side is recorded with kUntrackedId on that side, replay applies only the tracked side.
+	* - Transfers and fills between untracked packages only are not recorded.
+	*
+	* Layout:
+	* - Header: magic, version, size of units and resource count.
+	* - Record: provider id, consumer id, resource id and amount, packed without padding.
+	* - Footer: optional checksum of the final packages state written on close.
+	*
+	* Threading:
+	* - Records are appended to a per-thread buffer without any lock.
+	* - A full buffer is flushed to the file as one chunk, only flushing is serialized.
+	* - Other threads must call Flush or exit before Close, otherwise their tail is lost.
+	*/
+	template<typename Model>
+	class TransferLog final
+	{
+		// Public nested types.
+	public:
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+
+		struct Record
+		{
+			uint32_t providerId;
+			uint32_t consumerId;
+			ResourceId resourceId;
+			Units amount;
+		};
+
+		// Public constants.
+	public:
+		// Id of package which is not tracked by the log, marks the untracked side of a record.
+		static constexpr uint32_t kUntrackedId = std::numeric_limits<uint32_t>::max();
+
+		// Provider id of records made by Transfer::Fill.
+		static constexpr uint32_t kFillProviderId = kUntrackedId - 1u;
+
+		// Bytes of one record in the file.
+		static constexpr size_t kRecordBytes = sizeof(uint32_t) * 2u + sizeof(ResourceId) + sizeof(Units);
+
+		// Bytes of the file header.
+		static constexpr size_t kHeaderBytes = 8u;
+
+		// Bytes of the file footer.
+		static constexpr size_t kFooterBytes = sizeof(uint64_t) + 4u;
+
+		// Public static interface.
+	public:
+		// Start recording into the file, truncating it.
+		static bool Open(const std::filesystem::path& path);
+
+		// Flush the calling thread buffer and stop recording, optionally sealing the log with a state checksum.
+		static void Close(std::optional<uint64_t> checksum = {});
+
+		// Flush the calling thread buffer to the file.
+		static void Flush();
+
+		// Is log recording now.
+		static bool IsOpen() { return GetSink().isOpen.load(std::memory_order_relaxed); }
+
+		// Append the record to the calling thread buffer.
+		static void Append(const Record& record);
+
+		// Hash amounts of packages in order of their log ids.
+		static uint64_t Checksum(std::span<Package<Model>* const> packages);
+
+		// Private nested types.
+	private:
+		struct Sink
+		{
+			std::mutex mutex;
+			std::ofstream stream;
+			std::atomic<bool> isOpen = false;
+		};
+
+		struct ThreadBuffer
+		{
+			std::unique_ptr<char[]> bytes = std::make_unique<char[]>(kBufferBytes);
+			size_t size = 0u;
+
+			~ThreadBuffer() { TransferLog::FlushBuffer(*this); }
+		};
+
+		// Private constants.
+	private:
+		// Bytes of per-thread buffer, multiple of record size.
+		static constexpr size_t kBufferBytes = (size_t{ 1 } << 16) / kRecordBytes * kRecordBytes;
+
+		static constexpr char kHeaderMagic[4] = { 'V', 'T', 'L', 'G' };
+		static constexpr char kFooterMagic[4] = { 'V', 'T', 'C', 'K' };
+		static constexpr uint16_t kVersion = 1u;
+
+		// Private friends.
+	private:
+		template<typename> friend class TransferReplay;
+
+		// Private static interface.
+	private:
+		static Sink& GetSink();
+		static ThreadBuffer& GetThreadBuffer();
+		static void FlushBuffer(ThreadBuffer& buffer);
+
+		// Encode and decode records without padding.
+		static void EncodeRecord(char* bytes, const Record& record);
+		static Record DecodeRecord(const char* bytes);
+	};
+
+	/**
+	* TransferReplay applies a recorded log to a restored snapshot of packages.
+	*
+	* Packages are addressed by log id as index in the given span, missing ids are skipped.
+	* The file is read in large blocks of whole records, so replay runs close to sequential read speed.
+	*/
+	template<typename Model>
+	class TransferReplay final
+	{
+		// Public nested types.
+	public:
+		struct Result
+		{
+			size_t appliedRecords = 0u;
+			size_t skippedRecords = 0u;
+			uint64_t checksum = 0u;
+			std::optional<uint64_t> expectedChecksum;
+
+			// Does replayed state match the state sealed into the log.
+			bool IsDeterministic() const { return expectedChecksum.value_or(checksum) == checksum; }
+		};
+
+		// Public static interface.
+	public:
+		// Apply all records of the log, nothing is returned for a foreign or broken file.
+		static std::optional<Result> Replay(const std::filesystem::path& path, std::span<Package<Model>* const> packages);
+
+		// Private constants.
+	private:
+		// Bytes of one read block, multiple of record size.
+		static constexpr size_t kBlockBytes = (size_t{ 1 } << 23) / TransferLog<Model>::kRecordBytes * TransferLog<Model>::kRecordBytes;
+	};
+
+	// Empty log id of packages with disabled transfer log.
+	struct NoLogId final
+	{
+		constexpr NoLogId(uint32_t) noexcept {}
+	};
+
+	template<typename Model>
+	inline bool TransferLog<Model>::Open(const std::filesystem::path& path)
+	{
+		Sink& sink = GetSink();
+		std::lock_guard lock{ sink.mutex };
+
+		sink.stream = std::ofstream{ path, std::ios::binary | std::ios::trunc };
+		if (!sink.stream)
+		{
+			sink.isOpen = false;
+			return false;
+		}
+
+		char header[kHeaderBytes] = {};
+		std::memcpy(header, kHeaderMagic, sizeof(kHeaderMagic));
+		std::memcpy(header + 4, &kVersion, sizeof(kVersion));
+		header[6] = static_cast<char>(sizeof(Units));
+		header[7] = static_cast<char>(Model::kResourceCount);
+		sink.stream.write(header, kHeaderBytes);
+
+		sink.isOpen = true;
+		return true;
+	}
+
+	template<typename Model>
+	inline void TransferLog<Model>::Close(std::optional<uint64_t> checksum)
+	{
+		Flush();
+
+		Sink& sink = GetSink();
+		std::lock_guard lock{ sink.mutex };
+
+		if (!sink.isOpen)
+		{
+			return;
+		}
+
+		if (checksum.has_value())
+		{
+			char footer[kFooterBytes] = {};
+			std::memcpy(footer, &checksum.value(), sizeof(uint64_t));
+			std::memcpy(footer + sizeof(uint64_t), kFooterMagic, sizeof(kFooterMagic));
+			sink.stream.write(footer, kFooterBytes);
+		}
+
+		sink.stream.close();
+		sink.isOpen = false;
+	}
+
+	template<typename Model>
+	inline void TransferLog<Model>::Flush()
+	{
+		FlushBuffer(GetThreadBuffer());
+	}
+
+	template<typename Model>
+	inline void TransferLog<Model>::Append(const Record& record)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+		if (buffer.size + kRecordBytes > kBufferBytes) [[unlikely]]
+		{
+			FlushBuffer(buffer);
+		}
+
+		EncodeRecord(buffer.bytes.get() + buffer.size, record);
+		buffer.size += kRecordBytes;
+	}
+
+	template<typename Model>
+	inline uint64_t TransferLog<Model>::Checksum(std::span<Package<Model>* const> packages)
+	{
+		// FNV-1a over raw bytes of every amount.
+		constexpr uint64_t kOffsetBasis = 14695981039346656037ull;
+		constexpr uint64_t kPrime = 1099511628211ull;
+
+		uint64_t hash = kOffsetBasis;
+		for (const Package<Model>* package : packages)
+		{
+			if (package == nullptr)
+			{
+				continue;
+			}
+
+			for (size_t index = 0u; index < Model::kResourceCount; ++index)
+			{
+				const Units amount = package->GetAvailableUnits(static_cast<ResourceId>(index));
+
+				char bytes[sizeof(Units)];
+				std::memcpy(bytes, &amount, sizeof(Units));
+				for (char byte : bytes)
+				{
+					hash = (hash ^ static_cast<uint8_t>(byte)) * kPrime;
+				}
+			}
+		}
+
+		return hash;
+	}
+
+	template<typename Model>
+	inline TransferLog<Model>::Sink& TransferLog<Model>::GetSink()
+	{
+		static Sink sink;
+		return sink;
+	}
+
+	template<typename Model>
+	inline TransferLog<Model>::ThreadBuffer& TransferLog<Model>::GetThreadBuffer()
+	{
+		thread_local ThreadBuffer buffer;
+		return buffer;
+	}
+
+	template<typename Model>
+	inline void TransferLog<Model>::FlushBuffer(ThreadBuffer& buffer)
+	{
+		if (buffer.size == 0u)
+		{
+			return;
+		}
+
+		Sink& sink = GetSink();
+		std::lock_guard lock{ sink.mutex };
+
+		if (sink.isOpen)
+		{
+			sink.stream.write(buffer.bytes.get(), static_cast<std::streamsize>(buffer.size));
+		}
+
+		buffer.size = 0u;
+	}
+
+	template<typename Model>
+	inline void TransferLog<Model>::EncodeRecord(char* bytes, const Record& record)
+	{
+		std::memcpy(bytes, &record.providerId, sizeof(uint32_t));
+		std::memcpy(bytes + 4, &record.consumerId, sizeof(uint32_t));
+		std::memcpy(bytes + 8, &record.resourceId, sizeof(ResourceId));
+		std::memcpy(bytes + 8 + sizeof(ResourceId), &record.amount, sizeof(Units));
+	}
+
+	template<typename Model>
+	inline TransferLog<Model>::Record TransferLog<Model>::DecodeRecord(const char* bytes)
+	{
+		Record record;
+		std::memcpy(&record.providerId, bytes, sizeof(uint32_t));
+		std::memcpy(&record.consumerId, bytes + 4, sizeof(uint32_t));
+		std::memcpy(&record.resourceId, bytes + 8, sizeof(ResourceId));
+		std::memcpy(&record.amount, bytes + 8 + sizeof(ResourceId), sizeof(Units));
+
+		return record;
+	}
+
+	template<typename Model>
+	inline std::optional<typename TransferReplay<Model>::Result> TransferReplay<Model>::Replay(const std::filesystem::path& path, std::span<Package<Model>* const> packages)
+	{
+		using Log = TransferLog<Model>;
+
+		std::error_code error;
+		const size_t fileBytes = static_cast<size_t>(std::filesystem::file_size(path, error));
+		if (error || fileBytes < Log::kHeaderBytes)
+		{
+			return std::nullopt;
+		}
+
+		std::ifstream stream{ path, std::ios::binary };
+		if (!stream)
+		{
+			return std::nullopt;
+		}
+
+		// Validate header against the model.
+		char header[Log::kHeaderBytes];
+		stream.read(header, Log::kHeaderBytes);
+
+		uint16_t version = 0u;
+		std::memcpy(&version, header + 4, sizeof(version));
+		const bool isValidHeader = std::memcmp(header, Log::kHeaderMagic, sizeof(Log::kHeaderMagic)) == 0
+			&& version == Log::kVersion
+			&& static_cast<size_t>(header[6]) == sizeof(typename Model::Units)
+			&& static_cast<uint8_t>(header[7]) == Model::kResourceCount;
+
+		if (!isValidHeader)
+		{
+			return std::nullopt;
+		}
+
+		Result result;
+		size_t bodyBytes = fileBytes - Log::kHeaderBytes;
+
+		// Detect sealed footer.
+		if (bodyBytes >= Log::kFooterBytes && (bodyBytes - Log::kFooterBytes) % Log::kRecordBytes == 0u)
+		{
+			char footer[Log::kFooterBytes];
+			stream.seekg(static_cast<std::streamoff>(fileBytes - Log::kFooterBytes));
+			stream.read(footer, Log::kFooterBytes);
+			stream.seekg(static_cast<std::streamoff>(Log::kHeaderBytes));
+
+			if (std::memcmp(footer + sizeof(uint64_t), Log::kFooterMagic, sizeof(Log::kFooterMagic)) == 0)
+			{
+				uint64_t checksum = 0u;
+				std::memcpy(&checksum, footer, sizeof(uint64_t));
+				result.expectedChecksum = checksum;
+				bodyBytes -= Log::kFooterBytes;
+			}
+		}
+
+		if (bodyBytes % Log::kRecordBytes != 0u)
+		{
+			return std::nullopt;
+		}
+
+		// Apply records block by block.
+		std::vector<char> block(std::min(kBlockBytes, bodyBytes));
+		while (bodyBytes > 0u)
+		{
+			const size_t readBytes = std::min(block.size(), bodyBytes);
+			if (!stream.read(block.data(), static_cast<std::streamsize>(readBytes)))
+			{
+				return std::nullopt;
+			}
+
+			bodyBytes -= readBytes;
+
+			for (const char* bytes = block.data(); bytes != block.data() + readBytes; bytes += Log::kRecordBytes)
+			{
+				const typename Log::Record record = Log::DecodeRecord(bytes);
+
+				// Units of fills and untracked providers come from outside, units of untracked consumers leave the log.
+				const bool isOuterProvider = record.providerId == Log::kFillProviderId || record.providerId == Log::kUntrackedId;
+				const bool isOuterConsumer = record.consumerId == Log::kUntrackedId;
+				const bool hasProvider = isOuterProvider || (record.providerId < packages.size() && packages[record.providerId] != nullptr);
+				const bool hasConsumer = isOuterConsumer || (record.consumerId < packages.size() && packages[record.consumerId] != nullptr);
+				if (!hasProvider || !hasConsumer)
+				{
+					++result.skippedRecords;
+					continue;
+				}
+
+				if (!isOuterProvider)
+				{
+					packages[record.providerId]->DecreaseUnits(record.resourceId, record.amount);
+				}
+
+				if (!isOuterConsumer)
+				{
+					packages[record.consumerId]->IncreaseUnits(record.resourceId, record.amount);
+				}
+				++result.appliedRecords;
+			}
+		}
+
+		result.checksum = Log::Checksum(packages);
+
+		return result;
+	}
+} // Vessel
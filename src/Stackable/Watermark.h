@@ -0,0 +1,110 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#pragma once
+
+#include "ResourceModel.h"
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace Vessel
+{
+	enum class WatermarkEdge : bool
+	{
+		Low = false,
+		High = true,
+	};
+
+	/**
+	* WatermarkTable keeps low/high threshold watchers of a single package.
+	*
+	* Requirements:
+	* - Model must opt-in with 'static constexpr bool WatchWatermarks = true;' in its tag.
+	*
+	* Behaviour:
+	* - Low watcher fires when amount of the resource falls below the threshold.
+	* - High watcher fires when amount of the resource rises above the threshold.
+	* - Watchers are not fired while amount stays on the same side of the threshold.
+	*/
+	template<typename Model>
+	class WatermarkTable final
+	{
+		// Public nested types.
+	public:
+		using Units = Model::Units;
+		using ResourceId = Model::ResourceId;
+		using Callback = std::function<void(ResourceId, Units)>;
+
+		struct Watermark
+		{
+			WatermarkEdge edge;
+			Units threshold;
+			Callback callback;
+		};
+
+		// Public interface.
+	public:
+		// Register watcher of the resource.
+		inline void Add(ResourceId resourceId, WatermarkEdge edge, Units threshold, Callback callback);
+
+		// Remove all watchers of the resource.
+		inline void Remove(ResourceId resourceId);
+
+		// Is here no watchers at all.
+		inline bool IsEmpty() const { return mWatcherCount == 0u; }
+
+		// Fire watchers which thresholds were crossed by amount change, watchers may add or remove watchers of the package.
+		inline void Notify(ResourceId resourceId, Units before, Units after) const;
+
+		// Private state.
+	private:
+		std::array<std::vector<Watermark>, Model::kResourceCount> mWatermarks;
+		size_t mWatcherCount = 0u;
+	};
+
+	// Empty state of packages with disabled watermarks.
+	struct NoWatermarks final {};
+
+	template<typename Model>
+	inline void WatermarkTable<Model>::Add(ResourceId resourceId, WatermarkEdge edge, Units threshold, Callback callback)
+	{
+		mWatermarks[static_cast<size_t>(resourceId)].push_back({ edge, threshold, std::move(callback) });
+		++mWatcherCount;
+	}
+
+	template<typename Model>
+	inline void WatermarkTable<Model>::Remove(ResourceId resourceId)
+	{
+		std::vector<Watermark>& watermarks = mWatermarks[static_cast<size_t>(resourceId)];
+		mWatcherCount -= watermarks.size();
+		watermarks.clear();
+	}
+
+	template<typename Model>
+	inline void WatermarkTable<Model>::Notify(ResourceId resourceId, Units before, Units after) const
+	{
+		if (before == after)
+		{
+			return;
+		}
+
+		// Crossed callbacks are copied before any is fired, a callback may change the list or even destroy the table.
+		std::vector<Callback> crossedCallbacks;
+		for (const Watermark& watermark : mWatermarks[static_cast<size_t>(resourceId)])
+		{
+			const bool crossed = (watermark.edge == WatermarkEdge::Low)
+				? (before >= watermark.threshold && after < watermark.threshold)
+				: (before <= watermark.threshold && after > watermark.threshold);
+
+			if (crossed)
+			{
+				crossedCallbacks.push_back(watermark.callback);
+			}
+		}
+
+		for (const Callback& callback : crossedCallbacks)
+		{
+			callback(resourceId, after);
+		}
+	}
+} // Vessel
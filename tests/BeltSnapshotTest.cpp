@@ -0,0 +1,200 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <vector>
+
+#include <Polymorphic/BeltSnapshot.h>
+#include <Polymorphic/ConcurrentQueue.h>
+#include <Polymorphic/Drum.h>
+#include <Polymorphic/Queue.h>
+
+namespace
+{
+	constexpr size_t kItemCount = 16u;
+	constexpr size_t kCapacityCount = 10u;
+
+	struct Crate
+	{
+		int weight = 1;
+	};
+
+	using BeltInterface = ::Vessel::BeltInterface<Crate>;
+	using Drum = ::Vessel::Drum<Crate>;
+	using Queue = ::Vessel::Queue<Crate>;
+	using BeltSnapshot = ::Vessel::BeltSnapshot<Crate>;
+	using Exchanger = ::Vessel::Exchanger<Crate>;
+
+	class BeltSnapshotFixture : public ::testing::Test
+	{
+		// Life circle.
+	public:
+		BeltSnapshotFixture()
+		{
+			for (const Crate& crate : crates)
+			{
+				itemTable.push_back(&crate);
+			}
+		}
+
+		// Inheritable interface.
+	protected:
+		// Map crate to its index in the item table.
+		size_t GetIndex(const Crate& crate) const { return static_cast<size_t>(&crate - crates.data()); }
+
+		// Save the belt and pass it through the binary form.
+		BeltSnapshot PassBytes(const BeltInterface& belt) const
+		{
+			BeltSnapshot saved;
+			saved.Save(belt, [this](const Crate& crate) { return GetIndex(crate); });
+
+			std::vector<std::byte> bytes;
+			saved.Write(bytes);
+			EXPECT_EQ(bytes.size(), saved.GetByteSize());
+
+			BeltSnapshot loaded;
+			EXPECT_EQ(loaded.Read(bytes), bytes.size());
+			return loaded;
+		}
+
+		// Get addresses of slot items from the feeder end.
+		static std::vector<const Crate*> GetAddresses(const BeltInterface& belt)
+		{
+			std::vector<const Crate*> addresses;
+			for (const BeltInterface::OptionalRefWrapper& item : belt.GetSlotItems())
+			{
+				addresses.push_back(item.has_value() ? &item.value().get() : nullptr);
+			}
+			return addresses;
+		}
+
+		// Inheritable state.
+	protected:
+		std::vector<Crate> crates = std::vector<Crate>(kItemCount);
+		std::vector<BeltInterface::SlotPointer> itemTable;
+	};
+
+	TEST_F(BeltSnapshotFixture, DrumRoundTripTest)
+	{
+		Drum drum{ kCapacityCount, 3u };
+		drum.SetSlotItems({ crates[4], {}, crates[7], crates[7], {}, {}, crates[0] });
+		drum.NextBeltSlot(5u);
+
+		BeltSnapshot snapshot = PassBytes(drum);
+		EXPECT_EQ(snapshot.GetSlotCount(), kCapacityCount);
+		EXPECT_EQ(snapshot.GetFeederIndex(), 5u);
+		EXPECT_EQ(snapshot.GetItemCount(), 4u);
+
+		Drum restored{ kCapacityCount, 3u };
+		EXPECT_TRUE(snapshot.Restore(restored, itemTable));
+		EXPECT_EQ(GetAddresses(restored), GetAddresses(drum));
+		EXPECT_EQ(restored.GetItemCount(), drum.GetItemCount());
+
+		// Both drums keep turning the same way.
+		Exchanger::PushItem(drum, crates[9]);
+		Exchanger::PushItem(restored, crates[9]);
+		EXPECT_EQ(Exchanger::PullItem(drum).has_value(), Exchanger::PullItem(restored).has_value());
+		EXPECT_EQ(GetAddresses(restored), GetAddresses(drum));
+	}
+
+	TEST_F(BeltSnapshotFixture, QueueRoundTripTest)
+	{
+		// Front of the queue is moved around the ring and there is a hole inside.
+		Queue queue{ kCapacityCount };
+		for (size_t index = 0u; index < kCapacityCount; ++index)
+		{
+			queue.ExchangeReceiverSlot(crates[index]);
+		}
+		for (size_t index = 0u; index < 6u; ++index)
+		{
+			queue.ExchangeFeederSlot();
+		}
+		queue.ExchangeReceiverSlot(crates[12]);
+		queue.ExchangeReceiverSlot(crates[13]);
+		queue.ExchangeReceiverSlot({});
+
+		Queue restored{ kCapacityCount };
+		EXPECT_TRUE(PassBytes(queue).Restore(restored, itemTable));
+		EXPECT_EQ(GetAddresses(restored), GetAddresses(queue));
+		EXPECT_EQ(restored.GetItemCount(), 5u);
+
+		for (size_t index = 0u; index < 3u; ++index)
+		{
+			EXPECT_EQ(&Exchanger::PullItem(restored).value().get(), &Exchanger::PullItem(queue).value().get());
+		}
+	}
+
+	TEST_F(BeltSnapshotFixture, OrderedBeltTest)
+	{
+		// Belts without a plain slot buffer are saved in order from the feeder end.
+		::Vessel::ConcurrentQueue<Crate> concurrentQueue{ kCapacityCount };
+		concurrentQueue.ExchangeReceiverSlot(crates[2]);
+		concurrentQueue.ExchangeReceiverSlot(crates[3]);
+
+		BeltSnapshot snapshot = PassBytes(concurrentQueue);
+		EXPECT_EQ(snapshot.GetFeederIndex(), 0u);
+
+		Queue queue{ kCapacityCount };
+		EXPECT_TRUE(snapshot.Restore(queue, itemTable));
+		EXPECT_EQ(GetAddresses(queue), GetAddresses(concurrentQueue));
+	}
+
+	TEST_F(BeltSnapshotFixture, ManyBeltsTest)
+	{
+		std::vector<Drum> drums;
+		for (size_t index = 0u; index < 3u; ++index)
+		{
+			Drum& drum = drums.emplace_back(kCapacityCount);
+			drum.SetSlotItems({ crates[index], {}, crates[index + 1u] });
+			drum.NextBeltSlot(index);
+		}
+
+		std::vector<std::byte> bytes;
+		BeltSnapshot snapshot;
+		for (const Drum& drum : drums)
+		{
+			snapshot.Save(drum, [this](const Crate& crate) { return GetIndex(crate); });
+			snapshot.Write(bytes);
+		}
+
+		// One snapshot reads belts one after another.
+		std::span<const std::byte> rest = bytes;
+		for (const Drum& drum : drums)
+		{
+			const size_t byteCount = snapshot.Read(rest);
+			ASSERT_GT(byteCount, 0u);
+			rest = rest.subspan(byteCount);
+
+			Drum restored{ kCapacityCount };
+			EXPECT_TRUE(snapshot.Restore(restored, itemTable));
+			EXPECT_EQ(GetAddresses(restored), GetAddresses(drum));
+		}
+		EXPECT_TRUE(rest.empty());
+	}
+
+	TEST_F(BeltSnapshotFixture, BrokenSnapshotTest)
+	{
+		Drum drum{ kCapacityCount };
+		drum.SetSlotItems({ crates[kItemCount - 1u], crates[1] });
+
+		BeltSnapshot snapshot;
+		snapshot.Save(drum, [this](const Crate& crate) { return GetIndex(crate); });
+
+		std::vector<std::byte> bytes;
+		snapshot.Write(bytes);
+
+		// Truncated bytes.
+		BeltSnapshot loaded;
+		EXPECT_EQ(loaded.Read(std::span<const std::byte>{ bytes }.first(bytes.size() - 1u)), 0u);
+
+		// Bit of a slot behind the end of the belt.
+		std::vector<std::byte> broken = bytes;
+		broken[BeltSnapshot::kHeaderBytes + 1u] |= std::byte{ 0x80 };
+		EXPECT_EQ(loaded.Read(broken), 0u);
+
+		// Belt of other capacity and item table without some items.
+		ASSERT_EQ(loaded.Read(bytes), bytes.size());
+		Drum smallDrum{ kCapacityCount - 1u };
+		EXPECT_FALSE(loaded.Restore(smallDrum, itemTable));
+		EXPECT_FALSE(loaded.Restore(drum, std::span{ itemTable }.first(kItemCount - 1u)));
+	}
+} // namespace
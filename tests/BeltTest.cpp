@@ -3,8 +3,10 @@
 #include <format>
 #include <ostream>
 #include <numeric>
+#include <span>
 
 #include <Polymorphic/Drum.h>
+#include <Polymorphic/OwningDrum.h>
 #include <Polymorphic/Queue.h>
 
 namespace
@@ -37,6 +39,16 @@ namespace
 		std::string_view GetType() const override { return kExpansiveType; }
 	};
 
+	// Tag ammo by its type once, when it's placed on a typed belt.
+	struct AmmoTagger
+	{
+		static constexpr size_t kTypeCount = 2u;
+		static constexpr ::Vessel::TypeTag kIncendiaryTag = 0u;
+		static constexpr ::Vessel::TypeTag kExpansiveTag = 1u;
+
+		::Vessel::TypeTag operator()(const Ammo& ammo) const { return ammo.GetType() == kIncendiaryType ? kIncendiaryTag : kExpansiveTag; }
+	};
+
 	using BeltInterface = ::Vessel::BeltInterface<Ammo>;
 	using Drum = ::Vessel::Drum<Ammo>;
 	using Queue = ::Vessel::Queue<Ammo>;
@@ -105,6 +117,46 @@ namespace
 		const BeltInterface& mBelt;
 	};
 
+	// Receiver which reports more room than it takes, like a shared belt filled by another producer meanwhile.
+	class RefusingBelt final : public BeltInterface
+	{
+		// Life circle.
+	public:
+		RefusingBelt(size_t receivableCount, size_t takenCount)
+			: mReceivableCount{ receivableCount }
+			, mTakenCount{ takenCount }
+		{
+		}
+
+		// Public virtual interface substitution.
+	public:
+		OptionalRefWrapper ExchangeFeederSlot(OptionalRefWrapper item = {}) override { return mQueue.ExchangeFeederSlot(item); }
+		OptionalRefWrapper ExchangeReceiverSlot(OptionalRefWrapper item = {}) override { return mQueue.ExchangeReceiverSlot(item); }
+		bool IsEmptySlot(size_t offset = 0u) const override { return mQueue.IsEmptySlot(offset); }
+		size_t GetItemCount() const override { return mQueue.GetItemCount(); }
+		size_t GetSlotCount() const override { return mQueue.GetSlotCount(); }
+		size_t GetReceiverSlotOffset() const override { return mQueue.GetReceiverSlotOffset(); }
+		size_t GetReceivableCount() const override { return mReceivableCount; }
+
+		size_t PushReceiverItems(std::span<const SlotPointer> items) override
+		{
+			return mQueue.PushReceiverItems(items.first(std::min(items.size(), mTakenCount)));
+		}
+
+		// Inheritable virtual interface substitution.
+	protected:
+		void VisitSlotRuns(void* context, SlotRunCallback callback) const override {}
+
+		// Private state.
+	private:
+		Queue mQueue{ kCapacityCount };
+
+		// Private properties.
+	private:
+		const size_t mReceivableCount = 0u;
+		const size_t mTakenCount = 0u;
+	};
+
 	class BeltFixture : public ::testing::Test
 	{
 		// Inheritable state.
@@ -410,4 +462,411 @@ namespace
 			kIncendiaryType.data(),
 			});
 	}
-} // namespace
\ No newline at end of file
+
+	TEST_F(BeltFixture, SparseDrumTest)
+	{
+		constexpr size_t kSparseCapacity = 1024u;
+		Drum sparseDrum{ kSparseCapacity };
+		Queue magazine{ kCapacityCount };
+
+		// Only the last slot of a large drum is loaded.
+		sparseDrum.NextBeltSlot(kSparseCapacity - 1u);
+		sparseDrum.ExchangeFeederSlot(incendiaryRef);
+		sparseDrum.NextBeltSlot();
+
+		EXPECT_EQ(sparseDrum.FindOccupiedSlot(), kSparseCapacity - 1u);
+		EXPECT_EQ(sparseDrum.FindEmptySlot(), 0u);
+
+		magazine << sparseDrum;
+		EXPECT_EQ(sparseDrum.GetItemCount(), 0u);
+		EXPECT_FALSE(sparseDrum.FindOccupiedSlot().has_value());
+		EXPECT_EQ(magazine.GetItemCount(), 1u);
+		EXPECT_EQ(magazine.FindOccupiedSlot(), 0u);
+		EXPECT_EQ(magazine.FindEmptySlot(), 1u);
+
+		// Wrap around the end of the cyclic buffer.
+		drum.ExchangeFeederSlot(expansiveRef);
+		drum.NextBeltSlot(kCapacityCount - 1u);
+		drum.ExchangeFeederSlot(expansiveRef);
+		EXPECT_EQ(drum.FindEmptySlot(), 2u);
+		EXPECT_EQ(drum.FindOccupiedSlot(2u), kCapacityCount - 2u);
+
+		for (size_t iter = 0u; iter < kCapacityCount - 3u; ++iter)
+		{
+			EXPECT_FALSE(::Vessel::Exchanger<Ammo>::PushItem(drum, expansiveRef).has_value());
+		}
+
+		drum << magazine;
+		drumChecker.CheckState(kCapacityCount, kCapacityCount);
+		EXPECT_FALSE(drum.FindEmptySlot().has_value());
+		EXPECT_EQ(magazine.GetItemCount(), 0u);
+	}
+
+	TEST_F(BeltFixture, SlotItemsTest)
+	{
+		const std::vector<OptionalRefWrapper> slotItems{ {}, incendiaryRef, {}, expansiveRef };
+
+		// Load the drum state from a save and keep counting on exchanges.
+		drum.SetSlotItems(slotItems);
+		drumChecker.CheckOccupiedSlots({ 1u, 3u });
+		drumChecker.CheckState(2u, kCapacityCount);
+		drumChecker.CheckItemTypes({
+			{},
+			kIncendiaryType.data(),
+			{},
+			kExpansiveType.data(),
+			{},
+			{},
+			});
+
+		queue << drum;
+		drumChecker.CheckState(1u, kCapacityCount);
+		queueChecker.CheckState(1u, kCapacityCount);
+
+		// Holes inside the queue are kept, free slots at the end are dropped.
+		queue.SetSlotItems(slotItems);
+		queueChecker.CheckOccupiedSlots({ 1u, 3u });
+		queueChecker.CheckState(2u, kCapacityCount);
+
+		queue.SetSlotItems({});
+		queueChecker.CheckOccupiedSlots({});
+		queueChecker.CheckState(0u, kCapacityCount);
+	}
+
+	TEST_F(BeltFixture, FixedCapacityTest)
+	{
+		// Fixed belts must behave exactly as runtime sized ones, with or without index masking.
+		::Vessel::Drum<Ammo, kCapacityCount> fixedDrum;
+		::Vessel::Queue<Ammo, kCapacityCount> fixedQueue;
+		::Vessel::Drum<Ammo, 8u> maskedDrum;
+		::Vessel::Drum<Ammo> dynamicDrum{ 8u };
+
+		for (size_t iter = 0u; iter < kCapacityCount; ++iter)
+		{
+			const Ammo& ammo = iter % 2u == 0u ? static_cast<const Ammo&>(incendiaryRef) : static_cast<const Ammo&>(expansiveRef);
+			queue.ExchangeReceiverSlot(ammo);
+			fixedQueue.ExchangeReceiverSlot(ammo);
+			maskedDrum.ExchangeFeederSlot(ammo);
+			maskedDrum.NextBeltSlot(3u);
+			dynamicDrum.ExchangeFeederSlot(ammo);
+			dynamicDrum.NextBeltSlot(3u);
+		}
+
+		for (size_t iter = 0u; iter < kCapacityCount * 2u; ++iter)
+		{
+			drum << queue;
+			fixedDrum << fixedQueue;
+			fixedQueue << maskedDrum;
+			queue << dynamicDrum;
+		}
+
+		// Compare which objects lay in slots.
+		auto getAddresses = [](const BeltInterface& belt) {
+			std::vector<const Ammo*> addresses;
+			for (const OptionalRefWrapper& item : belt.GetSlotItems())
+			{
+				addresses.push_back(item.has_value() ? &item.value().get() : nullptr);
+			}
+			return addresses;
+			};
+
+		EXPECT_EQ(getAddresses(fixedDrum), getAddresses(drum));
+		EXPECT_EQ(getAddresses(fixedQueue), getAddresses(queue));
+		EXPECT_EQ(getAddresses(maskedDrum), getAddresses(dynamicDrum));
+		EXPECT_EQ(fixedDrum.GetItemCount(), drum.GetItemCount());
+		EXPECT_EQ(fixedQueue.GetSlotCount(), kCapacityCount);
+		EXPECT_EQ(maskedDrum.GetSlotCount(), 8u);
+	}
+
+	TEST_F(BeltFixture, BulkExchangeTest)
+	{
+		using Exchanger = ::Vessel::Exchanger<Ammo>;
+
+		std::vector<Incendiary> rounds(16u);
+
+		// Load first slots of the belt, leaving holes on every step, and turn it.
+		auto prepare = [&](BeltInterface& belt, size_t loadCount, size_t holeStep, size_t turn) {
+			std::vector<OptionalRefWrapper> slotItems(loadCount);
+			for (size_t index = 0u; index < loadCount; ++index)
+			{
+				if (holeStep == 0u || index % holeStep != 0u)
+				{
+					slotItems[index] = rounds[index];
+				}
+			}
+			belt.SetSlotItems(slotItems);
+			belt.NextBeltSlot(turn);
+			};
+
+		auto getAddresses = [](const BeltInterface& belt) {
+			std::vector<const Ammo*> addresses;
+			for (const OptionalRefWrapper& item : belt.GetSlotItems())
+			{
+				addresses.push_back(item.has_value() ? &item.value().get() : nullptr);
+			}
+			return addresses;
+			};
+
+		// Bulk exchanges must leave belts exactly as the same count of single exchanges.
+		auto checkExchanges = [&](BeltInterface& bulkReceiver, BeltInterface& bulkFeeder, BeltInterface& receiver, BeltInterface& feeder) {
+			for (size_t count : { 5u, 64u, 3u })
+			{
+				// Single exchanges drop items which don't fit, so only items which fit are compared.
+				const size_t singleCount = std::min({ count, feeder.GetItemCount(), receiver.GetSlotCount() - receiver.GetItemCount() });
+				for (size_t iter = 0u; iter < singleCount; ++iter)
+				{
+					receiver << feeder;
+				}
+
+				EXPECT_EQ(Exchanger::ExchangeN(bulkReceiver, bulkFeeder, count), singleCount);
+				EXPECT_EQ(getAddresses(bulkReceiver), getAddresses(receiver));
+				EXPECT_EQ(getAddresses(bulkFeeder), getAddresses(feeder));
+				EXPECT_EQ(bulkReceiver.GetItemCount(), receiver.GetItemCount());
+				EXPECT_EQ(bulkFeeder.GetItemCount(), feeder.GetItemCount());
+			}
+			};
+
+		// Turned drum with holes into a partially loaded queue.
+		Drum bulkDrum{ 16u }, singleDrum{ 16u };
+		Queue bulkQueue{ 12u }, singleQueue{ 12u };
+		prepare(bulkDrum, 16u, 3u, 5u);
+		prepare(singleDrum, 16u, 3u, 5u);
+		prepare(bulkQueue, 3u, 0u, 0u);
+		prepare(singleQueue, 3u, 0u, 0u);
+		checkExchanges(bulkQueue, bulkDrum, singleQueue, singleDrum);
+
+		// Queue with holes into a drum with the receiver slot in the middle.
+		Queue bulkHoleQueue{ 16u }, singleHoleQueue{ 16u };
+		Drum bulkOffsetDrum{ 16u, 3u }, singleOffsetDrum{ 16u, 3u };
+		prepare(bulkHoleQueue, 14u, 4u, 0u);
+		prepare(singleHoleQueue, 14u, 4u, 0u);
+		prepare(bulkOffsetDrum, 6u, 2u, 7u);
+		prepare(singleOffsetDrum, 6u, 2u, 7u);
+		checkExchanges(bulkOffsetDrum, bulkHoleQueue, singleOffsetDrum, singleHoleQueue);
+
+		// Fixed drums wrap runs around the end of the buffer.
+		::Vessel::Drum<Ammo, 8u> bulkFixedFeeder, singleFixedFeeder, bulkFixedReceiver, singleFixedReceiver;
+		prepare(bulkFixedFeeder, 8u, 3u, 2u);
+		prepare(singleFixedFeeder, 8u, 3u, 2u);
+		prepare(bulkFixedReceiver, 4u, 2u, 1u);
+		prepare(singleFixedReceiver, 4u, 2u, 1u);
+		checkExchanges(bulkFixedReceiver, bulkFixedFeeder, singleFixedReceiver, singleFixedFeeder);
+
+		// Items the receiver can't reach a free slot for are never pulled.
+		Queue holeQueue{ 4u };
+		holeQueue.SetSlotItems({ rounds[0], {}, rounds[2], rounds[3] });
+		drum.SetSlotItems({ incendiaryRef, expansiveRef });
+
+		EXPECT_EQ(Exchanger::ExchangeN(holeQueue, drum, 2u), 0u);
+		drumChecker.CheckState(2u, kCapacityCount);
+		EXPECT_EQ(holeQueue.GetItemCount(), 3u);
+	}
+
+	TEST_F(BeltFixture, ReturnTest)
+	{
+		using Exchanger = ::Vessel::Exchanger<Ammo>;
+
+		std::vector<Incendiary> rounds(kCapacityCount);
+
+		// Pull the rest of the belt item by item.
+		auto pullAll = [](BeltInterface& belt) {
+			std::vector<const Ammo*> items;
+			for (OptionalRefWrapper item = Exchanger::PullItem(belt); item.has_value(); item = Exchanger::PullItem(belt))
+			{
+				items.push_back(&item.value().get());
+			}
+			return items;
+			};
+
+		// Full drum gets back items the receiver refuses, in the order they were pulled.
+		::Vessel::Drum<Ammo> fullDrum{ 4u };
+		fullDrum.SetSlotItems({ rounds[0], rounds[1], rounds[2], rounds[3] });
+
+		RefusingBelt drumReceiver{ 3u, 1u };
+		EXPECT_EQ(Exchanger::ExchangeN(drumReceiver, fullDrum, 3u), 1u);
+		EXPECT_EQ(fullDrum.GetItemCount(), 3u);
+		EXPECT_EQ(drumReceiver.GetItemCount(), 1u);
+		EXPECT_EQ(pullAll(fullDrum), (std::vector<const Ammo*>{ &rounds[1], &rounds[2], &rounds[3] }));
+
+		// Drum with gaps between runs closes them and keeps the order.
+		drum.SetSlotItems({ rounds[0], {}, rounds[2], {}, rounds[4], rounds[5] });
+
+		RefusingBelt gapReceiver{ 4u, 1u };
+		EXPECT_EQ(Exchanger::ExchangeN(gapReceiver, drum, 4u), 1u);
+		drumChecker.CheckState(3u, kCapacityCount);
+		EXPECT_EQ(pullAll(drum), (std::vector<const Ammo*>{ &rounds[2], &rounds[4], &rounds[5] }));
+
+		// Queue gets them back in front of the rest.
+		queue.SetSlotItems({ rounds[0], rounds[1], rounds[2], rounds[3], rounds[4], rounds[5] });
+
+		RefusingBelt queueReceiver{ 5u, 2u };
+		EXPECT_EQ(Exchanger::ExchangeN(queueReceiver, queue, 5u), 2u);
+		queueChecker.CheckState(4u, kCapacityCount);
+		EXPECT_EQ(pullAll(queue), (std::vector<const Ammo*>{ &rounds[2], &rounds[3], &rounds[4], &rounds[5] }));
+	}
+
+	TEST_F(BeltFixture, SlotViewTest)
+	{
+		using SlotPointer = BeltInterface::SlotPointer;
+
+		// Gather visited slots and count runs.
+		auto visit = [](const BeltInterface& belt, size_t& runCount) {
+			std::vector<const Ammo*> slots;
+			runCount = 0u;
+			belt.VisitSlots([&](std::span<const SlotPointer> run) {
+				slots.insert(slots.end(), run.begin(), run.end());
+				++runCount;
+				});
+			return slots;
+			};
+
+		// Turned drum is seen from the feeder as the tail of its buffer followed by the head.
+		drum.SetSlotItems({ incendiaryRef, {}, expansiveRef });
+		drum.NextBeltSlot(2u);
+
+		size_t runCount = 0u;
+		const std::vector<const Ammo*> drumSlots = visit(drum, runCount);
+		EXPECT_EQ(runCount, 2u);
+		EXPECT_EQ(drumSlots, (std::vector<const Ammo*>{ &expansiveRef, nullptr, nullptr, nullptr, &incendiaryRef, nullptr }));
+
+		// Queue front moves around the ring, free slots behind the back are not visited.
+		for (size_t iter = 0u; iter < kCapacityCount - 1u; ++iter)
+		{
+			queue.ExchangeReceiverSlot(incendiaryRef);
+		}
+		for (size_t iter = 0u; iter < 3u; ++iter)
+		{
+			queue.ExchangeFeederSlot();
+		}
+		queue.ExchangeReceiverSlot(expansiveRef);
+		queue.ExchangeReceiverSlot(expansiveRef);
+
+		const std::vector<const Ammo*> queueSlots = visit(queue, runCount);
+		EXPECT_EQ(runCount, 2u);
+		EXPECT_EQ(queueSlots, (std::vector<const Ammo*>{ &incendiaryRef, &incendiaryRef, &expansiveRef, &expansiveRef }));
+		EXPECT_EQ(queue.GetSlotItems().size(), kCapacityCount);
+	}
+
+	TEST_F(BeltFixture, TypedDrumTest)
+	{
+		using TypedDrum = ::Vessel::TypedDrum<Ammo, AmmoTagger>;
+		constexpr ::Vessel::TypeTag kIncendiaryTag = AmmoTagger::kIncendiaryTag;
+		constexpr ::Vessel::TypeTag kExpansiveTag = AmmoTagger::kExpansiveTag;
+
+		// Wide enough to span several tag words.
+		TypedDrum typedDrum{ 20u };
+		std::vector<OptionalRefWrapper> slotItems(20u);
+		for (size_t index = 0u; index < slotItems.size(); ++index)
+		{
+			if (index % 5u == 3u)
+			{
+				slotItems[index] = incendiaryRef;
+			}
+			else if (index % 2u == 0u)
+			{
+				slotItems[index] = expansiveRef;
+			}
+		}
+		typedDrum.SetSlotItems(slotItems);
+
+		EXPECT_EQ(typedDrum.GetTypeCount(kIncendiaryTag), 4u);
+		EXPECT_EQ(typedDrum.GetTypeCount(kExpansiveTag), 8u);
+		EXPECT_EQ(typedDrum.FindTypeSlot(kIncendiaryTag), 3u);
+		EXPECT_EQ(typedDrum.FindTypeSlot(kIncendiaryTag, 4u), 4u);
+		EXPECT_EQ(typedDrum.FindTypeSlot(kExpansiveTag, 19u), 1u);
+
+		// Tags out of types, the free slot one too, have no slots.
+		EXPECT_EQ(typedDrum.GetTypeCount(::Vessel::kFreeSlotTag), 0u);
+		EXPECT_FALSE(typedDrum.FindTypeSlot(::Vessel::kFreeSlotTag).has_value());
+		EXPECT_FALSE(typedDrum.FindTypeSlot(static_cast<::Vessel::TypeTag>(AmmoTagger::kTypeCount)).has_value());
+
+		// Counters follow single and bulk exchanges.
+		queue << typedDrum;
+		EXPECT_EQ(typedDrum.GetTypeCount(kExpansiveTag), 7u);
+		EXPECT_EQ(typedDrum.FindTypeSlot(kIncendiaryTag), 2u);
+
+		EXPECT_EQ(::Vessel::Exchanger<Ammo>::ExchangeN(queue, typedDrum, 5u), 5u);
+		EXPECT_EQ(typedDrum.GetTypeCount(kIncendiaryTag), 2u);
+		EXPECT_EQ(typedDrum.GetTypeCount(kExpansiveTag), 4u);
+		EXPECT_EQ(typedDrum.FindTypeSlot(kIncendiaryTag), 4u);
+
+		EXPECT_EQ(::Vessel::Exchanger<Ammo>::ExchangeN(typedDrum, queue, kCapacityCount), kCapacityCount);
+		EXPECT_EQ(typedDrum.GetTypeCount(kIncendiaryTag), 4u);
+		EXPECT_EQ(typedDrum.GetTypeCount(kExpansiveTag), 8u);
+
+		// No items of the type left.
+		::Vessel::TypedDrum<Ammo, AmmoTagger, 8u> fixedDrum;
+		fixedDrum.SetSlotItems({ expansiveRef, {}, expansiveRef });
+		EXPECT_EQ(fixedDrum.GetTypeCount(kIncendiaryTag), 0u);
+		EXPECT_FALSE(fixedDrum.FindTypeSlot(kIncendiaryTag).has_value());
+		EXPECT_EQ(fixedDrum.FindTypeSlot(kExpansiveTag, 1u), 1u);
+	}
+
+	TEST_F(BeltFixture, InlineItemTest)
+	{
+		// Count alive copies of the item.
+		struct Counted : Ammo
+		{
+			explicit Counted(int& alive) : mAlive{ &alive } { ++*mAlive; }
+			Counted(const Counted& other) : mAlive{ other.mAlive } { ++*mAlive; }
+			Counted(Counted&& other) noexcept : mAlive{ other.mAlive } { ++*mAlive; }
+			~Counted() override { --*mAlive; }
+
+			std::string_view GetType() const override { return "Counted"; }
+
+			int* mAlive;
+		};
+
+		using Item = ::Vessel::InlineItem<Ammo>;
+		int alive = 0;
+		{
+			Item item{ std::in_place_type<Counted>, alive };
+			EXPECT_EQ(alive, 1);
+			EXPECT_EQ(item->GetType(), "Counted");
+
+			Item copy = item;
+			Item moved = std::move(item);
+			EXPECT_EQ(alive, 2);
+			EXPECT_FALSE(item.HasValue());
+			EXPECT_EQ(moved->GetType(), "Counted");
+
+			copy = Item{ Incendiary{} };
+			EXPECT_EQ(alive, 1);
+			EXPECT_EQ(copy->GetType(), kIncendiaryType);
+		}
+		EXPECT_EQ(alive, 0);
+
+		// Items are stored inline together with the table of operations.
+		EXPECT_EQ(sizeof(Item), 32u);
+		EXPECT_FALSE(Item::kFits<std::string>);
+	}
+
+	TEST_F(BeltFixture, OwningDrumTest)
+	{
+		using OwningDrum = ::Vessel::OwningDrum<Ammo>;
+		OwningDrum owningDrum{ kCapacityCount };
+		OwningDrum otherDrum{ kCapacityCount, 2u };
+
+		for (size_t iter = 0u; iter < kCapacityCount + 1u; ++iter)
+		{
+			OwningDrum::Item rest = iter % 2u == 0u ? owningDrum.PushItem(Incendiary{}) : owningDrum.PushItem(Expansive{});
+			EXPECT_EQ(rest.HasValue(), iter == kCapacityCount);
+		}
+		EXPECT_EQ(owningDrum.GetItemCount(), kCapacityCount);
+		EXPECT_FALSE(owningDrum.FindEmptySlot().has_value());
+
+		// Items are moved between drums by value, keeping their own types.
+		EXPECT_EQ(owningDrum.ExchangeFeederSlot()->GetType(), kExpansiveType);
+		EXPECT_FALSE(otherDrum.PushItem(owningDrum.PullItem()).HasValue());
+		EXPECT_FALSE(otherDrum.PushItem(owningDrum.PullItem()).HasValue());
+		EXPECT_EQ(owningDrum.GetItemCount(), kCapacityCount - 3u);
+		EXPECT_EQ(otherDrum.GetItemCount(), 2u);
+		EXPECT_EQ(otherDrum.GetSlotItem()->GetType(), kIncendiaryType);
+		EXPECT_EQ(otherDrum.GetSlotItem(1u)->GetType(), kExpansiveType);
+		EXPECT_EQ(otherDrum.GetSlotItem(2u), nullptr);
+
+		std::vector<std::string_view> types;
+		owningDrum.VisitItems([&types](const Ammo& ammo) { types.push_back(ammo.GetType()); });
+		EXPECT_EQ(types, (std::vector<std::string_view>{ kIncendiaryType, kExpansiveType, kIncendiaryType }));
+	}
+} // namespace
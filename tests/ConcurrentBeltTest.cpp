@@ -0,0 +1,205 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <Polymorphic/ConcurrentQueue.h>
+#include <Polymorphic/SharedQueue.h>
+
+namespace
+{
+	constexpr size_t kCapacityCount = 6u;
+
+	// Round of ammo identified by its serial number.
+	struct Round
+	{
+		size_t serial = 0u;
+	};
+
+	using ConcurrentQueue = ::Vessel::ConcurrentQueue<Round>;
+	using SharedQueue = ::Vessel::SharedQueue<Round>;
+	using Exchanger = ::Vessel::Exchanger<Round>;
+	using OptionalRefWrapper = ConcurrentQueue::OptionalRefWrapper;
+
+	class ConcurrentBeltFixture : public ::testing::Test
+	{
+		// Inheritable interface.
+	protected:
+		void SetUp() override
+		{
+			rounds.resize(1u << 16u);
+			for (size_t index = 0u; index < rounds.size(); ++index)
+			{
+				rounds[index].serial = index;
+			}
+		}
+
+		// Inheritable state.
+	protected:
+		ConcurrentQueue belt{ kCapacityCount };
+		SharedQueue sharedBelt{ kCapacityCount };
+		std::vector<Round> rounds;
+	};
+
+	TEST_F(ConcurrentBeltFixture, SingleThreadTest)
+	{
+		EXPECT_EQ(belt.GetSlotCount(), kCapacityCount);
+		EXPECT_FALSE(Exchanger::PullItem(belt).has_value());
+
+		// Fill the belt through the receiver until it refuses items.
+		for (size_t index = 0u; index < kCapacityCount; ++index)
+		{
+			EXPECT_FALSE(Exchanger::PushItem(belt, rounds[index]).has_value());
+		}
+		EXPECT_TRUE(Exchanger::PushItem(belt, rounds[kCapacityCount]).has_value());
+		EXPECT_EQ(belt.GetItemCount(), kCapacityCount);
+		EXPECT_FALSE(belt.FindEmptySlot().has_value());
+
+		// The feeder end can't take items back.
+		OptionalRefWrapper refused = belt.ExchangeFeederSlot(rounds[0u]);
+		ASSERT_TRUE(refused.has_value());
+		EXPECT_EQ(&refused.value().get(), &rounds[0u]);
+		EXPECT_EQ(belt.GetItemCount(), kCapacityCount);
+
+		// So bulk exchanges refuse it as a feeder.
+		EXPECT_FALSE(belt.CanReturnFeederItems());
+		EXPECT_EQ(Exchanger::ExchangeN(sharedBelt, belt, kCapacityCount), 0u);
+		EXPECT_EQ(belt.GetItemCount(), kCapacityCount);
+
+		// Items come out in order they were pushed, wrapping around the ring.
+		for (size_t index = 0u; index < kCapacityCount * 3u; ++index)
+		{
+			OptionalRefWrapper item = Exchanger::PullItem(belt);
+			ASSERT_TRUE(item.has_value());
+			EXPECT_EQ(item.value().get().serial, index);
+
+			Exchanger::PushItem(belt, rounds[index + kCapacityCount]);
+		}
+
+		std::vector<OptionalRefWrapper> items = belt.GetSlotItems();
+		ASSERT_EQ(items.size(), kCapacityCount);
+		EXPECT_EQ(items.front().value().get().serial, kCapacityCount * 3u);
+		EXPECT_EQ(items.back().value().get().serial, kCapacityCount * 4u - 1u);
+	}
+
+	TEST_F(ConcurrentBeltFixture, ProducerConsumerTest)
+	{
+		std::thread producer([this]() {
+			for (const Round& round : rounds)
+			{
+				while (belt.ExchangeReceiverSlot(round).has_value())
+				{
+					std::this_thread::yield();
+				}
+			}
+			});
+
+		// Every round arrives exactly once and in order.
+		size_t expectedSerial = 0u;
+		while (expectedSerial < rounds.size())
+		{
+			OptionalRefWrapper item = belt.ExchangeFeederSlot();
+			if (!item.has_value())
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			ASSERT_EQ(item.value().get().serial, expectedSerial);
+			++expectedSerial;
+		}
+
+		producer.join();
+		EXPECT_EQ(belt.GetItemCount(), 0u);
+	}
+
+	TEST_F(ConcurrentBeltFixture, SharedSingleThreadTest)
+	{
+		// Capacity is rounded up to a power of two.
+		const size_t capacity = sharedBelt.GetSlotCount();
+		EXPECT_EQ(capacity, 8u);
+		EXPECT_FALSE(Exchanger::PullItem(sharedBelt).has_value());
+
+		for (size_t index = 0u; index < capacity; ++index)
+		{
+			EXPECT_FALSE(Exchanger::PushItem(sharedBelt, rounds[index]).has_value());
+		}
+		EXPECT_TRUE(Exchanger::PushItem(sharedBelt, rounds[capacity]).has_value());
+		EXPECT_TRUE(sharedBelt.ExchangeFeederSlot(rounds[0u]).has_value());
+		EXPECT_EQ(Exchanger::ExchangeN(belt, sharedBelt, capacity), 0u);
+		EXPECT_EQ(sharedBelt.GetItemCount(), capacity);
+
+		std::vector<OptionalRefWrapper> items = sharedBelt.GetSlotItems();
+		ASSERT_EQ(items.size(), capacity);
+		for (size_t index = 0u; index < capacity; ++index)
+		{
+			ASSERT_TRUE(items[index].has_value());
+			EXPECT_EQ(items[index].value().get().serial, index);
+		}
+
+		for (size_t index = 0u; index < capacity * 3u; ++index)
+		{
+			OptionalRefWrapper item = Exchanger::PullItem(sharedBelt);
+			ASSERT_TRUE(item.has_value());
+			EXPECT_EQ(item.value().get().serial, index);
+
+			Exchanger::PushItem(sharedBelt, rounds[index + capacity]);
+		}
+	}
+
+	TEST_F(ConcurrentBeltFixture, SharedStressTest)
+	{
+		constexpr size_t kProducerCount = 4u;
+		constexpr size_t kConsumerCount = 4u;
+
+		std::vector<std::atomic<uint32_t>> receivedCounts(rounds.size());
+		std::atomic<size_t> receivedTotal = 0u;
+		std::vector<std::thread> threads;
+
+		// Every producer loads its own share of rounds.
+		for (size_t producerIndex = 0u; producerIndex < kProducerCount; ++producerIndex)
+		{
+			threads.emplace_back([&, producerIndex]() {
+				for (size_t index = producerIndex; index < rounds.size(); index += kProducerCount)
+				{
+					while (sharedBelt.ExchangeReceiverSlot(rounds[index]).has_value())
+					{
+						std::this_thread::yield();
+					}
+				}
+				});
+		}
+
+		for (size_t consumerIndex = 0u; consumerIndex < kConsumerCount; ++consumerIndex)
+		{
+			threads.emplace_back([&]() {
+				while (receivedTotal.load() < rounds.size())
+				{
+					OptionalRefWrapper item = sharedBelt.ExchangeFeederSlot();
+					if (!item.has_value())
+					{
+						std::this_thread::yield();
+						continue;
+					}
+
+					receivedCounts[item.value().get().serial].fetch_add(1u);
+					receivedTotal.fetch_add(1u);
+				}
+				});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		// No round is lost or duplicated.
+		EXPECT_EQ(receivedTotal.load(), rounds.size());
+		EXPECT_EQ(sharedBelt.GetItemCount(), 0u);
+		for (const std::atomic<uint32_t>& count : receivedCounts)
+		{
+			ASSERT_EQ(count.load(), 1u);
+		}
+	}
+} // namespace
@@ -33,6 +33,23 @@ namespace {
 	REGISTER_RESOURCE_LITERAL(KgResourceModel, Steel);
 	REGISTER_RESOURCE_LITERAL(KgResourceModel, Wood);
 
+	// Too many resources for the small buffer, packages keep them in the map.
+	struct WideTestTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Iron, Copper, Tin, Lead, Zinc, Gold, Silver, Coal, Oil, Gas, Sand, Clay, Salt, Wool, Silk, Hemp,
+			Count,
+		};
+
+		static constexpr bool RelocatePackages = true;
+	};
+
+	using WideResourceModel = ::Vessel::ResourceModel<WideTestTag>;
+	using WidePackage = ::Vessel::Package<WideResourceModel>;
+
 	constexpr Units kEmptyAmountKg = 0.f;
 	constexpr Units kCapacityAmountKg = 500.f;
 	constexpr Units kHalfCapacityAmountKg = kCapacityAmountKg * 0.5f;
@@ -162,6 +179,45 @@ namespace {
 		providerChecker.CheckHalfState(ResourceId::Wood);
 	}
 
+	TEST_F(FloatPackageFixture, StateArrayTest) {
+		Package::ResourceArray halfStateArray;
+		halfStateArray[ResourceId::Steel] = kHalfCapacityAmountKg;
+		halfStateArray[ResourceId::Wood] = kCapacityAmountKg * 2.f;
+
+		// Overflow is clamped by capacity.
+		consumerPackage.LoadState(halfStateArray);
+		consumerChecker.CheckHalfState(ResourceId::Steel);
+		consumerChecker.CheckFullState(ResourceId::Wood);
+
+		// Round trip without hashing.
+		Package::ResourceArray savedStateArray;
+		consumerPackage.SaveState(savedStateArray);
+		providerPackage.LoadState(savedStateArray);
+		providerChecker.CheckHalfState(ResourceId::Steel);
+		providerChecker.CheckFullState(ResourceId::Wood);
+	}
+
+	TEST_F(FloatPackageFixture, StateRangeTest) {
+		const std::array<std::pair<ResourceId, Units>, 2u> halfStates
+		{ {
+			{ ResourceId::Steel, kHalfCapacityAmountKg },
+			{ ResourceId::Wood, kHalfCapacityAmountKg },
+		} };
+
+		consumerPackage.LoadState(halfStates);
+		consumerChecker.CheckHalfState(ResourceId::Steel);
+		consumerChecker.CheckHalfState(ResourceId::Wood);
+
+		// Save into any output iterator.
+		std::array<std::pair<ResourceId, Units>, 2u> savedStates{};
+		auto savedEnd = consumerPackage.SaveState(savedStates.begin());
+		EXPECT_EQ(savedEnd, savedStates.end());
+
+		providerPackage.LoadState(savedStates);
+		providerChecker.CheckHalfState(ResourceId::Steel);
+		providerChecker.CheckHalfState(ResourceId::Wood);
+	}
+
 	TEST_F(FloatPackageFixture, TransferTest) {
 		// Empty consumer.
 		consumerChecker.CheckEmptyState(ResourceId::Steel);
@@ -180,12 +236,34 @@ namespace {
 		providerChecker.CheckEmptyState(ResourceId::Wood);
 	}
 
+	TEST_F(FloatPackageFixture, BatchFillTest) {
+		::Vessel::ContainerBatch<KgResourceModel> batch;
+		batch.Add(Container{ ResourceId::Steel, kHalfCapacityAmountKg * 0.5f });
+		batch.Add(ResourceId::Wood, kCapacityAmountKg);
+		batch.Add(ResourceId::Steel, kHalfCapacityAmountKg * 0.5f);
+		batch.Add(ResourceId::Wood, kCapacityAmountKg);
+
+		// Same resources are summed and clamped once.
+		consumerPackage << batch;
+		consumerChecker.CheckHalfState(ResourceId::Steel);
+		consumerChecker.CheckFullState(ResourceId::Wood);
+	}
+
 	TEST_F(FloatPackageFixture, LiteralTest) {
 		consumerPackage << 500Steel << 500Wood;
 
 		consumerChecker.CheckFullState(ResourceId::Steel);
 		consumerChecker.CheckFullState(ResourceId::Wood);
 
+		// Every container of the chain is filled right away.
+		EXPECT_FLOAT_EQ((providerPackage << 100Steel).GetAvailableUnits(ResourceId::Steel), 100.f);
+		providerPackage.ResetState();
+
+		// Containers given at once are filled in one pass.
+		::Vessel::Transfer<KgResourceModel>::Fill(providerPackage, 100Steel, 250Wood, 150Steel);
+		providerChecker.CheckHalfState(ResourceId::Steel);
+		providerChecker.CheckHalfState(ResourceId::Wood);
+
 		const Package::ResourceTable halfStateTable
 		{
 			250Steel,
@@ -196,4 +274,49 @@ namespace {
 		consumerChecker.CheckHalfState(ResourceId::Steel);
 		consumerChecker.CheckHalfState(ResourceId::Wood);
 	}
+
+	TEST(WidePackageTest, StateMapPathTest) {
+		// Relocation by bytes is only allowed on the small buffer path.
+		EXPECT_FALSE(WidePackage::kTriviallyRelocatable);
+
+		WidePackage::ResourceTable capacities;
+		WidePackage::ResourceArray states;
+		for (uint8_t index = 0u; index < WideResourceModel::kResourceCount; ++index)
+		{
+			const auto resourceId = static_cast<WideResourceModel::ResourceId>(index);
+			capacities[resourceId] = kCapacityAmountKg;
+			states[resourceId] = static_cast<Units>(index) * 10.f;
+		}
+
+		WidePackage package{ capacities };
+
+		// Loads after a reset reuse map entries and keep every resource.
+		for (size_t round = 0u; round < 2u; ++round)
+		{
+			package.LoadState(states);
+
+			WidePackage::ResourceArray savedStates;
+			package.SaveState(savedStates);
+			EXPECT_EQ(savedStates, states);
+
+			package.ResetState();
+			EXPECT_FLOAT_EQ(package.GetAvailableUnits(WideResourceModel::ResourceId::Hemp), kEmptyAmountKg);
+		}
+
+		// Moved package is left without map entries, they read as empty.
+		package.LoadState(states);
+		WidePackage movedPackage{ std::move(package) };
+
+		WidePackage::ResourceArray movedStates;
+		movedPackage.SaveState(movedStates);
+		EXPECT_EQ(movedStates, states);
+		EXPECT_FLOAT_EQ(package.GetAvailableUnits(WideResourceModel::ResourceId::Hemp), kEmptyAmountKg);
+
+		WidePackage::ResourceArray emptiedStates;
+		package.SaveState(emptiedStates);
+		for (uint8_t index = 0u; index < WideResourceModel::kResourceCount; ++index)
+		{
+			EXPECT_FLOAT_EQ(emptiedStates[static_cast<WideResourceModel::ResourceId>(index)], kEmptyAmountKg);
+		}
+	}
 } // namespace
\ No newline at end of file
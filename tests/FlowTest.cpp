@@ -0,0 +1,127 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <Stackable/Container.h>
+#include <Stackable/Filter.h>
+#include <Stackable/Limiter.h>
+#include <Stackable/Flow.h>
+#include <Stackable/AnyEndpoint.h>
+#include <Stackable/Pipeline.h>
+
+namespace {
+	struct FlowTestTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Water,
+			Oil,
+			Count,
+		};
+	};
+
+	using FlowResourceModel = ::Vessel::ResourceModel<FlowTestTag>;
+	using ResourceId = FlowResourceModel::ResourceId;
+	using Units = FlowResourceModel::Units;
+	using Container = ::Vessel::Container<FlowResourceModel>;
+	using Filter = ::Vessel::Filter<FlowResourceModel>;
+	using Limiter = ::Vessel::Limiter<FlowResourceModel>;
+	using Flow = ::Vessel::Vessel<FlowResourceModel>;
+	using AnyProvider = ::Vessel::AnyProvider<FlowResourceModel>;
+	using AnyConsumer = ::Vessel::AnyConsumer<FlowResourceModel>;
+	using Transferesult = ::Vessel::Transferesult;
+	using LimitStage = ::Vessel::LimitStage<FlowResourceModel>;
+
+	// Provider which forgot to implement GetAvailableUnits, the base forwarder must not stand in for it.
+	class LeakyTank final : public ::Vessel::Provider<FlowResourceModel, LeakyTank>
+	{
+	public:
+		ResourceId GetResourceId() const { return ResourceId::Water; }
+		void DecreaseUnits(Units) {}
+	};
+
+	constexpr Units kEmptyLiters = 0.f;
+	constexpr Units kCapacityLiters = 100.f;
+	constexpr Units kBufferLiters = 30.f;
+
+	class FlowFixture : public ::testing::Test
+	{
+		// Inheritable state.
+	protected:
+		Container tank{ ResourceId::Water, kCapacityLiters, kCapacityLiters };
+		Container barrel{ ResourceId::Water, kEmptyLiters, kCapacityLiters };
+		Container oilBarrel{ ResourceId::Oil, kEmptyLiters, kCapacityLiters };
+	};
+
+	TEST_F(FlowFixture, ContainerTransferTest) {
+		EXPECT_EQ(Flow::Transfer(tank, barrel), Transferesult::Changed);
+		EXPECT_FLOAT_EQ(tank.GetAvailableUnits(), kEmptyLiters);
+		EXPECT_FLOAT_EQ(barrel.GetAvailableUnits(), kCapacityLiters);
+
+		// Nothing left to transfer.
+		EXPECT_EQ(Flow::Transfer(tank, barrel), Transferesult::Unchanged);
+	}
+
+	TEST_F(FlowFixture, ResourceMismatchTest) {
+		EXPECT_EQ(Flow::Transfer(tank, oilBarrel), Transferesult::Unchanged);
+		EXPECT_FLOAT_EQ(tank.GetAvailableUnits(), kCapacityLiters);
+		EXPECT_FLOAT_EQ(oilBarrel.GetAvailableUnits(), kEmptyLiters);
+	}
+
+	TEST_F(FlowFixture, FilterTest) {
+		Filter filter{ tank, kBufferLiters };
+		filter >> barrel;
+		EXPECT_FLOAT_EQ(tank.GetAvailableUnits(), kCapacityLiters - kBufferLiters);
+		EXPECT_FLOAT_EQ(barrel.GetAvailableUnits(), kBufferLiters);
+	}
+
+	TEST_F(FlowFixture, LimiterTest) {
+		Limiter limiter{ barrel, kBufferLiters, 0.5f };
+		limiter << tank;
+		EXPECT_FLOAT_EQ(barrel.GetAvailableUnits(), kBufferLiters * 0.5f);
+		EXPECT_FLOAT_EQ(tank.GetAvailableUnits(), kCapacityLiters - kBufferLiters * 0.5f);
+	}
+
+	TEST_F(FlowFixture, TypeErasedTest) {
+		Filter filter{ tank, kBufferLiters };
+		Container secondBarrel{ ResourceId::Water, kEmptyLiters, kCapacityLiters };
+		Limiter limiter{ secondBarrel, kBufferLiters };
+
+		std::vector<AnyProvider> providers{ AnyProvider{ filter }, AnyProvider{ tank } };
+		std::vector<AnyConsumer> consumers{ AnyConsumer{ barrel }, AnyConsumer{ limiter } };
+
+		for (size_t index = 0u; index < providers.size(); ++index)
+		{
+			Flow::Transfer(providers[index], consumers[index]);
+		}
+
+		EXPECT_FLOAT_EQ(barrel.GetAvailableUnits(), kBufferLiters);
+		EXPECT_FLOAT_EQ(secondBarrel.GetAvailableUnits(), kBufferLiters);
+		EXPECT_FLOAT_EQ(tank.GetAvailableUnits(), kCapacityLiters - kBufferLiters * 2.f);
+	}
+
+	TEST_F(FlowFixture, PipelineTest) {
+		// Stages are fused into the tightest limit at compile time.
+		constexpr auto stages = LimitStage{ kBufferLiters } | LimitStage{ kBufferLiters, 0.5f };
+		static_assert(stages.GetLimit() == kBufferLiters * 0.5f);
+
+		auto pipeline = stages | tank;
+		pipeline >> barrel;
+		EXPECT_FLOAT_EQ(tank.GetAvailableUnits(), kCapacityLiters - kBufferLiters * 0.5f);
+		EXPECT_FLOAT_EQ(barrel.GetAvailableUnits(), kBufferLiters * 0.5f);
+
+		// Pipeline can be a consumer too.
+		auto inlet = LimitStage{ kBufferLiters } | LimitStage{ kCapacityLiters } | oilBarrel;
+		Container oilTank{ ResourceId::Oil, kCapacityLiters, kCapacityLiters };
+		inlet << oilTank;
+		EXPECT_FLOAT_EQ(oilBarrel.GetAvailableUnits(), kBufferLiters);
+	}
+
+	TEST(FlowConceptTest, MissingHookTest) {
+		EXPECT_TRUE((::Vessel::ProviderImplementation<Container, FlowResourceModel>));
+		EXPECT_TRUE((::Vessel::ConsumerImplementation<Container, FlowResourceModel>));
+		EXPECT_FALSE((::Vessel::ProviderImplementation<LeakyTank, FlowResourceModel>));
+	}
+} // namespace
@@ -0,0 +1,300 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <Polymorphic/Drum.h>
+#include <Polymorphic/Junction.h>
+#include <Polymorphic/Queue.h>
+#include <Polymorphic/TransitBelt.h>
+
+namespace
+{
+	constexpr size_t kCapacityCount = 8u;
+
+	struct Parcel
+	{
+		bool isHeavy = false;
+	};
+
+	struct ParcelTagger
+	{
+		static constexpr size_t kTypeCount = 2u;
+		static constexpr ::Vessel::TypeTag kLightTag = 0u;
+		static constexpr ::Vessel::TypeTag kHeavyTag = 1u;
+
+		::Vessel::TypeTag operator()(const Parcel& parcel) const { return parcel.isHeavy ? kHeavyTag : kLightTag; }
+	};
+
+	using JunctionPolicy = ::Vessel::JunctionPolicy;
+	using Queue = ::Vessel::Queue<Parcel>;
+	using BeltInterface = ::Vessel::BeltInterface<Parcel>;
+
+	// Belt which reports more room than it takes, like a shared belt filled by another producer meanwhile.
+	class RefusingBelt final : public BeltInterface
+	{
+		// Life circle.
+	public:
+		RefusingBelt(size_t receivableCount, size_t takenCount)
+			: mReceivableCount{ receivableCount }
+			, mTakenCount{ takenCount }
+		{
+		}
+
+		// Public interface.
+	public:
+		const Queue& GetQueue() const { return mQueue; }
+
+		// Public virtual interface substitution.
+	public:
+		OptionalRefWrapper ExchangeFeederSlot(OptionalRefWrapper item = {}) override { return mQueue.ExchangeFeederSlot(item); }
+		OptionalRefWrapper ExchangeReceiverSlot(OptionalRefWrapper item = {}) override { return mQueue.ExchangeReceiverSlot(item); }
+		bool IsEmptySlot(size_t offset = 0u) const override { return mQueue.IsEmptySlot(offset); }
+		size_t GetItemCount() const override { return mQueue.GetItemCount(); }
+		size_t GetSlotCount() const override { return mQueue.GetSlotCount(); }
+		size_t GetReceiverSlotOffset() const override { return mQueue.GetReceiverSlotOffset(); }
+		size_t GetReceivableCount() const override { return mReceivableCount; }
+
+		size_t PushReceiverItems(std::span<const SlotPointer> items) override
+		{
+			return mQueue.PushReceiverItems(items.first(std::min(items.size(), mTakenCount)));
+		}
+
+		// Inheritable virtual interface substitution.
+	protected:
+		void VisitSlotRuns(void* context, SlotRunCallback callback) const override {}
+
+		// Private state.
+	private:
+		Queue mQueue{ kCapacityCount };
+
+		// Private properties.
+	private:
+		const size_t mReceivableCount = 0u;
+		const size_t mTakenCount = 0u;
+	};
+
+	class JunctionFixture : public ::testing::Test
+	{
+		// Inheritable interface.
+	protected:
+		// Load parcels into the belt through its receiver end.
+		void Load(Queue& belt, std::initializer_list<size_t> indices)
+		{
+			for (size_t index : indices)
+			{
+				belt.ExchangeReceiverSlot(parcels[index]);
+			}
+		}
+
+		// Get indices of parcels on the belt from the feeder end.
+		std::vector<size_t> GetIndices(const BeltInterface& belt) const
+		{
+			std::vector<size_t> indices;
+			for (const BeltInterface::OptionalRefWrapper& item : belt.GetSlotItems())
+			{
+				if (item.has_value())
+				{
+					indices.push_back(static_cast<size_t>(&item.value().get() - parcels.data()));
+				}
+			}
+			return indices;
+		}
+
+		// Inheritable state.
+	protected:
+		std::vector<Parcel> parcels = { {}, {}, { true }, { true }, {}, { true }, {}, {} };
+		Queue input{ kCapacityCount };
+	};
+
+	TEST_F(JunctionFixture, SplitterRoundRobinTest)
+	{
+		Load(input, { 0u, 1u, 2u, 3u, 4u, 5u, 6u });
+
+		Queue first{ kCapacityCount };
+		Queue second{ 1u };
+		Queue third{ kCapacityCount };
+
+		::Vessel::Splitter<Parcel> splitter{ input, JunctionPolicy::RoundRobin, 5u };
+		splitter.AddOutput(first);
+		splitter.AddOutput(second);
+		splitter.AddOutput(third);
+
+		// Full output is skipped and its turn goes to the next one.
+		EXPECT_EQ(splitter.Tick(), 5u);
+		EXPECT_EQ(GetIndices(first), (std::vector<size_t>{ 0u, 3u }));
+		EXPECT_EQ(GetIndices(second), (std::vector<size_t>{ 1u }));
+		EXPECT_EQ(GetIndices(third), (std::vector<size_t>{ 2u, 4u }));
+
+		// Turns go on from where the last tick stopped.
+		EXPECT_EQ(splitter.Tick(), 2u);
+		EXPECT_EQ(GetIndices(first), (std::vector<size_t>{ 0u, 3u, 5u }));
+		EXPECT_EQ(GetIndices(third), (std::vector<size_t>{ 2u, 4u, 6u }));
+		EXPECT_EQ(input.GetItemCount(), 0u);
+		EXPECT_EQ(splitter.Tick(), 0u);
+	}
+
+	TEST_F(JunctionFixture, SplitterPriorityTest)
+	{
+		Load(input, { 0u, 1u, 2u, 3u, 4u });
+
+		Queue first{ 2u };
+		Queue second{ kCapacityCount };
+
+		::Vessel::Splitter<Parcel> splitter{ input, JunctionPolicy::Priority, kCapacityCount };
+		splitter.AddOutput(first);
+		splitter.AddOutput(second);
+
+		EXPECT_EQ(splitter.Tick(), 5u);
+		EXPECT_EQ(GetIndices(first), (std::vector<size_t>{ 0u, 1u }));
+		EXPECT_EQ(GetIndices(second), (std::vector<size_t>{ 2u, 3u, 4u }));
+	}
+
+	TEST_F(JunctionFixture, SplitterFilterTest)
+	{
+		Load(input, { 2u, 0u, 3u, 1u, 5u, 4u });
+
+		Queue heavy{ 2u };
+		Queue light{ kCapacityCount };
+
+		::Vessel::Splitter<Parcel, ParcelTagger> splitter{ input, JunctionPolicy::Filter, kCapacityCount };
+		splitter.AddOutput(heavy, ParcelTagger::kHeavyTag);
+		splitter.AddOutput(light, ParcelTagger::kLightTag);
+
+		// Third heavy parcel has no room and stops parcels behind it.
+		EXPECT_EQ(splitter.Tick(), 4u);
+		EXPECT_EQ(GetIndices(heavy), (std::vector<size_t>{ 2u, 3u }));
+		EXPECT_EQ(GetIndices(light), (std::vector<size_t>{ 0u, 1u }));
+		EXPECT_EQ(GetIndices(input), (std::vector<size_t>{ 5u, 4u }));
+
+		heavy.ExchangeFeederSlot();
+		EXPECT_EQ(splitter.Tick(), 2u);
+		EXPECT_EQ(GetIndices(heavy), (std::vector<size_t>{ 3u, 5u }));
+		EXPECT_EQ(GetIndices(light), (std::vector<size_t>{ 0u, 1u, 4u }));
+	}
+
+	TEST_F(JunctionFixture, MergerTest)
+	{
+		Queue first{ kCapacityCount };
+		Queue second{ kCapacityCount };
+		Load(first, { 0u, 1u, 2u });
+		Load(second, { 4u, 5u });
+
+		Queue output{ kCapacityCount };
+		::Vessel::Merger<Parcel> roundRobin{ output, JunctionPolicy::RoundRobin, 4u };
+		roundRobin.AddInput(first);
+		roundRobin.AddInput(second);
+
+		EXPECT_EQ(roundRobin.Tick(), 4u);
+		EXPECT_EQ(GetIndices(output), (std::vector<size_t>{ 0u, 4u, 1u, 5u }));
+		EXPECT_EQ(roundRobin.Tick(), 1u);
+		EXPECT_EQ(GetIndices(output), (std::vector<size_t>{ 0u, 4u, 1u, 5u, 2u }));
+
+		// Priority drains the first input before the second one, up to free slots of the output.
+		Load(first, { 6u });
+		Load(second, { 7u, 3u });
+
+		::Vessel::Merger<Parcel> priority{ output, JunctionPolicy::Priority, kCapacityCount };
+		priority.AddInput(second);
+		priority.AddInput(first);
+
+		EXPECT_EQ(priority.Tick(), 3u);
+		EXPECT_EQ(GetIndices(output), (std::vector<size_t>{ 0u, 4u, 1u, 5u, 2u, 7u, 3u, 6u }));
+		EXPECT_EQ(priority.Tick(), 0u);
+	}
+
+	TEST_F(JunctionFixture, MergerFilterTest)
+	{
+		Queue first{ kCapacityCount };
+		Queue second{ kCapacityCount };
+		Load(first, { 2u, 3u, 0u, 5u });
+		Load(second, { 1u, 4u });
+
+		Queue output{ kCapacityCount };
+		::Vessel::Merger<Parcel, ParcelTagger> merger{ output, JunctionPolicy::Filter, kCapacityCount };
+		merger.AddInput(first, ParcelTagger::kHeavyTag);
+		merger.AddInput(second);
+
+		// Light parcel stops the heavy input, input without a type passes everything.
+		EXPECT_EQ(merger.Tick(), 4u);
+		EXPECT_EQ(GetIndices(output), (std::vector<size_t>{ 2u, 1u, 3u, 4u }));
+		EXPECT_EQ(GetIndices(first), (std::vector<size_t>{ 0u, 5u }));
+		EXPECT_EQ(merger.Tick(), 0u);
+	}
+
+	TEST_F(JunctionFixture, TransitTurnTest)
+	{
+		::Vessel::TransitClock<Parcel> clock;
+		::Vessel::TransitBelt<Parcel> splitterInput{ clock, kCapacityCount, 1u };
+		splitterInput.SetSlotItems({ parcels[0] });
+		splitterInput.ExchangeReceiverSlot(parcels[1]);
+		splitterInput.ExchangeReceiverSlot(parcels[2]);
+
+		Queue first{ kCapacityCount };
+		Queue second{ kCapacityCount };
+		Queue third{ kCapacityCount };
+
+		::Vessel::Splitter<Parcel> splitter{ splitterInput, JunctionPolicy::RoundRobin, 3u };
+		splitter.AddOutput(first);
+		splitter.AddOutput(second);
+		splitter.AddOutput(third);
+
+		// Parcels in transit can't be pulled, so outputs planned for them keep their turns.
+		EXPECT_EQ(splitter.Tick(), 1u);
+		clock.Tick();
+		EXPECT_EQ(splitter.Tick(), 2u);
+		EXPECT_EQ(GetIndices(first), (std::vector<size_t>{ 0u }));
+		EXPECT_EQ(GetIndices(second), (std::vector<size_t>{ 1u }));
+		EXPECT_EQ(GetIndices(third), (std::vector<size_t>{ 2u }));
+
+		::Vessel::TransitBelt<Parcel> mergerInput{ clock, kCapacityCount, 1u };
+		mergerInput.SetSlotItems({ parcels[3] });
+		mergerInput.ExchangeReceiverSlot(parcels[4]);
+		Load(input, { 5u, 6u });
+
+		Queue output{ 3u };
+		::Vessel::Merger<Parcel> merger{ output, JunctionPolicy::RoundRobin, 3u };
+		merger.AddInput(mergerInput);
+		merger.AddInput(input);
+
+		// Late turn of the input with a parcel in transit is skipped, so it's the next one after the arrival.
+		EXPECT_EQ(merger.Tick(), 2u);
+		clock.Tick();
+		EXPECT_EQ(merger.Tick(), 1u);
+		EXPECT_EQ(GetIndices(output), (std::vector<size_t>{ 3u, 5u, 4u }));
+		EXPECT_EQ(GetIndices(input), (std::vector<size_t>{ 6u }));
+	}
+
+	TEST_F(JunctionFixture, ReturnTest)
+	{
+		::Vessel::Drum<Parcel> splitterInput{ 5u };
+		splitterInput.SetSlotItems({ parcels[0], parcels[1], parcels[2], parcels[3], parcels[4] });
+
+		RefusingBelt first{ 2u, 1u };
+		Queue second{ kCapacityCount };
+
+		::Vessel::Splitter<Parcel> splitter{ splitterInput, JunctionPolicy::RoundRobin, 3u };
+		splitter.AddOutput(first);
+		splitter.AddOutput(second);
+
+		// Refused parcel goes back in front of the drum, which has turned past it, and the turn follows the last moved one.
+		EXPECT_EQ(splitter.Tick(), 2u);
+		EXPECT_EQ(GetIndices(first.GetQueue()), (std::vector<size_t>{ 0u }));
+		EXPECT_EQ(GetIndices(second), (std::vector<size_t>{ 1u }));
+		EXPECT_EQ(GetIndices(splitterInput), (std::vector<size_t>{ 2u, 3u, 4u }));
+
+		::Vessel::Drum<Parcel> mergerInput{ 4u };
+		mergerInput.SetSlotItems({ parcels[0], parcels[1], parcels[2], parcels[3] });
+		Load(input, { 4u, 5u });
+
+		RefusingBelt output{ 3u, 1u };
+		::Vessel::Merger<Parcel> merger{ output, JunctionPolicy::RoundRobin, 3u };
+		merger.AddInput(mergerInput);
+		merger.AddInput(input);
+
+		// Refused parcels go back to their own inputs.
+		EXPECT_EQ(merger.Tick(), 1u);
+		EXPECT_EQ(GetIndices(output.GetQueue()), (std::vector<size_t>{ 0u }));
+		EXPECT_EQ(GetIndices(mergerInput), (std::vector<size_t>{ 1u, 2u, 3u }));
+		EXPECT_EQ(GetIndices(input), (std::vector<size_t>{ 4u, 5u }));
+	}
+} // namespace
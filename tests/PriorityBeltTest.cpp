@@ -0,0 +1,166 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <Polymorphic/BeltSnapshot.h>
+#include <Polymorphic/PriorityBelt.h>
+#include <Polymorphic/Queue.h>
+
+namespace
+{
+	constexpr size_t kCapacityCount = 8u;
+
+	struct Supply
+	{
+		int urgency = 0;
+	};
+
+	struct LessUrgent
+	{
+		bool operator()(const Supply& left, const Supply& right) const { return left.urgency < right.urgency; }
+	};
+
+	using Exchanger = ::Vessel::Exchanger<Supply>;
+	using PriorityBelt = ::Vessel::PriorityBelt<Supply, LessUrgent>;
+
+	class PriorityBeltFixture : public ::testing::Test
+	{
+		// Inheritable interface.
+	protected:
+		// Get indices of supplies on the belt from the feeder end.
+		std::vector<size_t> GetIndices(const ::Vessel::BeltInterface<Supply>& belt) const
+		{
+			std::vector<size_t> indices;
+			for (const PriorityBelt::OptionalRefWrapper& item : belt.GetSlotItems())
+			{
+				if (item.has_value())
+				{
+					indices.push_back(static_cast<size_t>(&item.value().get() - supplies.data()));
+				}
+			}
+			return indices;
+		}
+
+		// Inheritable state.
+	protected:
+		// Medicine is more urgent than food and food is more urgent than ammo.
+		std::vector<Supply> supplies = { { 0 }, { 2 }, { 1 }, { 2 }, { 0 }, { 1 }, { 2 }, { 0 } };
+	};
+
+	TEST_F(PriorityBeltFixture, PriorityOrderTest)
+	{
+		PriorityBelt belt{ kCapacityCount };
+		for (const Supply& supply : supplies)
+		{
+			EXPECT_FALSE(Exchanger::PushItem(belt, supply).has_value());
+		}
+
+		EXPECT_EQ(belt.GetItemCount(), kCapacityCount);
+		EXPECT_TRUE(Exchanger::PushItem(belt, supplies[0]).has_value());
+		EXPECT_EQ(belt.GetTopItem(), &supplies[1]);
+
+		// Slots are visited in feeder order, equal supplies keep the order of pushes.
+		const std::vector<size_t> order = { 1u, 3u, 6u, 2u, 5u, 0u, 4u, 7u };
+		EXPECT_EQ(GetIndices(belt), order);
+
+		std::vector<size_t> pulled;
+		while (belt.GetItemCount() > 0u)
+		{
+			pulled.push_back(static_cast<size_t>(&Exchanger::PullItem(belt).value().get() - supplies.data()));
+		}
+		EXPECT_EQ(pulled, order);
+		EXPECT_FALSE(Exchanger::PullItem(belt).has_value());
+	}
+
+	TEST_F(PriorityBeltFixture, FeederEndTest)
+	{
+		PriorityBelt belt{ 3u };
+		belt.ExchangeReceiverSlot(supplies[1]);
+		belt.ExchangeReceiverSlot(supplies[2]);
+
+		// Item pushed back goes in front of items of equal priority.
+		EXPECT_FALSE(belt.ExchangeFeederSlot(supplies[3]).has_value());
+		EXPECT_EQ(GetIndices(belt), (std::vector<size_t>{ 3u, 1u, 2u }));
+
+		// Full belt gives its top item away.
+		EXPECT_EQ(&belt.ExchangeFeederSlot(supplies[0]).value().get(), &supplies[3]);
+		EXPECT_EQ(GetIndices(belt), (std::vector<size_t>{ 1u, 2u, 0u }));
+
+		// Receiver end doesn't give items back.
+		EXPECT_FALSE(belt.ExchangeReceiverSlot().has_value());
+		EXPECT_EQ(&belt.ExchangeReceiverSlot(supplies[4]).value().get(), &supplies[4]);
+	}
+
+	TEST_F(PriorityBeltFixture, RandomOrderTest)
+	{
+		// Many urgencies over several heap levels come out sorted, ties in the order of pushes.
+		std::vector<Supply> manySupplies(500u);
+		std::mt19937 random{ 11u };
+		for (Supply& supply : manySupplies)
+		{
+			supply.urgency = static_cast<int>(random() % 16u);
+		}
+
+		PriorityBelt belt{ manySupplies.size() };
+		std::vector<PriorityBelt::SlotPointer> slots;
+		for (const Supply& supply : manySupplies)
+		{
+			slots.push_back(&supply);
+		}
+		EXPECT_EQ(belt.PushReceiverItems(slots), manySupplies.size());
+
+		std::vector<PriorityBelt::SlotPointer> expected = slots;
+		std::stable_sort(expected.begin(), expected.end(), [](PriorityBelt::SlotPointer left, PriorityBelt::SlotPointer right) {
+			return left->urgency > right->urgency;
+			});
+
+		std::vector<PriorityBelt::SlotPointer> pulled(manySupplies.size());
+		EXPECT_EQ(belt.PullFeederItems(pulled), manySupplies.size());
+		EXPECT_EQ(pulled, expected);
+	}
+
+	TEST_F(PriorityBeltFixture, SnapshotTest)
+	{
+		PriorityBelt belt{ kCapacityCount };
+		belt.SetSlotItems({ supplies[0], {}, supplies[1], supplies[2], supplies[3] });
+		EXPECT_EQ(GetIndices(belt), (std::vector<size_t>{ 1u, 3u, 2u, 0u }));
+
+		// Belt is saved in feeder order, so the order survives a restore into another belt.
+		::Vessel::BeltSnapshot<Supply> snapshot;
+		snapshot.Save(belt, [this](const Supply& supply) { return static_cast<size_t>(&supply - supplies.data()); });
+
+		std::vector<::Vessel::BeltSnapshot<Supply>::SlotPointer> itemTable;
+		for (const Supply& supply : supplies)
+		{
+			itemTable.push_back(&supply);
+		}
+
+		::Vessel::Queue<Supply> queue{ kCapacityCount };
+		EXPECT_TRUE(snapshot.Restore(queue, itemTable));
+		EXPECT_EQ(GetIndices(queue), GetIndices(belt));
+	}
+
+	TEST_F(PriorityBeltFixture, VisitTest)
+	{
+		PriorityBelt belt{ kCapacityCount };
+		belt.SetSlotItems({ supplies[0], supplies[1], supplies[2], supplies[3] });
+		EXPECT_EQ(GetIndices(belt), (std::vector<size_t>{ 1u, 3u, 2u, 0u }));
+
+		// Order is sorted again after every change.
+		Exchanger::PullItem(belt);
+		Exchanger::PushItem(belt, supplies[5]);
+		EXPECT_EQ(GetIndices(belt), (std::vector<size_t>{ 3u, 2u, 5u, 0u }));
+
+		// Const belt is visited from several threads at once.
+		const PriorityBelt& constBelt = belt;
+		std::vector<size_t> otherIndices;
+		std::thread visitor([&]() { otherIndices = GetIndices(constBelt); });
+		const std::vector<size_t> indices = GetIndices(constBelt);
+		visitor.join();
+
+		EXPECT_EQ(indices, otherIndices);
+	}
+} // namespace
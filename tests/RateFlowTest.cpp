@@ -0,0 +1,160 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+
+#include <Stackable/Package.h>
+#include <Stackable/RateFlow.h>
+
+namespace
+{
+	struct RateTestTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Water,
+			Oil,
+			Count,
+		};
+	};
+
+	struct CountTestTag
+	{
+		using Units = int;
+
+		enum class ResourceId : uint8_t
+		{
+			Crate,
+			Count,
+		};
+	};
+
+	using RateResourceModel = ::Vessel::ResourceModel<RateTestTag>;
+	using ResourceId = RateResourceModel::ResourceId;
+	using Units = RateResourceModel::Units;
+	using Package = ::Vessel::Package<RateResourceModel>;
+	using RateFlow = ::Vessel::RateFlow<RateResourceModel>;
+	using RateFlowBatch = ::Vessel::RateFlowBatch<RateResourceModel>;
+
+	using CountResourceModel = ::Vessel::ResourceModel<CountTestTag>;
+	using CountPackage = ::Vessel::Package<CountResourceModel>;
+
+	constexpr Units kCapacityAmountL = 1000.f;
+	constexpr Units kStartAmountL = 100.f;
+	constexpr int kCrateCapacity = 10;
+
+	const Package::ResourceTable kTankCapacities
+	{
+		{ ResourceId::Water, kCapacityAmountL },
+		{ ResourceId::Oil, kCapacityAmountL },
+	};
+
+	const Package::ResourceTable kStartAmounts
+	{
+		{ ResourceId::Water, kStartAmountL },
+		{ ResourceId::Oil, kStartAmountL },
+	};
+
+	const CountPackage::ResourceTable kCrateCapacities
+	{
+		{ CountTestTag::ResourceId::Crate, kCrateCapacity },
+	};
+
+	class RateFlowFixture : public ::testing::Test
+	{
+		// Inheritable interface.
+	protected:
+		void SetUp() override
+		{
+			source.LoadState(kStartAmounts);
+		}
+
+		// Inheritable state.
+	protected:
+		Package source{ kTankCapacities };
+		Package middle{ kTankCapacities };
+		Package sink{ kTankCapacities };
+		RateFlowBatch flows;
+	};
+
+	TEST_F(RateFlowFixture, RateTimesTimeTest) {
+		const size_t index = flows.Add(RateFlow{ &source, &sink, ResourceId::Water, 10.f });
+
+		flows.Integrate(0.5f);
+
+		EXPECT_FLOAT_EQ(flows.GetMovedUnits(index), 5.f);
+		EXPECT_FLOAT_EQ(source.GetAvailableUnits(ResourceId::Water), kStartAmountL - 5.f);
+		EXPECT_FLOAT_EQ(sink.GetAvailableUnits(ResourceId::Water), 5.f);
+		EXPECT_FLOAT_EQ(sink.GetAvailableUnits(ResourceId::Oil), 0.f);
+	}
+
+	TEST_F(RateFlowFixture, ClampTest) {
+		flows.Add(RateFlow{ &source, &sink, ResourceId::Oil, 1000.f });
+
+		flows.Integrate(1.f);
+
+		EXPECT_FLOAT_EQ(source.GetAvailableUnits(ResourceId::Oil), 0.f);
+		EXPECT_FLOAT_EQ(sink.GetAvailableUnits(ResourceId::Oil), kStartAmountL);
+	}
+
+	TEST_F(RateFlowFixture, SharedProviderTest) {
+		flows.Add(RateFlow{ &source, &middle, ResourceId::Water, 80.f });
+		flows.Add(RateFlow{ &source, &sink, ResourceId::Water, 80.f });
+
+		flows.Integrate(1.f);
+
+		EXPECT_FLOAT_EQ(source.GetAvailableUnits(ResourceId::Water), 0.f);
+		EXPECT_FLOAT_EQ(middle.GetAvailableUnits(ResourceId::Water) + sink.GetAvailableUnits(ResourceId::Water), kStartAmountL);
+	}
+
+	TEST_F(RateFlowFixture, NegativeRateTest) {
+		const size_t index = flows.Add(RateFlow{ &source, &sink, ResourceId::Water, 10.f });
+		flows.SetRate(index, -10.f);
+
+		flows.Integrate(1.f);
+
+		EXPECT_FLOAT_EQ(flows.GetRate(index), 0.f);
+		EXPECT_FLOAT_EQ(sink.GetAvailableUnits(ResourceId::Water), 0.f);
+	}
+
+	TEST_F(RateFlowFixture, SubStepsTest) {
+		// Downstream flow is integrated first, so a single step can't see units arriving in the middle.
+		flows.Add(RateFlow{ &middle, &sink, ResourceId::Water, 10.f });
+		flows.Add(RateFlow{ &source, &middle, ResourceId::Water, 10.f });
+
+		flows.Integrate(1.f);
+		EXPECT_FLOAT_EQ(sink.GetAvailableUnits(ResourceId::Water), 0.f);
+		EXPECT_FLOAT_EQ(middle.GetAvailableUnits(ResourceId::Water), 10.f);
+
+		middle.ResetState();
+		source.LoadState(kStartAmounts);
+
+		flows.Integrate(1.f, 4u);
+		EXPECT_FLOAT_EQ(sink.GetAvailableUnits(ResourceId::Water), 7.5f);
+		EXPECT_FLOAT_EQ(middle.GetAvailableUnits(ResourceId::Water), 2.5f);
+		EXPECT_FLOAT_EQ(flows.GetMovedUnits(1u), 10.f);
+	}
+
+	TEST(RateFlowCarryTest, IntegerUnitsTest) {
+		CountPackage shelf{ kCrateCapacities };
+		CountPackage truck{ kCrateCapacities };
+		shelf.LoadState({ { CountTestTag::ResourceId::Crate, kCrateCapacity } });
+
+		// Quarter of a crate per step never fits a whole unit alone, the carry completes it on every fourth step.
+		::Vessel::RateFlowBatch<CountResourceModel> flows;
+		flows.Add({ &shelf, &truck, CountTestTag::ResourceId::Crate, 0.25f });
+
+		for (size_t step = 0u; step < 8u; ++step)
+		{
+			flows.Integrate(1.f);
+		}
+
+		EXPECT_EQ(truck.GetAvailableUnits(CountTestTag::ResourceId::Crate), 2);
+		EXPECT_EQ(shelf.GetAvailableUnits(CountTestTag::ResourceId::Crate), kCrateCapacity - 2);
+
+		// Sub-steps carry fractions between each other too.
+		flows.Integrate(4.f, 16u);
+		EXPECT_EQ(flows.GetMovedUnits(0u), 1);
+		EXPECT_EQ(truck.GetAvailableUnits(CountTestTag::ResourceId::Crate), 3);
+	}
+} // namespace
@@ -0,0 +1,129 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include <Stackable/Package.h>
+#include <Stackable/Container.h>
+
+namespace {
+	struct RelocateTestTag
+	{
+		using Units = int;
+
+		enum class ResourceId : uint8_t
+		{
+			Health,
+			Armor,
+			Count,
+		};
+
+		static constexpr bool RelocatePackages = true;
+	};
+
+	struct StealTestTag
+	{
+		using Units = int;
+
+		enum class ResourceId : uint8_t
+		{
+			Health,
+			Armor,
+			Count,
+		};
+	};
+
+	using RelocateResourceModel = ::Vessel::ResourceModel<RelocateTestTag>;
+	using ResourceId = RelocateResourceModel::ResourceId;
+	using Units = RelocateResourceModel::Units;
+	using Package = ::Vessel::Package<RelocateResourceModel>;
+	using Container = ::Vessel::Container<RelocateResourceModel>;
+
+	constexpr Units kCapacityAmountPoints = 100;
+
+	static const Package::ResourceTable kContainerCapacities
+	{
+		{ ResourceId::Health, kCapacityAmountPoints },
+		{ ResourceId::Armor, kCapacityAmountPoints },
+	};
+
+	static const Package::ResourceTable kSmallContainerCapacities
+	{
+		{ ResourceId::Health, kCapacityAmountPoints / 10 },
+	};
+
+	static_assert(::Vessel::IsTriviallyRelocatableValue<Package>);
+	static_assert(!::Vessel::IsTriviallyRelocatableValue<::Vessel::Package<::Vessel::ResourceModel<StealTestTag>>>);
+
+	TEST(RelocationTest, MoveTest) {
+		Package source{ kContainerCapacities };
+		source << Container{ ResourceId::Health, 40 } << Container{ ResourceId::Armor, 70 };
+
+		Package moved{ std::move(source) };
+		EXPECT_EQ(moved.GetAvailableUnits(ResourceId::Health), 40);
+		EXPECT_EQ(moved.GetAvailableUnits(ResourceId::Armor), 70);
+		EXPECT_EQ(source.GetAvailableUnits(ResourceId::Health), 0);
+
+		// Assignment replaces the state and capacities.
+		Package small{ kSmallContainerCapacities };
+		small << Container{ ResourceId::Health, 5 };
+		moved = std::move(small);
+		EXPECT_EQ(moved.GetAvailableUnits(ResourceId::Health), 5);
+		EXPECT_EQ(moved.GetRequestedUnits(ResourceId::Health), 5);
+		EXPECT_EQ(moved.GetAvailableUnits(ResourceId::Armor), 0);
+	}
+
+	TEST(RelocationTest, SwapTest) {
+		Package left{ kContainerCapacities };
+		Package right{ kSmallContainerCapacities };
+		left << Container{ ResourceId::Armor, 30 };
+		right << Container{ ResourceId::Health, 10 };
+
+		swap(left, right);
+		EXPECT_EQ(left.GetAvailableUnits(ResourceId::Health), 10);
+		EXPECT_EQ(left.GetRequestedUnits(ResourceId::Armor), 0);
+		EXPECT_EQ(right.GetAvailableUnits(ResourceId::Armor), 30);
+	}
+
+	TEST(RelocationTest, VectorTest) {
+		std::vector<Package> packages;
+		for (Units index = 0; index < 32; ++index)
+		{
+			packages.emplace_back(kContainerCapacities);
+			packages.back() << Container{ ResourceId::Health, 31 - index };
+		}
+
+		std::sort(packages.begin(), packages.end(), [](const Package& left, const Package& right) {
+			return left.GetAvailableUnits(ResourceId::Health) < right.GetAvailableUnits(ResourceId::Health);
+			});
+
+		for (Units index = 0; index < 32; ++index)
+		{
+			EXPECT_EQ(packages[index].GetAvailableUnits(ResourceId::Health), index);
+		}
+	}
+
+	TEST(RelocationTest, BulkRelocateTest) {
+		constexpr size_t kCount = 4u;
+
+		std::vector<Package> packages;
+		packages.reserve(kCount);
+		for (size_t index = 0u; index < kCount; ++index)
+		{
+			packages.emplace_back(kContainerCapacities);
+			packages.back() << Container{ ResourceId::Armor, static_cast<Units>(index) };
+		}
+
+		alignas(Package) std::byte storage[sizeof(Package) * kCount];
+		Package* destination = reinterpret_cast<Package*>(storage);
+		::Vessel::Relocate(packages.data(), packages.data() + kCount, destination);
+
+		for (size_t index = 0u; index < kCount; ++index)
+		{
+			EXPECT_EQ(destination[index].GetAvailableUnits(ResourceId::Armor), static_cast<Units>(index));
+
+			// Put the package back, so both ranges are destroyed once.
+			::Vessel::Relocate(destination + index, destination + index + 1u, packages.data() + index);
+		}
+	}
+} // namespace
@@ -0,0 +1,143 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include <Polymorphic/Drum.h>
+#include <Polymorphic/Queue.h>
+#include <Polymorphic/SupplyChain.h>
+
+namespace
+{
+	constexpr size_t kCapacityCount = 4u;
+
+	struct Parcel
+	{
+		int weight = 1;
+	};
+
+	using Drum = ::Vessel::Drum<Parcel>;
+	using Queue = ::Vessel::Queue<Parcel>;
+	using SupplyChain = ::Vessel::SupplyChain<Parcel>;
+
+	class SupplyChainFixture : public ::testing::Test
+	{
+		// Inheritable interface.
+	protected:
+		// Fill the belt with parcels through its receiver end.
+		void Load(Queue& belt, size_t count)
+		{
+			for (size_t index = 0u; index < count; ++index)
+			{
+				belt.ExchangeReceiverSlot(parcel);
+			}
+		}
+
+		// Inheritable state.
+	protected:
+		Parcel parcel{};
+		Queue source{ kCapacityCount };
+		Queue middle{ kCapacityCount };
+		Drum sink{ kCapacityCount };
+		SupplyChain chain;
+	};
+
+	TEST_F(SupplyChainFixture, OneLinkPerTickTest)
+	{
+		Load(source, kCapacityCount);
+
+		const SupplyChain::BeltId sourceId = chain.AddBelt(source);
+		const SupplyChain::BeltId middleId = chain.AddBelt(middle);
+		const SupplyChain::BeltId sinkId = chain.AddBelt(sink);
+		chain.Link(sourceId, middleId);
+		chain.Link(middleId, sinkId);
+
+		// Parcel needs two ticks to cross both links.
+		EXPECT_EQ(chain.Tick(), 1u);
+		EXPECT_EQ(middle.GetItemCount(), 1u);
+		EXPECT_EQ(sink.GetItemCount(), 0u);
+
+		EXPECT_EQ(chain.Tick(), 2u);
+		EXPECT_EQ(middle.GetItemCount(), 1u);
+		EXPECT_EQ(sink.GetItemCount(), 1u);
+
+		for (size_t tick = 0u; tick < kCapacityCount * 2u; ++tick)
+		{
+			chain.Tick();
+		}
+
+		EXPECT_EQ(source.GetItemCount(), 0u);
+		EXPECT_EQ(middle.GetItemCount(), 0u);
+		EXPECT_EQ(sink.GetItemCount(), kCapacityCount);
+		EXPECT_EQ(chain.Tick(), 0u);
+	}
+
+	TEST_F(SupplyChainFixture, RateAndFanInTest)
+	{
+		Load(source, kCapacityCount);
+		Load(middle, kCapacityCount);
+
+		const SupplyChain::BeltId sinkId = chain.AddBelt(sink);
+		chain.Link(chain.AddBelt(source), sinkId, 3u);
+		chain.Link(chain.AddBelt(middle), sinkId, 3u);
+
+		// The sink takes only as many parcels as it has free slots.
+		EXPECT_EQ(chain.Tick(), kCapacityCount);
+		EXPECT_EQ(sink.GetItemCount(), kCapacityCount);
+		EXPECT_EQ(source.GetItemCount() + middle.GetItemCount(), kCapacityCount);
+		EXPECT_EQ(chain.GetChainCount(), 1u);
+	}
+
+	TEST_F(SupplyChainFixture, CycleTest)
+	{
+		Load(source, 2u);
+
+		const SupplyChain::BeltId sourceId = chain.AddBelt(source);
+		const SupplyChain::BeltId middleId = chain.AddBelt(middle);
+		chain.Link(sourceId, middleId);
+		chain.Link(middleId, sourceId);
+
+		// Parcels circle around without getting lost.
+		for (size_t tick = 0u; tick < 10u; ++tick)
+		{
+			chain.Tick();
+			EXPECT_EQ(source.GetItemCount() + middle.GetItemCount(), 2u);
+		}
+	}
+
+	TEST_F(SupplyChainFixture, ThreadedChainsTest)
+	{
+		constexpr size_t kChainCount = 64u;
+		constexpr size_t kChainLength = 5u;
+
+		std::vector<std::unique_ptr<Queue>> belts;
+		for (size_t chainIndex = 0u; chainIndex < kChainCount; ++chainIndex)
+		{
+			for (size_t beltIndex = 0u; beltIndex < kChainLength; ++beltIndex)
+			{
+				belts.push_back(std::make_unique<Queue>(kCapacityCount));
+				const SupplyChain::BeltId beltId = chain.AddBelt(*belts.back());
+				if (beltIndex > 0u)
+				{
+					chain.Link(beltId - 1u, beltId, 2u);
+				}
+			}
+
+			Load(*belts[chainIndex * kChainLength], kCapacityCount);
+		}
+
+		EXPECT_EQ(chain.GetChainCount(), kChainCount);
+
+		// Workers are kept between ticks, ticks on fewer threads leave some of them asleep.
+		for (size_t tick = 0u; tick < kChainLength * kCapacityCount; ++tick)
+		{
+			chain.Tick(1u + tick % 4u);
+		}
+
+		// Every chain delivered all parcels to its last belt.
+		for (size_t chainIndex = 0u; chainIndex < kChainCount; ++chainIndex)
+		{
+			EXPECT_EQ(belts[chainIndex * kChainLength + kChainLength - 1u]->GetItemCount(), kCapacityCount);
+		}
+	}
+} // namespace
@@ -0,0 +1,111 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <Profiling/TraceRecorder.h>
+
+namespace
+{
+	using TraceRecorder = ::Vessel::TraceRecorder;
+
+	class TraceFixture : public ::testing::Test
+	{
+		// Inheritable interface.
+	protected:
+		void SetUp() override
+		{
+			TraceRecorder::Clear();
+		}
+
+		void TearDown() override
+		{
+			TraceRecorder::Clear();
+			std::filesystem::remove(tracePath);
+		}
+
+		// Export zones and read the file back.
+		std::string ExportTrace() const
+		{
+			EXPECT_TRUE(TraceRecorder::ExportChromeTrace(tracePath));
+
+			std::ifstream stream{ tracePath };
+			std::stringstream content;
+			content << stream.rdbuf();
+			return content.str();
+		}
+
+		// Inheritable state.
+	protected:
+		std::filesystem::path tracePath = std::filesystem::temp_directory_path() / "VesselTraceTest.json";
+	};
+
+	TEST_F(TraceFixture, ChromeTraceTest)
+	{
+		TraceRecorder::Record("Tick", 1000u, 5000u);
+		TraceRecorder::Record("Say \"hi\"", 2000u, 2500u);
+		EXPECT_EQ(TraceRecorder::GetZoneCount(), 2u);
+
+		// Timestamps are microseconds from the earliest zone, names are escaped.
+		const std::string trace = ExportTrace();
+		EXPECT_NE(trace.find("\"traceEvents\":["), std::string::npos);
+		EXPECT_NE(trace.find("{\"name\":\"Tick\",\"ph\":\"X\",\"pid\":1,"), std::string::npos);
+		EXPECT_NE(trace.find("\"ts\":0.000,\"dur\":4.000}"), std::string::npos);
+		EXPECT_NE(trace.find("{\"name\":\"Say \\\"hi\\\"\""), std::string::npos);
+		EXPECT_NE(trace.find("\"ts\":1.000,\"dur\":0.500}"), std::string::npos);
+	}
+
+	TEST_F(TraceFixture, RingOverwriteTest)
+	{
+		// Oldest zones are overwritten, so the timeline starts at the first kept one.
+		for (uint64_t index = 0u; index < TraceRecorder::kRingSize + 10u; ++index)
+		{
+			TraceRecorder::Record("Zone", index * 10u, index * 10u + 5u);
+		}
+		EXPECT_EQ(TraceRecorder::GetZoneCount(), TraceRecorder::kRingSize);
+
+		const std::string trace = ExportTrace();
+		EXPECT_NE(trace.find("\"ts\":0.000,"), std::string::npos);
+		EXPECT_EQ(trace.find("\"ts\":-"), std::string::npos);
+	}
+
+	TEST_F(TraceFixture, ThreadRingTest)
+	{
+		TraceRecorder::Record("Main", 1000u, 2000u);
+
+		// Zones of a finished thread are kept in its own ring.
+		std::thread worker([]() {
+			TraceRecorder::Record("Worker", 1500u, 1800u);
+			});
+		worker.join();
+
+		EXPECT_EQ(TraceRecorder::GetZoneCount(), 2u);
+
+		const std::string trace = ExportTrace();
+		const size_t mainIndex = trace.find("\"Main\"");
+		const size_t workerIndex = trace.find("\"Worker\"");
+		ASSERT_NE(mainIndex, std::string::npos);
+		ASSERT_NE(workerIndex, std::string::npos);
+
+		const auto getThreadId = [&trace](size_t index) {
+			const size_t begin = trace.find("\"tid\":", index) + 6u;
+			return trace.substr(begin, trace.find(',', begin) - begin);
+			};
+		EXPECT_NE(getThreadId(mainIndex), getThreadId(workerIndex));
+	}
+
+	TEST_F(TraceFixture, ScopedZoneTest)
+	{
+		{
+			const ::Vessel::ScopedTraceZone zone{ "Scoped" };
+		}
+
+		// Zones are only recorded in builds with VESSEL_TRACE, otherwise they are empty.
+		EXPECT_EQ(TraceRecorder::GetZoneCount(), ::Vessel::kTraceEnabled ? 1u : 0u);
+		EXPECT_TRUE(std::is_empty_v<::Vessel::NoTraceZone>);
+	}
+} // namespace
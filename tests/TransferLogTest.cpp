@@ -0,0 +1,125 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <array>
+
+#include <Stackable/Package.h>
+#include <Stackable/Container.h>
+
+namespace {
+	struct LogTestTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Steel,
+			Wood,
+			Count,
+		};
+
+		static constexpr bool LogTransfers = true;
+	};
+
+	using LogResourceModel = ::Vessel::ResourceModel<LogTestTag>;
+	using ResourceId = LogResourceModel::ResourceId;
+	using Units = LogResourceModel::Units;
+	using Package = ::Vessel::Package<LogResourceModel>;
+	using Container = ::Vessel::Container<LogResourceModel>;
+	using TransferLog = ::Vessel::TransferLog<LogResourceModel>;
+	using TransferReplay = ::Vessel::TransferReplay<LogResourceModel>;
+
+	constexpr Units kCapacityAmountKg = 500.f;
+
+	static const Package::ResourceTable kContainerCapacities
+	{
+		{ ResourceId::Steel, kCapacityAmountKg },
+		{ ResourceId::Wood, kCapacityAmountKg },
+	};
+
+	class TransferLogFixture : public ::testing::Test
+	{
+		// Inheritable interface.
+	protected:
+		void SetUp() override
+		{
+			for (uint32_t index = 0u; index < packages.size(); ++index)
+			{
+				packages[index].SetLogId(index);
+				snapshot[index].SetLogId(index);
+			}
+		}
+
+		void TearDown() override
+		{
+			std::filesystem::remove(logPath);
+		}
+
+		// Inheritable state.
+	protected:
+		std::array<Package, 3u> packages{ Package{ kContainerCapacities }, Package{ kContainerCapacities }, Package{ kContainerCapacities } };
+		std::array<Package, 3u> snapshot{ Package{ kContainerCapacities }, Package{ kContainerCapacities }, Package{ kContainerCapacities } };
+		std::array<Package*, 3u> packagePointers{ &packages[0], &packages[1], &packages[2] };
+		std::array<Package*, 3u> snapshotPointers{ &snapshot[0], &snapshot[1], &snapshot[2] };
+		std::filesystem::path logPath = std::filesystem::temp_directory_path() / "VesselTransferLogTest.bin";
+	};
+
+	TEST_F(TransferLogFixture, RecordAndReplayTest) {
+		ASSERT_TRUE(TransferLog::Open(logPath));
+
+		packages[0] << Container{ ResourceId::Steel, 300.f } << Container{ ResourceId::Wood, 120.f };
+		packages[0] >> packages[1];
+		packages[1] << Container{ ResourceId::Steel, 400.f };
+		packages[1] >> packages[2];
+
+		TransferLog::Close(TransferLog::Checksum(packagePointers));
+
+		std::optional<TransferReplay::Result> result = TransferReplay::Replay(logPath, snapshotPointers);
+		ASSERT_TRUE(result.has_value());
+		EXPECT_EQ(result->appliedRecords, 7u);
+		EXPECT_EQ(result->skippedRecords, 0u);
+		EXPECT_TRUE(result->expectedChecksum.has_value());
+		EXPECT_TRUE(result->IsDeterministic());
+
+		for (size_t index = 0u; index < packages.size(); ++index)
+		{
+			EXPECT_FLOAT_EQ(snapshot[index].GetAvailableUnits(ResourceId::Steel), packages[index].GetAvailableUnits(ResourceId::Steel));
+			EXPECT_FLOAT_EQ(snapshot[index].GetAvailableUnits(ResourceId::Wood), packages[index].GetAvailableUnits(ResourceId::Wood));
+		}
+	}
+
+	TEST_F(TransferLogFixture, DivergenceTest) {
+		ASSERT_TRUE(TransferLog::Open(logPath));
+		packages[0] << Container{ ResourceId::Steel, 300.f };
+		TransferLog::Close(TransferLog::Checksum(packagePointers));
+
+		// Restored snapshot differs from the recorded one.
+		snapshot[1] << Container{ ResourceId::Wood, 10.f };
+
+		std::optional<TransferReplay::Result> result = TransferReplay::Replay(logPath, snapshotPointers);
+		ASSERT_TRUE(result.has_value());
+		EXPECT_FALSE(result->IsDeterministic());
+	}
+
+	TEST_F(TransferLogFixture, UntrackedTest) {
+		Package untracked{ kContainerCapacities };
+		Package untrackedSink{ kContainerCapacities };
+
+		ASSERT_TRUE(TransferLog::Open(logPath));
+		untracked << Container{ ResourceId::Steel, 300.f };
+		untracked >> packages[0];
+		packages[0] >> untrackedSink;
+		untracked << Container{ ResourceId::Wood, 50.f };
+		untracked >> packages[1];
+		TransferLog::Close(TransferLog::Checksum(packagePointers));
+
+		// Fill of the untracked package isn't recorded, transfers with one tracked side are.
+		std::optional<TransferReplay::Result> result = TransferReplay::Replay(logPath, snapshotPointers);
+		ASSERT_TRUE(result.has_value());
+		EXPECT_EQ(result->appliedRecords, 3u);
+		EXPECT_EQ(result->skippedRecords, 0u);
+		EXPECT_TRUE(result->IsDeterministic());
+		EXPECT_FLOAT_EQ(snapshot[0].GetAvailableUnits(ResourceId::Steel), 0.f);
+		EXPECT_FLOAT_EQ(snapshot[1].GetAvailableUnits(ResourceId::Wood), 50.f);
+	}
+} // namespace
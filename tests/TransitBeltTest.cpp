@@ -0,0 +1,181 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include <Polymorphic/Queue.h>
+#include <Polymorphic/SupplyChain.h>
+#include <Polymorphic/TimingWheel.h>
+#include <Polymorphic/TransitBelt.h>
+
+namespace
+{
+	constexpr size_t kCapacityCount = 4u;
+	constexpr size_t kTravelTicks = 3u;
+
+	struct Parcel
+	{
+		int weight = 1;
+	};
+
+	using Exchanger = ::Vessel::Exchanger<Parcel>;
+	using TransitClock = ::Vessel::TransitClock<Parcel>;
+	using TransitBelt = ::Vessel::TransitBelt<Parcel>;
+
+	TEST(TransitBeltTest, TimingWheelTest)
+	{
+		// Two levels span 4096 ticks, later events wait in the overflow bucket.
+		::Vessel::TimingWheel<uint64_t, 2u> wheel;
+		const std::vector<uint64_t> ticks = { 1u, 5u, 63u, 64u, 65u, 130u, 4095u, 4096u, 4097u, 9000u, 9000u };
+		for (auto it = ticks.rbegin(); it != ticks.rend(); ++it)
+		{
+			wheel.Schedule(*it, *it);
+		}
+		EXPECT_EQ(wheel.GetEventCount(), ticks.size());
+
+		std::vector<uint64_t> fired;
+		while (wheel.GetTick() < 10000u)
+		{
+			wheel.Advance([&](uint64_t tick) {
+				EXPECT_EQ(tick, wheel.GetTick());
+				fired.push_back(tick);
+				});
+		}
+
+		EXPECT_EQ(fired, ticks);
+		EXPECT_EQ(wheel.GetEventCount(), 0u);
+
+		// Passed ticks fire on the next advance.
+		wheel.Schedule(10u, 0u);
+		size_t firedCount = 0u;
+		wheel.Advance([&](uint64_t) { ++firedCount; });
+		EXPECT_EQ(firedCount, 1u);
+	}
+
+	TEST(TransitBeltTest, TravelTest)
+	{
+		Parcel parcels[kCapacityCount];
+		TransitClock clock;
+		TransitBelt belt{ clock, kCapacityCount, kTravelTicks };
+
+		EXPECT_FALSE(Exchanger::PushItem(belt, parcels[0]).has_value());
+		EXPECT_FALSE(Exchanger::PushItem(belt, parcels[1]).has_value());
+		EXPECT_EQ(clock.GetArrivalCount(), 1u);
+
+		// Items in transit take slots, but can't be pulled yet.
+		EXPECT_EQ(belt.GetItemCount(), 2u);
+		EXPECT_EQ(belt.GetArrivedCount(), 0u);
+		EXPECT_FALSE(Exchanger::PullItem(belt).has_value());
+
+		EXPECT_EQ(clock.Tick(), 0u);
+		EXPECT_FALSE(Exchanger::PushItem(belt, parcels[2]).has_value());
+		EXPECT_EQ(clock.Tick(), 0u);
+
+		std::vector<TransitBelt*> arrivedBelts;
+		EXPECT_EQ(clock.Tick([&](TransitBelt& arrivedBelt) { arrivedBelts.push_back(&arrivedBelt); }), 2u);
+		EXPECT_EQ(arrivedBelts, std::vector<TransitBelt*>{ &belt });
+		EXPECT_EQ(belt.GetArrivedCount(), 2u);
+
+		EXPECT_EQ(&Exchanger::PullItem(belt).value().get(), &parcels[0]);
+		EXPECT_EQ(&Exchanger::PullItem(belt).value().get(), &parcels[1]);
+		EXPECT_FALSE(Exchanger::PullItem(belt).has_value());
+
+		EXPECT_EQ(clock.Tick(), 1u);
+		EXPECT_EQ(&Exchanger::PullItem(belt).value().get(), &parcels[2]);
+		EXPECT_EQ(belt.GetItemCount(), 0u);
+		EXPECT_EQ(clock.GetArrivalCount(), 0u);
+	}
+
+	TEST(TransitBeltTest, CapacityTest)
+	{
+		Parcel parcel;
+		TransitClock clock;
+		TransitBelt belt{ clock, kCapacityCount, kTravelTicks };
+
+		for (size_t index = 0u; index < kCapacityCount; ++index)
+		{
+			EXPECT_FALSE(belt.ExchangeReceiverSlot(parcel).has_value());
+		}
+
+		EXPECT_TRUE(Exchanger::PushItem(belt, parcel).has_value());
+		EXPECT_FALSE(belt.FindEmptySlot().has_value());
+
+		// Arrived item pushed back to the feeder end goes in front of the rest.
+		for (size_t tick = 0u; tick < kTravelTicks; ++tick)
+		{
+			clock.Tick();
+		}
+
+		Parcel other;
+		EXPECT_EQ(&belt.ExchangeFeederSlot(other).value().get(), &parcel);
+		EXPECT_EQ(&belt.ExchangeFeederSlot().value().get(), &other);
+		EXPECT_FALSE(belt.ExchangeFeederSlot(other).has_value());
+		EXPECT_EQ(belt.GetArrivedCount(), kCapacityCount);
+
+		// Loaded items are arrived at once.
+		belt.SetSlotItems({ {}, parcel, {}, other });
+		EXPECT_EQ(belt.GetItemCount(), 2u);
+		EXPECT_EQ(belt.GetArrivedCount(), 2u);
+		EXPECT_EQ(&Exchanger::PullItem(belt).value().get(), &parcel);
+	}
+
+	TEST(TransitBeltTest, ExchangeTest)
+	{
+		Parcel parcels[kCapacityCount];
+		TransitClock clock;
+		TransitBelt belt{ clock, kCapacityCount, kTravelTicks };
+		belt.SetSlotItems({ parcels[0] });
+		EXPECT_FALSE(belt.ExchangeReceiverSlot(parcels[1]).has_value());
+
+		// Free slot between items can't be reached, so nothing is pulled for it.
+		::Vessel::Queue<Parcel> holeQueue{ kCapacityCount };
+		holeQueue.SetSlotItems({ parcels[2], {}, parcels[3], parcels[2] });
+		EXPECT_EQ(holeQueue.GetReceivableCount(), 0u);
+		EXPECT_EQ(Exchanger::ExchangeN(holeQueue, belt, kCapacityCount), 0u);
+		EXPECT_EQ(belt.GetArrivedCount(), 1u);
+		EXPECT_EQ(belt.GetItemCount(), 2u);
+
+		// Free slot in front of items is dropped, so it takes the arrived item, the one in transit stays.
+		::Vessel::Queue<Parcel> frontQueue{ kCapacityCount };
+		frontQueue.SetSlotItems({ {}, parcels[2], parcels[3], parcels[2] });
+		EXPECT_EQ(frontQueue.GetReceivableCount(), 1u);
+		EXPECT_EQ(Exchanger::ExchangeN(frontQueue, belt, kCapacityCount), 1u);
+		EXPECT_EQ(frontQueue.GetItemCount(), kCapacityCount);
+		EXPECT_EQ(belt.GetArrivedCount(), 0u);
+		EXPECT_EQ(belt.GetItemCount(), 1u);
+	}
+
+	TEST(TransitBeltTest, SupplyChainTest)
+	{
+		std::vector<Parcel> parcels(kCapacityCount);
+		::Vessel::Queue<Parcel> source{ kCapacityCount };
+		::Vessel::Queue<Parcel> sink{ kCapacityCount };
+		for (const Parcel& parcel : parcels)
+		{
+			source.ExchangeReceiverSlot(parcel);
+		}
+
+		TransitClock clock;
+		TransitBelt belt{ clock, kCapacityCount, kTravelTicks };
+
+		::Vessel::SupplyChain<Parcel> chain;
+		const size_t sourceId = chain.AddBelt(source);
+		const size_t beltId = chain.AddBelt(belt);
+		const size_t sinkId = chain.AddBelt(sink);
+		chain.Link(sourceId, beltId, 2u);
+		chain.Link(beltId, sinkId, kCapacityCount);
+
+		// Clock delivers items before links move them.
+		std::vector<size_t> sinkCounts;
+		for (size_t tick = 0u; tick < kTravelTicks + 3u; ++tick)
+		{
+			clock.Tick();
+			chain.Tick();
+			sinkCounts.push_back(sink.GetItemCount());
+		}
+
+		EXPECT_EQ(sinkCounts, (std::vector<size_t>{ 0u, 0u, 0u, 2u, 4u, 4u }));
+		EXPECT_EQ(&Exchanger::PullItem(sink).value().get(), &parcels[0]);
+		EXPECT_EQ(belt.GetItemCount(), 0u);
+	}
+} // namespace
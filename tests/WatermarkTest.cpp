@@ -0,0 +1,143 @@
+// (c) 2024 Acid7Beast. Use with wisdom.
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <Stackable/Package.h>
+#include <Stackable/Container.h>
+
+namespace {
+	struct WatchTestTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Steel,
+			Wood,
+			Count,
+		};
+
+		static constexpr bool WatchWatermarks = true;
+	};
+
+	struct PlainTestTag
+	{
+		using Units = float;
+
+		enum class ResourceId : uint8_t
+		{
+			Steel,
+			Wood,
+			Count,
+		};
+	};
+
+	using WatchResourceModel = ::Vessel::ResourceModel<WatchTestTag>;
+	using ResourceId = WatchResourceModel::ResourceId;
+	using Units = WatchResourceModel::Units;
+	using Package = ::Vessel::Package<WatchResourceModel>;
+	using Container = ::Vessel::Container<WatchResourceModel>;
+
+	constexpr Units kCapacityAmountKg = 500.f;
+	constexpr Units kLowWatermarkKg = 100.f;
+	constexpr Units kHighWatermarkKg = 400.f;
+
+	static const Package::ResourceTable kContainerCapacities
+	{
+		{ ResourceId::Steel, kCapacityAmountKg },
+		{ ResourceId::Wood, kCapacityAmountKg },
+	};
+
+	class WatermarkFixture : public ::testing::Test
+	{
+		// Inheritable interface.
+	protected:
+		void SetUp() override
+		{
+			package.AddLowWatermark(ResourceId::Steel, kLowWatermarkKg, [this](ResourceId, Units amount) {
+				lowAmounts.push_back(amount);
+				});
+			package.AddHighWatermark(ResourceId::Steel, kHighWatermarkKg, [this](ResourceId, Units amount) {
+				highAmounts.push_back(amount);
+				});
+		}
+
+		// Inheritable state.
+	protected:
+		Package package{ kContainerCapacities };
+		Package otherPackage{ kContainerCapacities };
+		std::vector<Units> lowAmounts;
+		std::vector<Units> highAmounts;
+	};
+
+	TEST_F(WatermarkFixture, HighCrossingTest) {
+		// Stay below the high watermark.
+		package << Container{ ResourceId::Steel, 300.f };
+		EXPECT_TRUE(highAmounts.empty());
+
+		// Cross the high watermark once.
+		package << Container{ ResourceId::Steel, 150.f };
+		ASSERT_EQ(highAmounts.size(), 1u);
+		EXPECT_FLOAT_EQ(highAmounts.front(), 450.f);
+
+		// Stay above the high watermark.
+		package << Container{ ResourceId::Steel, 150.f };
+		EXPECT_EQ(highAmounts.size(), 1u);
+		EXPECT_TRUE(lowAmounts.empty());
+	}
+
+	TEST_F(WatermarkFixture, LowCrossingTest) {
+		package << Container{ ResourceId::Steel, kCapacityAmountKg };
+		highAmounts.clear();
+
+		// Drain the package above the low watermark.
+		otherPackage.LoadState({ { ResourceId::Steel, 150.f } });
+		package >> otherPackage;
+		EXPECT_TRUE(lowAmounts.empty());
+
+		// Drain the package below the low watermark.
+		Package sinkPackage{ kContainerCapacities };
+		package >> sinkPackage;
+		ASSERT_EQ(lowAmounts.size(), 1u);
+		EXPECT_FLOAT_EQ(lowAmounts.front(), 0.f);
+		EXPECT_TRUE(highAmounts.empty());
+	}
+
+	TEST_F(WatermarkFixture, UnwatchedResourceTest) {
+		package << Container{ ResourceId::Wood, kCapacityAmountKg };
+		EXPECT_TRUE(lowAmounts.empty());
+		EXPECT_TRUE(highAmounts.empty());
+	}
+
+	TEST_F(WatermarkFixture, RemoveTest) {
+		package.RemoveWatermarks(ResourceId::Steel);
+		package << Container{ ResourceId::Steel, kCapacityAmountKg };
+		EXPECT_TRUE(highAmounts.empty());
+	}
+
+	TEST_F(WatermarkFixture, ReentrantCallbackTest) {
+		// One-shot watcher removes every watcher of the package and registers another one from inside the callback.
+		size_t refillCount = 0u;
+		package.AddHighWatermark(ResourceId::Steel, kLowWatermarkKg, [this, &refillCount](ResourceId resourceId, Units) {
+			++refillCount;
+			package.RemoveWatermarks(resourceId);
+			package.AddHighWatermark(resourceId, kCapacityAmountKg - 1.f, [&refillCount](ResourceId, Units) {
+				++refillCount;
+				});
+			});
+
+		// Watchers crossed by the same change still fire once.
+		package << Container{ ResourceId::Steel, 450.f };
+		EXPECT_EQ(refillCount, 1u);
+		EXPECT_EQ(highAmounts.size(), 1u);
+
+		package << Container{ ResourceId::Steel, kCapacityAmountKg };
+		EXPECT_EQ(refillCount, 2u);
+		EXPECT_EQ(highAmounts.size(), 1u);
+	}
+
+	TEST(WatermarkLayoutTest, DisabledWatermarksTest) {
+		// Packages of models which didn't opt-in don't pay for the watermarks pointer.
+		EXPECT_LT(sizeof(::Vessel::Package<::Vessel::ResourceModel<PlainTestTag>>), sizeof(Package));
+	}
+} // namespace